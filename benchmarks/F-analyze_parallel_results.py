@@ -197,6 +197,43 @@ def create_scalability_plot(df_par, df_seq):
     print("✅ Saved: scalability_analysis.png")
     plt.close()
 
+def create_phase_breakdown(data):
+    """Stacked wall-time phases per configuration, one panel per dataset"""
+    PHASES = ['read', 'tokenize', 'count', 'merge', 'topk', 'output']
+    rows = [r for r in data['sequential_baseline'] + data['parallel_results'] if r.get('phases')]
+    if not rows:
+        print("⚠️  No phase timing in these results; skipping phase_breakdown.png")
+        return
+    
+    datasets = sorted({r['dataset'] for r in rows})
+    fig, axes = plt.subplots(len(datasets), 1, figsize=(16, 5 * len(datasets)), squeeze=False)
+    fig.suptitle('Wall Time by Phase (stacked)', fontsize=16, fontweight='bold')
+    colors = sns.color_palette('Set2', len(PHASES))
+    
+    for ax, dataset in zip(axes[:, 0], datasets):
+        configs = sorted([r for r in rows if r['dataset'] == dataset],
+                         key=lambda r: (r['sync_method'] != 'sequential', r['sync_method'], r['threads']))
+        labels = ['seq' if r['sync_method'] == 'sequential' else f"{r['threads']}t {r['sync_method']}"
+                  for r in configs]
+        x = np.arange(len(configs))
+        bottom = np.zeros(len(configs))
+        for phase, color in zip(PHASES, colors):
+            values = np.array([r['phases'].get(phase, {}).get('wall_ms', 0.0) for r in configs])
+            ax.bar(x, values, bottom=bottom, color=color, label=phase, edgecolor='black', linewidth=0.5)
+            bottom += values
+        
+        ax.set_xticks(x)
+        ax.set_xticklabels(labels, rotation=45, ha='right')
+        ax.set_ylabel('Wall Time (ms)', fontweight='bold')
+        ax.set_title(f'{Path(dataset).stem}', fontweight='bold')
+        ax.legend(ncol=len(PHASES), frameon=True, shadow=True)
+        ax.grid(True, alpha=0.3, axis='y')
+    
+    plt.tight_layout()
+    plt.savefig('benchmarks/results/phase_breakdown.png', dpi=300, bbox_inches='tight')
+    print("✅ Saved: phase_breakdown.png")
+    plt.close()
+
 def generate_performance_table(df_par, df_seq):
     """Generate LaTeX-formatted performance table"""
     output = []
@@ -294,6 +331,7 @@ def main():
     create_efficiency_plots(df_par)
     create_sync_comparison(df_par)
     create_scalability_plot(df_par, df_seq)
+    create_phase_breakdown(data)
     
     # Generate LaTeX table
     print("\n📝 Generating LaTeX table...")
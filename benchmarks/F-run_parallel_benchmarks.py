@@ -30,10 +30,46 @@ RUNS_PER_CONFIG = 5
 SEQUENTIAL_EXE = "build/sequential_counter.exe"
 PARALLEL_EXE = "build/parallel_counter.exe"
 
+# --exe <path> benchmarks another parallel build, e.g. the OpenMP-free one
+# (PG_NO_OPENMP=1), so runtimes can be compared on identical sweeps.
+if "--exe" in sys.argv and sys.argv.index("--exe") + 1 < len(sys.argv):
+    PARALLEL_EXE = sys.argv[sys.argv.index("--exe") + 1]
+
+# In-process mode: time the engine through the parallel_grepper extension
+# (pip install .) instead of spawning the executable, so timings exclude
+# process startup and stdout scraping.
+INPROCESS = "--inprocess" in sys.argv
+
 # Output
 RESULTS_DIR = "benchmarks/results"
 TIMESTAMP = datetime.now().strftime("%Y%m%d_%H%M%S")
 
+# Both executables write per-phase wall/CPU time here (--phases); the
+# analyzer turns the per-config means into stacked phase charts.
+PHASES_FILE = f"results/phases_{os.getpid()}.json"
+
+
+def read_phases(runs):
+    """Read the phase file of the last run into runs (a list of phase dicts)"""
+    try:
+        with open(PHASES_FILE) as f:
+            runs.append(json.load(f)["phases"])
+    except (OSError, ValueError, KeyError):
+        pass
+
+
+def mean_phases(runs):
+    """Mean wall/CPU ms per phase over runs, e.g. {"count": {"wall_ms": .., "cpu_ms": ..}}"""
+    if not runs:
+        return {}
+    return {
+        name: {
+            "wall_ms": statistics.mean(r[name]["wall_ms"] for r in runs),
+            "cpu_ms": statistics.mean(r[name]["cpu_ms"] for r in runs),
+        }
+        for name in runs[0]
+    }
+
 
 def run_sequential_benchmark(dataset):
     """Run sequential version and get baseline timing"""
@@ -43,11 +79,12 @@ def run_sequential_benchmark(dataset):
     
     times = []
     total_words = 0
+    phase_runs = []
     
     for run in range(RUNS_PER_CONFIG):
         start = time.perf_counter()
         result = subprocess.run(
-            [SEQUENTIAL_EXE, dataset],
+            [SEQUENTIAL_EXE, dataset, "--phases", PHASES_FILE],
             capture_output=True,
             text=True
         )
@@ -57,12 +94,14 @@ def run_sequential_benchmark(dataset):
             print(f"  ❌ Run {run+1} failed!")
             continue
             
-        # Extract total words from output
+        # Extract total words (and, in-process mode, the engine-reported time) from output
         for line in result.stdout.split('\n'):
             if "Total Words:" in line:
                 total_words = int(line.split(':')[1].strip())
-                break
+            elif INPROCESS and "Execution Time:" in line:
+                elapsed = float(line.split(':')[1].split()[0]) / 1000
         
+        read_phases(phase_runs)
         times.append(elapsed * 1000)  # Convert to ms
         print(f"  Run {run+1}/{RUNS_PER_CONFIG}: {elapsed*1000:.2f} ms")
     
@@ -70,6 +109,7 @@ def run_sequential_benchmark(dataset):
         "dataset": dataset,
         "threads": 1,
         "sync_method": "sequential",
+        "phases": mean_phases(phase_runs),
         "times": times,
         "mean_time": statistics.mean(times),
         "std_dev": statistics.stdev(times) if len(times) > 1 else 0,
@@ -87,36 +127,50 @@ def run_parallel_benchmark(dataset, threads, sync_method):
     
     times = []
     total_words = 0
+    phase_runs = []
     
     output_file = f"results/parallel/bench_{Path(dataset).stem}_{threads}t_{sync_method}.txt"
     
-    for run in range(RUNS_PER_CONFIG):
-        start = time.perf_counter()
-        result = subprocess.run(
-            [PARALLEL_EXE, dataset, output_file, "100", str(threads), sync_method],
-            capture_output=True,
-            text=True
-        )
-        elapsed = time.perf_counter() - start
+    if INPROCESS:
+        import parallel_grepper
+        counter = parallel_grepper.Counter(sync=sync_method, threads=threads)
+        for run in range(RUNS_PER_CONFIG):
+            result = counter.count_file(dataset, top_n=100)
+            total_words = result.total_words
+            times.append(result.execution_time_ms)
+            print(f"  Run {run+1}/{RUNS_PER_CONFIG}: {result.execution_time_ms:.2f} ms")
+    else:
+        for run in range(RUNS_PER_CONFIG):
+            start = time.perf_counter()
+            result = subprocess.run(
+                # --profile none: a saved autotune profile must not change the swept configuration
+                [PARALLEL_EXE, dataset, output_file, "100", str(threads), sync_method, "--profile", "none",
+                 "--phases", PHASES_FILE],
+                capture_output=True,
+                text=True
+            )
+            elapsed = time.perf_counter() - start
         
-        if result.returncode != 0:
-            print(f"  ❌ Run {run+1} failed!")
-            print(f"  Error: {result.stderr}")
-            continue
+            if result.returncode != 0:
+                print(f"  ❌ Run {run+1} failed!")
+                print(f"  Error: {result.stderr}")
+                continue
         
-        # Extract total words from output
-        for line in result.stdout.split('\n'):
-            if "Total Words:" in line:
-                total_words = int(line.split(':')[1].strip())
-                break
+            # Extract total words from output
+            for line in result.stdout.split('\n'):
+                if "Total Words:" in line:
+                    total_words = int(line.split(':')[1].strip())
+                    break
         
-        times.append(elapsed * 1000)  # Convert to ms
-        print(f"  Run {run+1}/{RUNS_PER_CONFIG}: {elapsed*1000:.2f} ms")
+            read_phases(phase_runs)
+            times.append(elapsed * 1000)  # Convert to ms
+            print(f"  Run {run+1}/{RUNS_PER_CONFIG}: {elapsed*1000:.2f} ms")
     
     return {
         "dataset": dataset,
         "threads": threads,
         "sync_method": sync_method,
+        "phases": mean_phases(phase_runs),
         "times": times,
         "mean_time": statistics.mean(times) if times else 0,
         "std_dev": statistics.stdev(times) if len(times) > 1 else 0,
@@ -160,6 +214,7 @@ def save_results(results, seq_baseline):
     with open(json_file, 'w') as f:
         json.dump({
             "sequential_baseline": seq_baseline,
+            "parallel_executable": PARALLEL_EXE,
             "parallel_results": results,
             "timestamp": TIMESTAMP
         }, f, indent=2)
@@ -213,6 +268,9 @@ def main():
     print(f"Thread counts: {THREAD_COUNTS}")
     print(f"Sync methods: {SYNC_METHODS}")
     print(f"Runs per config: {RUNS_PER_CONFIG}")
+    print(f"Mode: {'in-process (parallel_grepper)' if INPROCESS else 'subprocess'}")
+    if not INPROCESS:
+        print(f"Parallel executable: {PARALLEL_EXE}")
     print(f"Total benchmarks: {len(DATASETS) * (1 + len(THREAD_COUNTS) * len(SYNC_METHODS)) * RUNS_PER_CONFIG}")
     
     # Check executables exist
@@ -221,7 +279,7 @@ def main():
         print("   Run build script first!")
         return 1
     
-    if not os.path.exists(PARALLEL_EXE):
+    if not INPROCESS and not os.path.exists(PARALLEL_EXE):
         print(f"\n❌ Parallel executable not found: {PARALLEL_EXE}")
         print("   Run build script first!")
         return 1
@@ -12,15 +12,51 @@ New-Item -ItemType Directory -Force -Path results\parallel | Out-Null
 
 # Compile
 Write-Host "Compiling..." -ForegroundColor Yellow
-g++ -std=c++17 -O3 -o build/sequential_counter.exe `
+g++ -std=c++17 -O3 -Isrc/common -o build/sequential_counter.exe `
+    src/common/phase_timer.cpp `
+    src/common/perf_counters.cpp `
+    src/common/trace_recorder.cpp `
+    src/common/memory_report.cpp `
+    src/common/counting_allocator.cpp `
     src/sequential/word_counter_sequential.cpp `
     src/sequential/main.cpp
 
+# Threading runtime: OpenMP by default; $env:PG_NO_OPENMP = "1" builds the std::thread backend
+if ($env:PG_NO_OPENMP -eq "1") {
+    $Runtime = "std::thread"
+    $ThreadFlags = @("-DPG_NO_OPENMP", "-pthread")
+} else {
+    $Runtime = "OpenMP"
+    $ThreadFlags = @("-fopenmp")
+}
+
 Write-Host "\nBuilding Parallel Word Counter" -ForegroundColor Cyan
 Write-Host "================================" -ForegroundColor Cyan
-Write-Host "Compiling parallel (OpenMP)..." -ForegroundColor Yellow
-g++ -std=c++17 -O3 -fopenmp -o build/parallel_counter.exe `
+Write-Host "Compiling parallel ($Runtime)..." -ForegroundColor Yellow
+g++ -std=c++20 -O3 -Isrc/common @ThreadFlags -o build/parallel_counter.exe `
+    src/common/phase_timer.cpp `
+    src/common/perf_counters.cpp `
+    src/common/trace_recorder.cpp `
+    src/common/memory_report.cpp `
+    src/common/counting_allocator.cpp `
     src/parallel/word_counter_parallel.cpp `
+    src/parallel/windowed_counter.cpp `
+    src/parallel/corpus_analyzer.cpp `
+    src/parallel/coro_executor.cpp `
+    src/parallel/cooccurrence_counter.cpp `
+    src/parallel/literal_grep.cpp `
+    src/parallel/multi_pattern.cpp `
+    src/parallel/regex_grep.cpp `
+    src/parallel/positional_index.cpp `
+    src/parallel/line_index.cpp `
+    src/parallel/block_summary.cpp `
+    src/parallel/fuzzy_vocabulary.cpp `
+    src/parallel/file_reader.cpp `
+    src/parallel/work_stealing_executor.cpp `
+    src/parallel/pipeline_counter.cpp `
+    src/parallel/word_filter.cpp `
+    src/parallel/topology.cpp `
+    src/parallel/autotuner.cpp `
     src/parallel/main.cpp
 
 if ($LASTEXITCODE -eq 0) {
@@ -31,6 +67,28 @@ if ($LASTEXITCODE -eq 0) {
     Write-Host "Parallel build failed!" -ForegroundColor Red
 }
 
+Write-Host "\nBuilding Shared Library (C API)" -ForegroundColor Cyan
+Write-Host "================================" -ForegroundColor Cyan
+g++ -std=c++20 -O3 -Isrc/common @ThreadFlags -shared -DPG_BUILD_SHARED -o build/parallel_counter.dll `
+    src/common/phase_timer.cpp `
+    src/common/perf_counters.cpp `
+    src/common/trace_recorder.cpp `
+    src/common/memory_report.cpp `
+    src/parallel/word_counter_parallel.cpp `
+    src/parallel/work_stealing_executor.cpp `
+    src/parallel/pipeline_counter.cpp `
+    src/parallel/word_filter.cpp `
+    src/parallel/topology.cpp `
+    src/parallel/file_reader.cpp `
+    src/parallel/word_counter_c_api.cpp
+
+if ($LASTEXITCODE -eq 0) {
+    Write-Host "Shared library build successful!" -ForegroundColor Green
+    Write-Host "Library: build\parallel_counter.dll (header: src\parallel\word_counter_c_api.h)" -ForegroundColor Green
+} else {
+    Write-Host "Shared library build failed!" -ForegroundColor Red
+}
+
 if ($LASTEXITCODE -eq 0) {
     Write-Host "Build successful!" -ForegroundColor Green
     Write-Host "Executable: build\sequential_counter.exe" -ForegroundColor Green
@@ -14,8 +14,13 @@ mkdir -p results/parallel
 
 # Compile with optimizations
 echo "Compiling..."
-g++ -std=c++17 -O3 -march=native \
+g++ -std=c++17 -O3 -march=native -Isrc/common \
     -o build/sequential_counter \
+    src/common/phase_timer.cpp \
+    src/common/perf_counters.cpp \
+    src/common/trace_recorder.cpp \
+    src/common/memory_report.cpp \
+    src/common/counting_allocator.cpp \
     src/sequential/word_counter_sequential.cpp \
     src/sequential/main.cpp
 
@@ -29,13 +34,53 @@ else
     exit 1
 fi
 
+# Threading runtime: OpenMP by default; PG_NO_OPENMP=1 builds the std::thread
+# backend (plus std::execution::par when libtbb is available).
+if [ "${PG_NO_OPENMP:-0}" = "1" ]; then
+    RUNTIME="std::thread"
+    THREAD_FLAGS="-DPG_NO_OPENMP -pthread"
+    THREAD_LIBS=""
+    if printf '#include <algorithm>\n#include <execution>\n#include <vector>\nint main() { std::vector<int> v(8); std::sort(std::execution::par, v.begin(), v.end()); }\n' \
+        | g++ -std=c++17 -x c++ - -o /dev/null -ltbb 2>/dev/null; then
+        THREAD_FLAGS="$THREAD_FLAGS -DPG_HAVE_PSTL"
+        THREAD_LIBS="-ltbb"
+    fi
+else
+    RUNTIME="OpenMP"
+    THREAD_FLAGS="-fopenmp"
+    THREAD_LIBS=""
+fi
+
 echo "\nBuilding Parallel Word Counter"
 echo "================================"
-echo "Compiling parallel (OpenMP)..."
-g++ -std=c++17 -O3 -march=native -fopenmp \
+echo "Compiling parallel ($RUNTIME)..."
+g++ -std=c++20 -O3 -march=native -Isrc/common $THREAD_FLAGS \
     -o build/parallel_counter \
+    src/common/phase_timer.cpp \
+    src/common/perf_counters.cpp \
+    src/common/trace_recorder.cpp \
+    src/common/memory_report.cpp \
+    src/common/counting_allocator.cpp \
     src/parallel/word_counter_parallel.cpp \
-    src/parallel/main.cpp
+    src/parallel/windowed_counter.cpp \
+    src/parallel/corpus_analyzer.cpp \
+    src/parallel/coro_executor.cpp \
+    src/parallel/cooccurrence_counter.cpp \
+    src/parallel/literal_grep.cpp \
+    src/parallel/multi_pattern.cpp \
+    src/parallel/regex_grep.cpp \
+    src/parallel/positional_index.cpp \
+    src/parallel/line_index.cpp \
+    src/parallel/block_summary.cpp \
+    src/parallel/fuzzy_vocabulary.cpp \
+    src/parallel/file_reader.cpp \
+    src/parallel/work_stealing_executor.cpp \
+    src/parallel/pipeline_counter.cpp \
+    src/parallel/word_filter.cpp \
+    src/parallel/topology.cpp \
+    src/parallel/autotuner.cpp \
+    src/parallel/main.cpp \
+    $THREAD_LIBS
 
 if [ $? -eq 0 ]; then
     echo "Parallel build successful!"
@@ -45,3 +90,29 @@ else
     echo "Parallel build failed!"
     exit 1
 fi
+
+echo "\nBuilding Shared Library (C API)"
+echo "================================"
+g++ -std=c++20 -O3 -march=native -Isrc/common $THREAD_FLAGS -fPIC -shared \
+    -o build/libparallel_counter.so \
+    src/common/phase_timer.cpp \
+    src/common/perf_counters.cpp \
+    src/common/trace_recorder.cpp \
+    src/common/memory_report.cpp \
+    src/parallel/word_counter_parallel.cpp \
+    src/parallel/work_stealing_executor.cpp \
+    src/parallel/pipeline_counter.cpp \
+    src/parallel/word_filter.cpp \
+    src/parallel/topology.cpp \
+    src/parallel/file_reader.cpp \
+    src/parallel/word_counter_c_api.cpp \
+    $THREAD_LIBS
+
+if [ $? -eq 0 ]; then
+    echo "Shared library build successful!"
+    echo "Library: build/libparallel_counter.so (header: src/parallel/word_counter_c_api.h)"
+    echo "Python bindings: pip install ."
+else
+    echo "Shared library build failed!"
+    exit 1
+fi
@@ -0,0 +1,115 @@
+#!/bin/bash
+
+# Regression tests: run the built executables on small crafted inputs and
+# check their output.
+# Usage: ./scripts/run_regression_tests.sh   (after ./scripts/build.sh)
+
+TMP_DIR=$(mktemp -d)
+trap 'rm -rf "$TMP_DIR"' EXIT
+FAILED=0
+
+pass() { echo "  PASS: $1"; }
+fail() { echo "  FAIL: $1"; FAILED=1; }
+
+echo "================================"
+echo "Running Regression Tests"
+echo "================================"
+
+if [ ! -x build/parallel_counter ]; then
+    echo "build/parallel_counter not found; run ./scripts/build.sh first"
+    exit 1
+fi
+
+# A line that merely starts with a number is not an epoch timestamp: it keeps
+# the previous line's time instead of opening a window at "404".
+echo "Windowed mode: line starting with a number"
+cat > "$TMP_DIR/window.log" <<'LOG'
+1700000000 alpha beta
+1700000001 alpha
+404 not found
+1700000002 gamma alpha
+LOG
+./build/parallel_counter "$TMP_DIR/window.log" "$TMP_DIR/window.txt" 5 2 --window 60 --buckets 6 > /dev/null
+if [ "$(grep -c '^Window' "$TMP_DIR/window.txt")" = "1" ] &&
+   grep -q '^Window 1699999950 1700000010 total=7$' "$TMP_DIR/window.txt"; then
+    pass "single window, 404 line counted under the last timestamp"
+else
+    fail "unexpected windows:"
+    cat "$TMP_DIR/window.txt"
+fi
+
+# A header line before the first timestamp is counted under that timestamp;
+# it must not open a bucket at the wall clock that swallows the whole log.
+echo "Windowed mode: header line before the first timestamp"
+{
+    echo "log started"
+    for i in $(seq 0 20); do echo "$((1700000000 + i * 10)) alpha"; done
+} > "$TMP_DIR/header.log"
+./build/parallel_counter "$TMP_DIR/header.log" "$TMP_DIR/header.txt" 5 2 --window 60 --buckets 6 > /dev/null
+FIRST_WINDOW=$(grep '^Window' "$TMP_DIR/header.txt" | head -1)
+if [ "$(grep -c '^Window' "$TMP_DIR/header.txt")" -gt 1 ] &&
+   [ "$FIRST_WINDOW" = "Window 1699999950 1700000010 total=3" ]; then
+    pass "header counted in the first window, later lines in their own windows"
+else
+    fail "unexpected windows:"
+    grep '^Window' "$TMP_DIR/header.txt"
+fi
+
+# POSIX bracket classes match like grep -E; an unknown name is rejected
+# instead of being read as the set "[:alph" followed by a literal "]".
+echo "Regex mode: POSIX bracket classes"
+printf 'abc 123\n456\nxyz\n' > "$TMP_DIR/regex.txt"
+./build/parallel_counter "$TMP_DIR/regex.txt" "$TMP_DIR/regex.out" 10 2 --regex '^[[:alpha:]]+ [[:digit:]]+$' > /dev/null
+if [ "$(cat "$TMP_DIR/regex.out")" = "1:abc 123" ]; then
+    pass "[[:alpha:]] and [[:digit:]] match"
+else
+    fail "unexpected matches:"
+    cat "$TMP_DIR/regex.out"
+fi
+if ./build/parallel_counter "$TMP_DIR/regex.txt" "$TMP_DIR/regex.out" 10 2 --regex '[[:alphabet:]]' > /dev/null 2> "$TMP_DIR/regex.err"; then
+    fail "unknown class [:alphabet:] was accepted"
+elif grep -q 'unsupported character class \[:alphabet:\]' "$TMP_DIR/regex.err"; then
+    pass "unknown class rejected"
+else
+    fail "unexpected error:"
+    cat "$TMP_DIR/regex.err"
+fi
+
+# Engine names are checked, not silently mapped to auto.
+echo "Pattern mode: engine names"
+printf 'alpha\nbeta\n' > "$TMP_DIR/patterns.txt"
+printf 'alpha beta alpha\n' > "$TMP_DIR/patterns_in.txt"
+./build/parallel_counter "$TMP_DIR/patterns_in.txt" "$TMP_DIR/patterns.out" 10 2 --patterns "$TMP_DIR/patterns.txt" --pattern-engine aho-corasick > /dev/null
+if grep -q '^Engine: aho-corasick$' "$TMP_DIR/patterns.out"; then
+    pass "aho-corasick selects the Aho-Corasick engine"
+else
+    fail "aho-corasick not honoured:"
+    head -3 "$TMP_DIR/patterns.out"
+fi
+if ./build/parallel_counter "$TMP_DIR/patterns_in.txt" "$TMP_DIR/patterns.out" 10 2 --patterns "$TMP_DIR/patterns.txt" --pattern-engine hyperscan > /dev/null 2>&1; then
+    fail "unknown engine hyperscan was accepted"
+else
+    pass "unknown engine rejected"
+fi
+
+# Malformed numbers are usage errors, not uncaught exceptions.
+echo "Options: malformed numbers"
+for args in "10 2 --grain abc" "ten" "10 2 --tune-sample 1e6 --autotune"; do
+    # shellcheck disable=SC2086
+    ./build/parallel_counter "$TMP_DIR/patterns_in.txt" "$TMP_DIR/numbers.out" $args > /dev/null 2> "$TMP_DIR/numbers.err"
+    status=$?
+    if [ $status -eq 1 ] && grep -q '^Error: .*needs a non-negative integer' "$TMP_DIR/numbers.err"; then
+        pass "rejected: $args"
+    else
+        fail "exit $status for: $args"
+        cat "$TMP_DIR/numbers.err"
+    fi
+done
+
+echo ""
+if [ $FAILED -eq 0 ]; then
+    echo "All regression tests passed."
+else
+    echo "Some regression tests failed."
+fi
+exit $FAILED
@@ -0,0 +1,37 @@
+"""
+Build the in-process Python bindings for the parallel word counter.
+
+    pip install .
+    python -c "import parallel_grepper; print(parallel_grepper.Counter().count('a b a').to_dict())"
+"""
+
+from setuptools import Extension, setup
+
+parallel_grepper = Extension(
+    "parallel_grepper",
+    sources=[
+        "src/python/parallel_grepper_module.cpp",
+        "src/parallel/word_counter_c_api.cpp",
+        "src/parallel/word_counter_parallel.cpp",
+        "src/parallel/work_stealing_executor.cpp",
+        "src/parallel/pipeline_counter.cpp",
+        "src/parallel/word_filter.cpp",
+        "src/parallel/topology.cpp",
+        "src/parallel/file_reader.cpp",
+        "src/common/phase_timer.cpp",
+        "src/common/perf_counters.cpp",
+        "src/common/trace_recorder.cpp",
+        "src/common/memory_report.cpp",
+    ],
+    include_dirs=["src/common"],
+    language="c++",
+    extra_compile_args=["-std=c++20", "-O3", "-fopenmp"],
+    extra_link_args=["-fopenmp"],
+)
+
+setup(
+    name="parallel_grepper",
+    version="0.1.0",
+    description="In-process bindings for the OpenMP word frequency counter",
+    ext_modules=[parallel_grepper],
+)
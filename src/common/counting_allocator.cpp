@@ -0,0 +1,114 @@
+// Replacement global operator new/delete that feed MemoryReport's heap
+// counters. Linked into the executables only; see memory_report.h.
+
+#include "memory_report.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#define PG_USABLE_SIZE(p) _msize(p)
+#define PG_ALIGNED_USABLE_SIZE(p, align) _aligned_msize(p, align, 0)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define PG_USABLE_SIZE(p) malloc_size(p)
+#define PG_ALIGNED_USABLE_SIZE(p, align) ((void)(align), malloc_size(p))
+#else
+#include <malloc.h>
+#define PG_USABLE_SIZE(p) malloc_usable_size(p)
+#define PG_ALIGNED_USABLE_SIZE(p, align) ((void)(align), malloc_usable_size(p))
+#endif
+
+namespace {
+
+[[maybe_unused]] const bool linked = (MemoryReport::noteLinked(), true);
+
+void* countedAlloc(std::size_t size) {
+    void* p = std::malloc(size > 0 ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    // Usable-size lookups are not free; skip them unless --memory is on.
+    if (MemoryReport::isCounting()) MemoryReport::noteAllocation(PG_USABLE_SIZE(p));
+    return p;
+}
+
+void countedFree(void* p) noexcept {
+    if (p == nullptr) return;
+    if (MemoryReport::isCounting()) MemoryReport::noteFree(PG_USABLE_SIZE(p));
+    std::free(p);
+}
+
+// Over-aligned types (alignas(64) rings and queues) come through here.
+void* countedAlignedAlloc(std::size_t size, std::align_val_t align) {
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    if (size == 0) size = 1;
+#if defined(_WIN32)
+    void* p = _aligned_malloc(size, alignment);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) != 0) p = nullptr;
+#endif
+    if (p == nullptr) throw std::bad_alloc();
+    if (MemoryReport::isCounting()) MemoryReport::noteAllocation(PG_ALIGNED_USABLE_SIZE(p, alignment));
+    return p;
+}
+
+void countedAlignedFree(void* p, std::align_val_t align) noexcept {
+    if (p == nullptr) return;
+    if (MemoryReport::isCounting()) MemoryReport::noteFree(PG_ALIGNED_USABLE_SIZE(p, static_cast<std::size_t>(align)));
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+
+void* operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlignedAlloc(size, align);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlignedAlloc(size, align);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void* p, std::align_val_t align) noexcept { countedAlignedFree(p, align); }
+void operator delete[](void* p, std::align_val_t align) noexcept { countedAlignedFree(p, align); }
+void operator delete(void* p, std::size_t, std::align_val_t align) noexcept { countedAlignedFree(p, align); }
+void operator delete[](void* p, std::size_t, std::align_val_t align) noexcept { countedAlignedFree(p, align); }
+void operator delete(void* p, std::align_val_t align, const std::nothrow_t&) noexcept { countedAlignedFree(p, align); }
+void operator delete[](void* p, std::align_val_t align, const std::nothrow_t&) noexcept {
+    countedAlignedFree(p, align);
+}
@@ -0,0 +1,131 @@
+#include "memory_report.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef PSAPI_VERSION
+#define PSAPI_VERSION 2  // K32GetProcessMemoryInfo from kernel32, no psapi.lib
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+const size_t MemoryReport::kSmallStringCapacity = std::string().capacity();
+
+void MemoryReport::startCounting() {
+    counting.store(true, std::memory_order_relaxed);
+}
+
+MemoryReport::Heap MemoryReport::heap() {
+    Heap h;
+    h.allocations = allocations.load(std::memory_order_relaxed);
+    h.frees = frees.load(std::memory_order_relaxed);
+    h.allocatedBytes = allocatedBytes.load(std::memory_order_relaxed);
+    h.liveBytes = liveBytes.load(std::memory_order_relaxed);
+    h.peakLiveBytes = peakLiveBytes.load(std::memory_order_relaxed);
+    return h;
+}
+
+size_t MemoryReport::peakRssBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);  // bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;  // KiB on Linux
+#endif
+#endif
+}
+
+size_t MemoryReport::currentRssBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize;
+#else
+    // statm: size resident shared ... in pages
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void MemoryReport::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    tables.clear();
+}
+
+void MemoryReport::addTable(PhaseTimer::Phase phase, const char* name, size_t entries, size_t bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = std::find_if(tables.begin(), tables.end(),
+                           [&](const Table& t) { return t.phase == phase && t.name == name; });
+    if (it == tables.end()) {
+        tables.push_back(Table{phase, name});
+        it = tables.end() - 1;
+    }
+    ++it->instances;
+    it->entries += entries;
+    it->bytes += bytes;
+    it->maxBytes = std::max(it->maxBytes, bytes);
+}
+
+std::vector<MemoryReport::Table> MemoryReport::getTables() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return tables;
+}
+
+void MemoryReport::print(std::ostream& out, size_t inputBytes, size_t uniqueWords, const char* finalTable) const {
+    auto mb = [](double bytes) { return bytes / (1024.0 * 1024.0); };
+    auto perInput = [&](double bytes) { return inputBytes > 0 ? bytes / static_cast<double>(inputBytes) : 0.0; };
+
+    out << "\nMemory:\n";
+    out << "-------------------------------------------\n";
+    out << std::fixed << std::setprecision(2);
+    const size_t peakRss = peakRssBytes();
+    out << "Peak RSS:          " << mb(static_cast<double>(peakRss)) << " MB (" << perInput(static_cast<double>(peakRss))
+        << " bytes per input byte)\n";
+    if (countingLinked()) {
+        const Heap h = heap();
+        out << "Allocations:       " << h.allocations << " (" << mb(static_cast<double>(h.allocatedBytes))
+            << " MB), frees: " << h.frees << "\n";
+        out << "Peak heap:         " << mb(static_cast<double>(h.peakLiveBytes)) << " MB ("
+            << perInput(static_cast<double>(h.peakLiveBytes)) << " bytes per input byte), live at end: at least "
+            << mb(static_cast<double>(h.liveBytes)) << " MB\n";
+    } else {
+        out << "Allocations:       not counted (allocator hook not linked)\n";
+    }
+
+    const std::vector<Table> rows = getTables();
+    if (rows.empty()) return;
+    out << "\n" << std::left << std::setw(12) << "Table" << std::setw(10) << "Phase" << std::right << std::setw(6)
+        << "Count" << std::setw(12) << "Entries" << std::setw(10) << "MB" << std::setw(10) << "Max MB"
+        << std::setw(12) << "Bytes/entry" << "\n";
+    size_t finalBytes = 0;
+    for (const Table& t : rows) {
+        out << std::left << std::setw(12) << t.name << std::setw(10) << PhaseTimer::name(t.phase) << std::right
+            << std::setw(6) << t.instances << std::setw(12) << t.entries << std::setw(10)
+            << mb(static_cast<double>(t.bytes)) << std::setw(10) << mb(static_cast<double>(t.maxBytes))
+            << std::setw(12)
+            << (t.entries > 0 ? static_cast<double>(t.bytes) / static_cast<double>(t.entries) : 0.0) << "\n";
+        if (t.name == finalTable) finalBytes = t.bytes;
+    }
+    if (uniqueWords > 0 && finalBytes > 0) {
+        out << "Bytes per unique word (" << finalTable << "): "
+            << static_cast<double>(finalBytes) / static_cast<double>(uniqueWords) << "\n";
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include "phase_timer.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Memory used by a word count: peak RSS, heap allocations, and the
+ *        footprint of each table, noted at the end of the phase that built it.
+ *
+ * Allocations are counted by the replacement operator new/delete in
+ * counting_allocator.cpp, which only the executables link (the shared
+ * library leaves the host's allocator alone). Counting is off until
+ * startCounting(), and then costs a few relaxed atomic adds per allocation.
+ * Heap bytes are the allocator's usable sizes, so they include its rounding.
+ * The executables start counting before the counter is built and the input
+ * read. Freeing a block allocated before that still subtracts its size, so
+ * live bytes are a lower bound. In practice those few blocks (arguments,
+ * the CPU plan) outlive the report.
+ *
+ * Table footprints are estimates from the containers' shapes: buckets,
+ * nodes (value plus next pointer and cached hash), and the heap part of each
+ * string that does not fit the small-string buffer. Walking a table costs a
+ * pass over it, so counters only note tables when the report is enabled.
+ */
+class MemoryReport {
+public:
+    struct Heap {
+        unsigned long long allocations = 0;
+        unsigned long long frees = 0;
+        unsigned long long allocatedBytes = 0;  // cumulative
+        long long liveBytes = 0;                // allocated - freed since startCounting(); a lower bound
+        long long peakLiveBytes = 0;
+    };
+
+    /** @brief One table as noted: `instances` > 1 when every thread has its own. */
+    struct Table {
+        PhaseTimer::Phase phase;
+        std::string name;
+        size_t instances = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t maxBytes = 0;  // largest single instance
+    };
+
+    /** @brief Count heap allocations from now on (if the hook is linked). */
+    static void startCounting();
+    static bool countingLinked() { return hookLinked.load(std::memory_order_relaxed); }
+    /** @brief Whether startCounting() has run; the hook skips all work until then. */
+    static bool isCounting() { return counting.load(std::memory_order_relaxed); }
+    static Heap heap();
+    /** @brief Peak / current resident set size of the process, 0 if unknown. */
+    static size_t peakRssBytes();
+    static size_t currentRssBytes();
+
+    // Called by counting_allocator.cpp, only while isCounting().
+    static void noteLinked() { hookLinked.store(true, std::memory_order_relaxed); }
+    static void noteAllocation(size_t bytes) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        long long live = liveBytes.fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed) +
+                         static_cast<long long>(bytes);
+        long long peak = peakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+    static void noteFree(size_t bytes) {
+        frees.fetch_add(1, std::memory_order_relaxed);
+        liveBytes.fetch_sub(static_cast<long long>(bytes), std::memory_order_relaxed);
+    }
+
+    /** @brief Heap bytes of a string beyond its own object (0 if it fits the small-string buffer). */
+    static size_t stringBytes(const std::string& s) {
+        return s.capacity() > kSmallStringCapacity ? s.capacity() + 1 : 0;
+    }
+    static size_t bytesOf(const std::vector<std::string>& v) {
+        size_t bytes = v.capacity() * sizeof(std::string);
+        for (const auto& s : v) bytes += stringBytes(s);
+        return bytes;
+    }
+    template <class Value>
+    static size_t bytesOf(const std::unordered_map<std::string, Value>& m) {
+        using Node = typename std::unordered_map<std::string, Value>::value_type;
+        size_t bytes = m.bucket_count() * sizeof(void*) + m.size() * (sizeof(Node) + 2 * sizeof(void*));
+        for (const auto& entry : m) bytes += stringBytes(entry.first);
+        return bytes;
+    }
+
+    void setEnabled(bool on) { enabled = on; }
+    bool isEnabled() const { return enabled; }
+    void clear();
+    /**
+     * @brief Note a table built in `phase`; repeated names in the same phase
+     *        (one per thread) are summed. Safe from concurrent threads.
+     */
+    void addTable(PhaseTimer::Phase phase, const char* name, size_t entries, size_t bytes);
+    std::vector<Table> getTables() const;
+
+    /**
+     * @brief "Memory" block: peak RSS and heap per input byte, allocations,
+     *        one row per table, and bytes per unique word of `finalTable`.
+     */
+    void print(std::ostream& out, size_t inputBytes, size_t uniqueWords, const char* finalTable) const;
+
+private:
+    static const size_t kSmallStringCapacity;
+    static inline std::atomic<bool> hookLinked{false};
+    static inline std::atomic<bool> counting{false};
+    static inline std::atomic<unsigned long long> allocations{0};
+    static inline std::atomic<unsigned long long> frees{0};
+    static inline std::atomic<unsigned long long> allocatedBytes{0};
+    static inline std::atomic<long long> liveBytes{0};
+    static inline std::atomic<long long> peakLiveBytes{0};
+
+    bool enabled = false;
+    mutable std::mutex lock;
+    std::vector<Table> tables;
+};
+
+#endif // MEMORY_REPORT_H
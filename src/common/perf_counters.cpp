@@ -0,0 +1,183 @@
+#include "perf_counters.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<bool> anyOpened{false};
+std::mutex reasonLock;
+std::string firstFailure;
+
+void noteFailure(const std::string& reason) {
+    std::lock_guard<std::mutex> guard(reasonLock);
+    if (firstFailure.empty()) firstFailure = reason;
+}
+
+#if defined(__linux__)
+
+struct EventSpec {
+    PerfCounters::Event event;
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+constexpr std::uint64_t cacheMiss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// Two groups of three: small enough to be co-scheduled on any PMU with four
+// programmable counters, and cycles/instructions always measured together.
+constexpr int kGroups = 2;
+constexpr int kGroupSize = 3;
+const EventSpec kSpecs[kGroups][kGroupSize] = {
+    {{PerfCounters::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+     {PerfCounters::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+     {PerfCounters::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}},
+    {{PerfCounters::L1dMisses, PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D)},
+     {PerfCounters::LlcMisses, PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL)},
+     {PerfCounters::DtlbMisses, PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB)}},
+};
+
+std::string paranoidLevel() {
+    std::ifstream in("/proc/sys/kernel/perf_event_paranoid");
+    std::string level;
+    return (in >> level) ? level : "unknown";
+}
+
+/**
+ * @brief The calling thread's counter groups; closed when the thread exits.
+ */
+class ThreadGroups {
+public:
+    ThreadGroups() {
+        for (int g = 0; g < kGroups; ++g) open(g);
+    }
+    ~ThreadGroups() {
+        for (int g = 0; g < kGroups; ++g) {
+            for (int i = 0; i < members[g]; ++i) close(fds[g][i]);
+        }
+    }
+    ThreadGroups(const ThreadGroups&) = delete;
+    ThreadGroups& operator=(const ThreadGroups&) = delete;
+
+    PerfCounters::Values read() const {
+        PerfCounters::Values values;
+        for (int g = 0; g < kGroups; ++g) {
+            if (members[g] == 0) continue;
+            // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, value[nr]
+            std::uint64_t buffer[3 + kGroupSize] = {};
+            if (::read(fds[g][0], buffer, sizeof(buffer)) < static_cast<ssize_t>((3 + members[g]) * sizeof(std::uint64_t))) {
+                continue;
+            }
+            const std::uint64_t enabled = buffer[1];
+            const std::uint64_t running = buffer[2];
+            if (running == 0) continue;  // never got on the PMU
+            for (int i = 0; i < members[g]; ++i) {
+                std::uint64_t count = buffer[3 + i];
+                if (running < enabled) {
+                    count = static_cast<std::uint64_t>(static_cast<double>(count) * static_cast<double>(enabled) /
+                                                       static_cast<double>(running));
+                }
+                values.counts[events[g][i]] = count;
+                values.mask |= 1u << events[g][i];
+            }
+        }
+        return values;
+    }
+
+private:
+    int fds[kGroups][kGroupSize] = {};
+    PerfCounters::Event events[kGroups][kGroupSize] = {};
+    int members[kGroups] = {};
+
+    void open(int g) {
+        for (const EventSpec& spec : kSpecs[g]) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = spec.type;
+            attr.config = spec.config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const bool leader = members[g] == 0;
+            attr.disabled = leader ? 1 : 0;
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader ? -1 : fds[g][0], 0));
+            if (fd < 0) {
+                noteFailure(std::string("perf_event_open: ") + std::strerror(errno) +
+                            " (perf_event_paranoid=" + paranoidLevel() + ")");
+                continue;  // this event is missing; the rest of the group still counts
+            }
+            fds[g][members[g]] = fd;
+            events[g][members[g]] = spec.event;
+            ++members[g];
+        }
+        if (members[g] > 0) {
+            ioctl(fds[g][0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[g][0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            anyOpened = true;
+        }
+    }
+};
+
+#endif
+
+} // namespace
+
+PerfCounters::Values& PerfCounters::Values::operator+=(const Values& other) {
+    for (int e = 0; e < kEvents; ++e) counts[e] += other.counts[e];
+    mask |= other.mask;
+    return *this;
+}
+
+PerfCounters::Values PerfCounters::Values::since(const Values& start) const {
+    Values delta;
+    delta.mask = mask & start.mask;
+    for (int e = 0; e < kEvents; ++e) {
+        // Multiplex scaling can make a later estimate slightly smaller.
+        delta.counts[e] = counts[e] > start.counts[e] ? counts[e] - start.counts[e] : 0;
+    }
+    return delta;
+}
+
+const char* PerfCounters::name(Event event) {
+    switch (event) {
+        case Cycles: return "cycles";
+        case Instructions: return "instructions";
+        case BranchMisses: return "branch_misses";
+        case L1dMisses: return "l1d_misses";
+        case LlcMisses: return "llc_misses";
+        case DtlbMisses: return "dtlb_misses";
+    }
+    return "unknown";
+}
+
+PerfCounters::Values PerfCounters::readThread() {
+#if defined(__linux__)
+    thread_local ThreadGroups groups;
+    return groups.read();
+#else
+    noteFailure("hardware counters need Linux perf_event_open");
+    return Values();
+#endif
+}
+
+bool PerfCounters::available() {
+    return anyOpened;
+}
+
+std::string PerfCounters::unavailableReason() {
+    std::lock_guard<std::mutex> guard(reasonLock);
+    return firstFailure.empty() ? "no counters were opened" : firstFailure;
+}
@@ -0,0 +1,48 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Per-thread hardware performance counters through perf_event_open
+ *        (Linux), read at phase boundaries.
+ *
+ * Each thread lazily opens two counter groups on its first read: {cycles,
+ * instructions, branch misses} and {L1D read misses, LLC read misses, dTLB
+ * read misses}. Members of a group are scheduled together, so ratios inside
+ * a group (IPC) are exact; a group the PMU had to multiplex is scaled by
+ * time enabled / time running. Counting is user space only, which is what
+ * perf_event_paranoid <= 2 allows an unprivileged process to measure about
+ * itself.
+ *
+ * Events the kernel or CPU does not offer (no PMU in a VM, paranoid 3,
+ * non-Linux builds) are simply missing from Values::mask; nothing fails.
+ */
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, BranchMisses, L1dMisses, LlcMisses, DtlbMisses };
+    static constexpr int kEvents = 6;
+
+    struct Values {
+        std::uint64_t counts[kEvents] = {};
+        unsigned mask = 0;  // bit e set: counts[e] was measured
+
+        bool has(Event e) const { return (mask >> e) & 1u; }
+        Values& operator+=(const Values& other);
+        /** @brief Counts accumulated since `start` (saturating at 0). */
+        Values since(const Values& start) const;
+    };
+
+    static const char* name(Event event);
+
+    /** @brief Counters of the calling thread so far (opened on its first call). */
+    static Values readThread();
+
+    /** @brief Whether any event opened on some thread so far. */
+    static bool available();
+    /** @brief Why no event could be opened, e.g. "perf_event_open: No such file or directory (perf_event_paranoid=2)". */
+    static std::string unavailableReason();
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,256 @@
+#include "phase_timer.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace {
+
+#if defined(_WIN32)
+double fileTimesMs(const FILETIME& kernel, const FILETIME& user) {
+    auto ticks = [](const FILETIME& t) {
+        return (static_cast<unsigned long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+    };
+    return static_cast<double>(ticks(kernel) + ticks(user)) / 1e4;  // 100 ns ticks
+}
+#else
+double clockMs(clockid_t clock) {
+    timespec ts{};
+    clock_gettime(clock, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+}
+#endif
+
+} // namespace
+
+const char* PhaseTimer::name(Phase phase) {
+    switch (phase) {
+        case Read: return "read";
+        case Tokenize: return "tokenize";
+        case Count: return "count";
+        case Merge: return "merge";
+        case TopK: return "topk";
+        case Output: return "output";
+    }
+    return "unknown";
+}
+
+double PhaseTimer::processCpuMs() {
+#if defined(_WIN32)
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0.0;
+    return fileTimesMs(kernel, user);
+#else
+    return clockMs(CLOCK_PROCESS_CPUTIME_ID);
+#endif
+}
+
+double PhaseTimer::threadCpuMs() {
+#if defined(_WIN32)
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) return 0.0;
+    return fileTimesMs(kernel, user);
+#else
+    return clockMs(CLOCK_THREAD_CPUTIME_ID);
+#endif
+}
+
+void PhaseTimer::clear(size_t threadCount) {
+    for (int p = 0; p < kPhases; ++p) {
+        totals[p] = Sample();
+        threads[p].assign(threadCount, Sample());
+    }
+}
+
+void PhaseTimer::reserveThreads(size_t threadCount) {
+    for (auto& perThread : threads) {
+        if (perThread.size() < threadCount) perThread.resize(threadCount);
+    }
+}
+
+void PhaseTimer::add(Phase phase, double wallMs, double cpuMs, const PerfCounters::Values& counters) {
+    totals[phase].wallMs += wallMs;
+    totals[phase].cpuMs += cpuMs;
+    totals[phase].counters += counters;
+}
+
+void PhaseTimer::addThread(Phase phase, size_t thread, double wallMs, double cpuMs,
+                           const PerfCounters::Values& counters) {
+    if (thread >= threads[phase].size()) return;
+    threads[phase][thread].wallMs += wallMs;
+    threads[phase][thread].cpuMs += cpuMs;
+    threads[phase][thread].counters += counters;
+}
+
+PerfCounters::Values PhaseTimer::getCounters(Phase phase) const {
+    PerfCounters::Values sum;
+    for (const auto& sample : threads[phase]) sum += sample.counters;
+    return sum.mask != 0 ? sum : totals[phase].counters;
+}
+
+double PhaseTimer::getTotalWallMs() const {
+    double sum = 0.0;
+    for (const auto& total : totals) sum += total.wallMs;
+    return sum;
+}
+
+double PhaseTimer::getTotalCpuMs() const {
+    double sum = 0.0;
+    for (const auto& total : totals) sum += total.cpuMs;
+    return sum;
+}
+
+void PhaseTimer::print(std::ostream& out, unsigned long long words) const {
+    out << "\nPhase Timing:\n";
+    out << "-------------------------------------------\n";
+    out << std::left << std::setw(10) << "Phase" << std::right << std::setw(12) << "Wall ms" << std::setw(12)
+        << "CPU ms" << std::setw(9) << "Wall %" << "\n";
+    const double totalWall = getTotalWallMs();
+    out << std::fixed << std::setprecision(2);
+    for (int p = 0; p < kPhases; ++p) {
+        out << std::left << std::setw(10) << name(static_cast<Phase>(p)) << std::right << std::setw(12)
+            << totals[p].wallMs << std::setw(12) << totals[p].cpuMs << std::setw(9)
+            << (totalWall > 0.0 ? totals[p].wallMs * 100.0 / totalWall : 0.0) << "\n";
+    }
+    out << std::left << std::setw(10) << "total" << std::right << std::setw(12) << totalWall << std::setw(12)
+        << getTotalCpuMs() << "\n";
+
+    // Per-thread table: only the phases some thread reported.
+    std::vector<int> sampled;
+    size_t rows = 0;
+    for (int p = 0; p < kPhases; ++p) {
+        bool any = std::any_of(threads[p].begin(), threads[p].end(),
+                               [](const Sample& s) { return s.wallMs > 0.0 || s.cpuMs > 0.0; });
+        if (any) {
+            sampled.push_back(p);
+            rows = std::max(rows, threads[p].size());
+        }
+    }
+    if (!sampled.empty()) printThreads(out, sampled, rows);
+    printCounters(out, words);
+}
+
+void PhaseTimer::printThreads(std::ostream& out, const std::vector<int>& sampled, size_t rows) const {
+    out << "\nPer-Thread Phases (wall / CPU ms):\n";
+    out << "-------------------------------------------\n";
+    out << std::setw(6) << "Thread";
+    for (int p : sampled) out << std::setw(20) << name(static_cast<Phase>(p));
+    out << "\n";
+    for (size_t t = 0; t < rows; ++t) {
+        out << std::setw(6) << t;
+        for (int p : sampled) {
+            const Sample s = t < threads[p].size() ? threads[p][t] : Sample();
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(2) << s.wallMs << " / " << s.cpuMs;
+            out << std::setw(20) << cell.str();
+        }
+        out << "\n";
+    }
+}
+
+void PhaseTimer::printCounters(std::ostream& out, unsigned long long words) const {
+    if (!countersEnabled) return;
+    out << "\nHardware Counters:\n";
+    out << "-------------------------------------------\n";
+    if (!PerfCounters::available()) {
+        out << "unavailable (" << PerfCounters::unavailableReason() << ")\n";
+        return;
+    }
+    // Misses are per counted word, so runs of different sizes compare.
+    const PerfCounters::Event perWord[] = {PerfCounters::L1dMisses, PerfCounters::LlcMisses,
+                                           PerfCounters::DtlbMisses, PerfCounters::BranchMisses};
+    out << std::left << std::setw(10) << "Phase" << std::right << std::setw(11) << "M cycles" << std::setw(11)
+        << "M instr" << std::setw(7) << "IPC" << std::setw(10) << "L1D/word" << std::setw(10) << "LLC/word"
+        << std::setw(10) << "dTLB/word" << std::setw(10) << "Br/word" << "\n";
+    auto row = [&](const char* label, const PerfCounters::Values& c) {
+        out << std::left << std::setw(10) << label << std::right << std::fixed << std::setprecision(1);
+        auto count = [&](PerfCounters::Event e, int width) {
+            if (c.has(e)) {
+                out << std::setw(width) << static_cast<double>(c.counts[e]) / 1e6;
+            } else {
+                out << std::setw(width) << "n/a";
+            }
+        };
+        count(PerfCounters::Cycles, 11);
+        count(PerfCounters::Instructions, 11);
+        out << std::setprecision(2);
+        if (c.has(PerfCounters::Cycles) && c.has(PerfCounters::Instructions) && c.counts[PerfCounters::Cycles] > 0) {
+            out << std::setw(7)
+                << static_cast<double>(c.counts[PerfCounters::Instructions]) / static_cast<double>(c.counts[PerfCounters::Cycles]);
+        } else {
+            out << std::setw(7) << "n/a";
+        }
+        out << std::setprecision(3);
+        for (PerfCounters::Event e : perWord) {
+            if (c.has(e) && words > 0) {
+                out << std::setw(10) << static_cast<double>(c.counts[e]) / static_cast<double>(words);
+            } else {
+                out << std::setw(10) << "n/a";
+            }
+        }
+        out << "\n";
+    };
+    PerfCounters::Values total;
+    for (int p = 0; p < kPhases; ++p) {
+        PerfCounters::Values c = getCounters(static_cast<Phase>(p));
+        if (c.mask == 0) continue;
+        row(name(static_cast<Phase>(p)), c);
+        total += c;
+    }
+    row("total", total);
+}
+
+void PhaseTimer::writeJson(std::ostream& out, unsigned long long words) const {
+    auto counters = [&](const PerfCounters::Values& c) {
+        out << ", \"counters\": {";
+        bool first = true;
+        for (int e = 0; e < PerfCounters::kEvents; ++e) {
+            if (!c.has(static_cast<PerfCounters::Event>(e))) continue;
+            out << (first ? "" : ", ") << "\"" << PerfCounters::name(static_cast<PerfCounters::Event>(e))
+                << "\": " << c.counts[e];
+            first = false;
+        }
+        if (c.has(PerfCounters::Cycles) && c.has(PerfCounters::Instructions) && c.counts[PerfCounters::Cycles] > 0) {
+            out << ", \"ipc\": "
+                << static_cast<double>(c.counts[PerfCounters::Instructions]) / static_cast<double>(c.counts[PerfCounters::Cycles]);
+        }
+        out << "}";
+    };
+    auto sample = [&](const Sample& s) {
+        out << "{\"wall_ms\": " << s.wallMs << ", \"cpu_ms\": " << s.cpuMs;
+        if (s.counters.mask != 0) counters(s.counters);
+    };
+    out << std::fixed << std::setprecision(3);
+    out << "{\"phases\": {";
+    for (int p = 0; p < kPhases; ++p) {
+        out << (p > 0 ? ", " : "") << "\"" << name(static_cast<Phase>(p)) << "\": ";
+        Sample phaseTotal = totals[p];
+        phaseTotal.counters = getCounters(static_cast<Phase>(p));
+        sample(phaseTotal);
+        out << ", \"threads\": [";
+        for (size_t t = 0; t < threads[p].size(); ++t) {
+            out << (t > 0 ? ", " : "");
+            sample(threads[p][t]);
+            out << "}";
+        }
+        out << "]}";
+    }
+    out << "}, \"total_wall_ms\": " << getTotalWallMs() << ", \"total_cpu_ms\": " << getTotalCpuMs()
+        << ", \"words\": " << words;
+    if (countersEnabled) {
+        out << ", \"counters_available\": " << (PerfCounters::available() ? "true" : "false");
+        if (!PerfCounters::available()) {
+            out << ", \"counters_unavailable\": \"" << PerfCounters::unavailableReason() << "\"";
+        }
+    }
+    out << "}\n";
+}
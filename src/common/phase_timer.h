@@ -0,0 +1,162 @@
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include "perf_counters.h"
+#include "trace_recorder.h"
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Wall and CPU time per phase of a word count (read, tokenize, count,
+ *        merge, top-K, output), as a whole and per thread.
+ *
+ * Shared by the sequential and the parallel counter. Timing is taken at
+ * phase boundaries only (two clock reads per region or per thread and
+ * phase), never per word, so it stays on in every run.
+ *
+ * A phase total is what the run spent in that phase on its critical path:
+ * wall time is elapsed time, CPU time is the process CPU consumed meanwhile
+ * (every thread). Per-thread samples hold each thread's own wall time inside
+ * the phase and its thread CPU time; they are what shows load imbalance.
+ * Where one loop does several phases at once (e.g. the sequential counter
+ * reads, tokenizes and counts word by word) its time goes to the last of
+ * them.
+ *
+ * With setCounters(true) every scope also reads its thread's hardware
+ * counters (PerfCounters), so each sample carries the cycles, instructions
+ * and misses of the work it timed. While a TraceRecorder runs, every scope
+ * also becomes a span named after its phase.
+ */
+class PhaseTimer {
+public:
+    enum Phase { Read, Tokenize, Count, Merge, TopK, Output };
+    static constexpr int kPhases = 6;
+
+    struct Sample {
+        double wallMs = 0.0;
+        double cpuMs = 0.0;
+        PerfCounters::Values counters;
+    };
+
+    static const char* name(Phase phase);
+    /** @brief CPU time of the whole process / of the calling thread, in ms. */
+    static double processCpuMs();
+    static double threadCpuMs();
+
+    /** @brief Also read hardware counters in every scope from now on. */
+    void setCounters(bool enabled) { countersEnabled = enabled; }
+    bool getCountersEnabled() const { return countersEnabled; }
+
+    /** @brief Drop every sample; per-thread slots are sized for `threads`. */
+    void clear(size_t threads = 0);
+    /** @brief Make room for per-thread samples of threads [0, threads); never shrinks. */
+    void reserveThreads(size_t threads);
+
+    void add(Phase phase, double wallMs, double cpuMs, const PerfCounters::Values& counters = {});
+    /** @brief Safe from concurrent threads as long as each uses its own index (< reserved). */
+    void addThread(Phase phase, size_t thread, double wallMs, double cpuMs, const PerfCounters::Values& counters = {});
+
+    const Sample& get(Phase phase) const { return totals[phase]; }
+    /**
+     * @brief Hardware counters of a phase: the sum of its per-thread samples
+     *        if threads reported any, otherwise those of the thread that
+     *        timed the phase as a whole.
+     */
+    PerfCounters::Values getCounters(Phase phase) const;
+    const std::vector<Sample>& getThreads(Phase phase) const { return threads[phase]; }
+    double getTotalWallMs() const;
+    double getTotalCpuMs() const;
+
+    /**
+     * @brief "Phase Timing" table, a per-thread table when threads were
+     *        sampled, and with counters on a "Hardware Counters" table (IPC,
+     *        misses per word of `words`).
+     */
+    void print(std::ostream& out, unsigned long long words = 0) const;
+    /** @brief One JSON object: {"phases": {"read": {"wall_ms", "cpu_ms", "threads": [...]}, ...}, ...} */
+    void writeJson(std::ostream& out, unsigned long long words = 0) const;
+
+    /**
+     * @brief Times the enclosing block (or up to stop()) on the calling
+     *        thread as a phase total.
+     */
+    class Scope {
+    public:
+        Scope(PhaseTimer& timer, Phase phase)
+            : timer(timer), phase(phase), wallStart(Clock::now()), cpuStart(processCpuMs()) {
+            if (timer.countersEnabled) countersStart = PerfCounters::readThread();
+        }
+        ~Scope() { stop(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        void stop() {
+            if (stopped) return;
+            stopped = true;
+            PerfCounters::Values counters;
+            if (timer.countersEnabled) counters = PerfCounters::readThread().since(countersStart);
+            const Clock::time_point wallEnd = Clock::now();
+            timer.add(phase, std::chrono::duration<double, std::milli>(wallEnd - wallStart).count(),
+                      processCpuMs() - cpuStart, counters);
+            TraceRecorder::record(name(phase), "phase", wallStart, wallEnd);
+        }
+
+    private:
+        using Clock = TraceRecorder::Clock;
+        PhaseTimer& timer;
+        Phase phase;
+        Clock::time_point wallStart;
+        double cpuStart;
+        PerfCounters::Values countersStart;
+        bool stopped = false;
+    };
+
+    /** @brief Times the enclosing block (or up to stop()) as one thread's share of a phase. */
+    class ThreadScope {
+    public:
+        ThreadScope(PhaseTimer& timer, Phase phase, size_t thread)
+            : timer(timer), phase(phase), thread(thread), wallStart(Clock::now()), cpuStart(threadCpuMs()) {
+            if (timer.countersEnabled) countersStart = PerfCounters::readThread();
+        }
+        ~ThreadScope() { stop(); }
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope& operator=(const ThreadScope&) = delete;
+
+        void stop() {
+            if (stopped) return;
+            stopped = true;
+            PerfCounters::Values counters;
+            if (timer.countersEnabled) counters = PerfCounters::readThread().since(countersStart);
+            const Clock::time_point wallEnd = Clock::now();
+            timer.addThread(phase, thread, std::chrono::duration<double, std::milli>(wallEnd - wallStart).count(),
+                            threadCpuMs() - cpuStart, counters);
+            if (TraceRecorder::enabled()) {
+                TraceRecorder::nameThread("worker", static_cast<long long>(thread), false);
+                TraceRecorder::record(name(phase), "phase", wallStart, wallEnd, static_cast<long long>(thread));
+            }
+        }
+
+    private:
+        using Clock = TraceRecorder::Clock;
+        PhaseTimer& timer;
+        Phase phase;
+        size_t thread;
+        Clock::time_point wallStart;
+        double cpuStart;
+        PerfCounters::Values countersStart;
+        bool stopped = false;
+    };
+
+private:
+    void printThreads(std::ostream& out, const std::vector<int>& sampled, size_t rows) const;
+    void printCounters(std::ostream& out, unsigned long long words) const;
+
+    Sample totals[kPhases];
+    std::vector<Sample> threads[kPhases];
+    bool countersEnabled = false;
+};
+
+#endif // PHASE_TIMER_H
@@ -0,0 +1,104 @@
+#include "trace_recorder.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* name;
+    const char* category;
+    TraceRecorder::Clock::time_point begin;
+    TraceRecorder::Clock::time_point end;
+    long long arg;
+};
+
+struct ThreadBuffer {
+    int tid = 0;
+    std::string name;
+    std::vector<Event> events;
+};
+
+std::mutex registryLock;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+TraceRecorder::Clock::time_point origin;
+const char* process = "";
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        auto owned = std::make_unique<ThreadBuffer>();
+        owned->events.reserve(1024);
+        std::lock_guard<std::mutex> guard(registryLock);
+        owned->tid = static_cast<int>(registry.size());
+        buffer = owned.get();
+        registry.push_back(std::move(owned));
+    }
+    return *buffer;
+}
+
+double microseconds(TraceRecorder::Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+} // namespace
+
+void TraceRecorder::start(const char* processName) {
+    process = processName;
+    origin = Clock::now();
+    active.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::nameThread(const char* role, long long index, bool replace) {
+    if (!enabled()) return;
+    ThreadBuffer& buffer = threadBuffer();
+    if (!replace && !buffer.name.empty()) return;
+    buffer.name = role;
+    if (index >= 0) buffer.name += " " + std::to_string(index);
+}
+
+void TraceRecorder::record(const char* name, const char* category, Clock::time_point begin, Clock::time_point end,
+                           long long arg) {
+    if (!enabled()) return;
+    threadBuffer().events.push_back({name, category, begin, end, arg});
+}
+
+size_t TraceRecorder::spanCount() {
+    std::lock_guard<std::mutex> guard(registryLock);
+    size_t count = 0;
+    for (const auto& buffer : registry) count += buffer->events.size();
+    return count;
+}
+
+bool TraceRecorder::write(const std::string& filename) {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create trace file " << filename << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(registryLock);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"" << process
+        << "\"}}";
+    for (const auto& buffer : registry) {
+        const std::string label = buffer->name.empty() ? "thread " + std::to_string(buffer->tid) : buffer->name;
+        out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->tid
+            << ", \"args\": {\"name\": \"" << label << "\"}}";
+        out << ",\n{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->tid
+            << ", \"args\": {\"sort_index\": " << buffer->tid << "}}";
+        for (const Event& e : buffer->events) {
+            out << ",\n{\"name\": \"" << e.name << "\", \"cat\": \"" << e.category << "\", \"ph\": \"X\", \"ts\": "
+                << microseconds(e.begin - origin) << ", \"dur\": " << microseconds(e.end - e.begin)
+                << ", \"pid\": 1, \"tid\": " << buffer->tid;
+            if (e.arg >= 0) out << ", \"args\": {\"index\": " << e.arg << "}";
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/**
+ * @brief Timeline of spans per thread, written as Chrome Trace Event JSON
+ *        for chrome://tracing or Perfetto.
+ *
+ * Off until start(). Each thread appends to its own buffer, which is
+ * registered under a lock on the thread's first span; after that a span is
+ * two clock reads and an append to memory no other thread writes. Buffers
+ * live until the process exits, so pooled threads keep theirs from one
+ * region to the next. write() reads every buffer and must only run while no
+ * thread records (after the count has joined).
+ *
+ * Span names and categories are not copied: pass string literals.
+ */
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Start recording; timestamps count from now. */
+    static void start(const char* processName);
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Label the calling thread's row, e.g. ("read", 2) -> "read 2";
+     *        with `replace` false a thread that already has a label keeps it.
+     */
+    static void nameThread(const char* role, long long index = -1, bool replace = true);
+
+    /** @brief One complete span on the calling thread; `arg` >= 0 is shown as args.index. */
+    static void record(const char* name, const char* category, Clock::time_point begin, Clock::time_point end,
+                       long long arg = -1);
+
+    /** @brief Write every recorded span; false (with an error) if the file cannot be created. */
+    static bool write(const std::string& filename);
+    static size_t spanCount();
+
+    /** @brief Records the enclosing block (or up to stop()) as a span when tracing is on. */
+    class Span {
+    public:
+        Span(const char* name, const char* category, long long arg = -1)
+            : name(name), category(category), arg(arg), running(enabled()) {
+            if (running) begin = Clock::now();
+        }
+        ~Span() { stop(); }
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        void stop() {
+            if (!running) return;
+            running = false;
+            record(name, category, begin, Clock::now(), arg);
+        }
+
+    private:
+        const char* name;
+        const char* category;
+        long long arg;
+        bool running;
+        Clock::time_point begin;
+    };
+
+private:
+    static inline std::atomic<bool> active{false};
+};
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,79 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Bump allocator for short-lived per-document / per-batch data.
+ *
+ * Allocation is a pointer bump; reset() rewinds to the first block in O(1)
+ * and keeps every block for reuse, so a thread that processes many
+ * documents stops touching the heap after the first few. Objects placed in
+ * the arena are never destroyed: store only trivially destructible types.
+ */
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        for (;;) {
+            if (current < blocks.size()) {
+                size_t aligned = (offset + align - 1) & ~(align - 1);
+                if (aligned + bytes <= blocks[current].size) {
+                    offset = aligned + bytes;
+                    return blocks[current].data.get() + aligned;
+                }
+                ++current;
+                offset = 0;
+                continue;
+            }
+            size_t size = bytes + align > blockSize ? bytes + align : blockSize;
+            blocks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+            reserved += size;
+        }
+    }
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /** @brief Copy a string into the arena; the result is not NUL-terminated. */
+    std::string_view copy(std::string_view s) {
+        char* dst = static_cast<char*>(allocate(s.size() ? s.size() : 1, 1));
+        std::memcpy(dst, s.data(), s.size());
+        return std::string_view(dst, s.size());
+    }
+
+    /** @brief Forget every allocation; memory is kept for reuse. */
+    void reset() {
+        current = 0;
+        offset = 0;
+    }
+
+    /** @brief Bytes held from the heap (not bytes in use). */
+    size_t bytesReserved() const { return reserved; }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t offset = 0;
+    size_t reserved = 0;
+};
+
+#endif // ARENA_H
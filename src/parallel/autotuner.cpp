@@ -0,0 +1,202 @@
+#include "autotuner.h"
+#include "parallel_runtime.h"
+#include "tokenizer.h"
+#include "word_counter_parallel.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+WordCounterParallel::SyncMethod syncFromName(const std::string& name) {
+    if (name == "critical") return WordCounterParallel::SyncMethod::Critical;
+    if (name == "atomic") return WordCounterParallel::SyncMethod::Atomic;
+    return WordCounterParallel::SyncMethod::Reduction;
+}
+
+/**
+ * @brief Read up to maxBytes from the start of a file, cut after the last
+ *        whitespace so no word is truncated.
+ */
+bool readSample(const std::string& filename, size_t maxBytes, std::string& sample) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    sample.resize(maxBytes);
+    in.read(&sample[0], static_cast<std::streamsize>(maxBytes));
+    sample.resize(static_cast<size_t>(in.gcount()));
+    if (sample.size() == maxBytes) {
+        size_t cut = sample.size();
+        while (cut > 0 && !tokenizer::isSpace(sample[cut - 1])) --cut;
+        if (cut > 0) sample.resize(cut);
+    }
+    return true;
+}
+
+} // namespace
+
+bool TuningProfile::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+    TuningProfile loaded;
+    std::string line;
+    try {
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) return false;
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+            if (key == "host") loaded.host = value;
+            else if (key == "threads") loaded.threads = std::stoi(value);
+            else if (key == "sync") loaded.sync = value;
+            else if (key == "executor") loaded.executor = value;
+            else if (key == "grain") loaded.grain = static_cast<size_t>(std::stoull(value));
+            else if (key == "sample_bytes") loaded.sampleBytes = static_cast<size_t>(std::stoull(value));
+            else if (key == "sample_ms") loaded.sampleTime = std::stod(value);
+            // Unknown keys are ignored so newer profiles still load.
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (loaded.threads <= 0) {
+        return false;
+    }
+    *this = loaded;
+    return true;
+}
+
+bool TuningProfile::save(const std::string& path) const {
+    std::error_code ec;
+    auto dir = std::filesystem::path(path).parent_path();
+    if (!dir.empty()) {
+        std::filesystem::create_directories(dir, ec);
+    }
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "# parallel_counter tuning profile (written by --autotune)\n";
+    out << "host=" << host << "\n";
+    out << "threads=" << threads << "\n";
+    out << "sync=" << sync << "\n";
+    out << "executor=" << executor << "\n";
+    out << "grain=" << grain << "\n";
+    out << "sample_bytes=" << sampleBytes << "\n";
+    out << "sample_ms=" << sampleTime << "\n";
+    return static_cast<bool>(out);
+}
+
+std::string TuningProfile::hostName() {
+#if defined(_WIN32)
+    char name[MAX_COMPUTERNAME_LENGTH + 1];
+    DWORD size = sizeof(name);
+    if (GetComputerNameA(name, &size)) return std::string(name, size);
+#else
+    char name[256] = {0};
+    if (gethostname(name, sizeof(name) - 1) == 0 && name[0] != '\0') return name;
+#endif
+    return "localhost";
+}
+
+std::string TuningProfile::defaultPath() {
+    const char* home = std::getenv("HOME");
+    if (home == nullptr) home = std::getenv("USERPROFILE");
+    std::filesystem::path dir = home != nullptr ? std::filesystem::path(home) : std::filesystem::current_path();
+    return (dir / ".parallel_grepper" / ("profile-" + hostName() + ".txt")).string();
+}
+
+Autotuner::Autotuner(size_t sampleBytes, int repeats)
+    : sampleBytes(std::max<size_t>(64 * 1024, sampleBytes)), repeats(std::max(1, repeats)) {}
+
+double Autotuner::timeConfig(const std::string& sample, const TuningProfile& config) {
+    omp_set_num_threads(config.threads);
+    WordCounterParallel counter(syncFromName(config.sync));
+    if (config.executor == "ws") {
+        counter.setExecutor(WordCounterParallel::Executor::WorkStealing, config.threads, config.grain);
+    } else if (config.executor == "pipeline") {
+        counter.setExecutor(WordCounterParallel::Executor::Pipeline, config.threads, config.grain);
+    }
+
+    counter.countWords(sample);  // warm-up: page in the sample, grow the heap
+    double best = -1.0;
+    for (int r = 0; r < repeats; ++r) {
+        counter.countWords(sample);
+        double t = counter.getExecutionTime();
+        if (best < 0.0 || t < best) best = t;
+    }
+    trials.push_back({config, best});
+    return best;
+}
+
+bool Autotuner::tune(const std::string& filename, int maxThreads, TuningProfile& best) {
+    trials.clear();
+    std::string sample;
+    if (!readSample(filename, sampleBytes, sample)) {
+        return false;
+    }
+    bool hasWord = false;
+    std::string scratch;
+    tokenizer::forEachWord(sample, scratch, [&](std::string_view) { hasWord = true; });
+    if (!hasWord) {
+        return false;
+    }
+
+    if (maxThreads <= 0) {
+        maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    TuningProfile candidate;
+    candidate.host = TuningProfile::hostName();
+    candidate.sampleBytes = sample.size();
+    double bestTime = -1.0;
+    auto consider = [&](const TuningProfile& config) {
+        double t = timeConfig(sample, config);
+        if (bestTime < 0.0 || t < bestTime) {
+            bestTime = t;
+            best = config;
+        }
+    };
+
+    // Stage 1: thread count on the default engine.
+    for (int threads : threadCounts) {
+        candidate.threads = threads;
+        consider(candidate);
+    }
+    // Stage 2: sync method at the best thread count.
+    candidate = best;
+    for (const char* sync : {"atomic", "critical"}) {
+        candidate.sync = sync;
+        consider(candidate);
+    }
+    // Stage 3: alternative executors and their grain sizes.
+    candidate = best;
+    for (const char* executor : {"ws", "pipeline"}) {
+        for (size_t grain : {64 * 1024, 256 * 1024, 1024 * 1024}) {
+            candidate.executor = executor;
+            candidate.grain = grain;
+            consider(candidate);
+        }
+    }
+
+    best.sampleTime = bestTime;
+    return true;
+}
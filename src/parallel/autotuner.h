@@ -0,0 +1,69 @@
+#ifndef AUTOTUNER_H
+#define AUTOTUNER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Best-known counting configuration for one host, persisted as
+ *        "key=value" lines.
+ *
+ * Names use the CLI spelling: sync is reduction|atomic|critical, executor is
+ * omp|ws|pipeline, so a profile maps straight onto command-line defaults.
+ */
+struct TuningProfile {
+    std::string host;
+    int threads = 0;
+    std::string sync = "reduction";
+    std::string executor = "omp";
+    size_t grain = 256 * 1024;
+    size_t sampleBytes = 0;
+    double sampleTime = 0.0;  // ms for the winning configuration on the sample
+
+    /** @return false if the file is missing or malformed */
+    bool load(const std::string& path);
+    /** @return false if the file (or its directory) cannot be created */
+    bool save(const std::string& path) const;
+
+    /** @brief ~/.parallel_grepper/profile-<host>.txt */
+    static std::string defaultPath();
+    static std::string hostName();
+};
+
+/**
+ * @brief Times short counting passes on a prefix of the input and picks the
+ *        fastest configuration.
+ *
+ * The search is staged rather than exhaustive: thread count first (OpenMP,
+ * reduction), then the sync method at that count, then the work-stealing and
+ * pipeline executors over a few grain sizes. Each trial takes the best of
+ * `repeats` timed runs after one warm-up run.
+ */
+class Autotuner {
+public:
+    struct Trial {
+        TuningProfile config;
+        double time;  // best ms
+    };
+
+    explicit Autotuner(size_t sampleBytes = 8 * 1024 * 1024, int repeats = 2);
+
+    /**
+     * @param maxThreads Largest thread count to try (<= 0 uses hardware concurrency)
+     * @return false if the input cannot be read or holds no words
+     */
+    bool tune(const std::string& filename, int maxThreads, TuningProfile& best);
+
+    /** @brief Every configuration timed by the last tune(), in run order. */
+    const std::vector<Trial>& getTrials() const { return trials; }
+
+private:
+    size_t sampleBytes;
+    int repeats;
+    std::vector<Trial> trials;
+
+    double timeConfig(const std::string& sample, const TuningProfile& config);
+};
+
+#endif // AUTOTUNER_H
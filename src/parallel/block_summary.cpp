@@ -0,0 +1,365 @@
+#include "block_summary.h"
+#include "file_reader.h"
+#include "parallel_runtime.h"
+#include "sidecar_codec.h"
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'G', 'B', 'S', 'U', 'M', '0', '1'};
+// Read size when extending an edge span to the end of its last word.
+constexpr size_t kTailRead = 4096;
+
+using BlockCounts = std::unordered_map<std::string, unsigned long long, TermHash, std::equal_to<>>;
+using Entries = std::vector<std::pair<std::uint32_t, unsigned long long>>;
+
+std::string encode(const Entries& entries) {
+    std::string out;
+    std::uint32_t previous = 0;
+    for (const auto& [id, count] : entries) {
+        putVarint(out, id - previous);
+        putVarint(out, count);
+        previous = id;
+    }
+    return out;
+}
+
+template <typename Fn>
+void forEachEntry(const std::string& entries, Fn&& fn) {
+    const char* p = entries.data();
+    const char* end = p + entries.size();
+    unsigned long long id = 0;
+    unsigned long long delta = 0;
+    unsigned long long count = 0;
+    while (p < end && getVarint(p, end, delta) && getVarint(p, end, count)) {
+        id += delta;
+        fn(static_cast<std::uint32_t>(id), count);
+    }
+}
+
+/**
+ * @brief Count the words starting in [begin, end) of an open file: a word
+ *        straddling `begin` belongs to the previous span and is skipped, one
+ *        straddling `end` is read to its end and counted.
+ */
+size_t countSpan(std::ifstream& in, unsigned long long fileSize, unsigned long long begin, unsigned long long end,
+                 WordCounterParallel::WordMap& counts, unsigned long long& total) {
+    if (begin >= end) {
+        return 0;
+    }
+    const unsigned long long from = begin > 0 ? begin - 1 : 0;
+    std::string buffer(static_cast<size_t>(end - from), '\0');
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(from));
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.resize(static_cast<size_t>(in.gcount()));
+
+    char tail[kTailRead];
+    for (unsigned long long pos = from + buffer.size();
+         pos < fileSize && !buffer.empty() && !tokenizer::isSpace(buffer.back());) {
+        in.read(tail, sizeof(tail));
+        size_t got = static_cast<size_t>(in.gcount());
+        if (got == 0) break;
+        size_t stop = 0;
+        while (stop < got && !tokenizer::isSpace(tail[stop])) ++stop;
+        buffer.append(tail, stop);
+        if (stop < got) break;
+        pos += got;
+    }
+
+    size_t start = static_cast<size_t>(begin - from);
+    if (begin > 0 && !buffer.empty() && !tokenizer::isSpace(buffer[0])) {
+        while (start < buffer.size() && !tokenizer::isSpace(buffer[start])) ++start;
+    }
+    std::string scratch;
+    BlockCounts local;  // heterogeneous lookup: no string built per repeated word
+    if (start < buffer.size()) {
+        tokenizer::forEachWord(std::string_view(buffer).substr(start), scratch, [&](std::string_view w) {
+            auto it = local.find(w);
+            if (it == local.end()) {
+                local.emplace(std::string(w), 1);
+            } else {
+                ++it->second;
+            }
+            ++total;
+        });
+    }
+    for (auto& entry : local) counts[entry.first] += entry.second;
+    return buffer.size();
+}
+
+} // namespace
+
+BlockSummary::BlockSummary(size_t blockBytes) : blockBytes(std::max<size_t>(4096, blockBytes)) {}
+
+bool BlockSummary::buildFromFile(const std::string& filename) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::string text;
+    if (!readWholeFile(filename, text)) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+    sourceBytes = text.size();
+    sourceMtime = modifiedTime(filename);
+
+    const size_t n = text.size();
+    const size_t blocks = (n + blockBytes - 1) / blockBytes;
+    bounds.assign(blocks + 1, n);
+    bounds[0] = 0;
+    for (size_t b = 1; b < blocks; ++b) {
+        bounds[b] = std::max<unsigned long long>(bounds[b - 1], tokenizer::alignToTokenStart(text, b * blockBytes));
+    }
+
+    // Exact counts per block.
+    std::vector<BlockCounts> blockCounts(blocks);
+    std::vector<unsigned long long> blockTokens(blocks, 0);
+    std::atomic<size_t> next{0};
+    pg_runtime::parallelRegion([&](int, int) {
+        std::string scratch;
+        for (size_t b; (b = next.fetch_add(1, std::memory_order_relaxed)) < blocks;) {
+            BlockCounts& counts = blockCounts[b];
+            std::string_view block(text.data() + bounds[b], static_cast<size_t>(bounds[b + 1] - bounds[b]));
+            tokenizer::forEachWord(block, scratch, [&](std::string_view w) {
+                auto it = counts.find(w);
+                if (it == counts.end()) {
+                    counts.emplace(std::string(w), 1);
+                } else {
+                    ++it->second;
+                }
+                ++blockTokens[b];
+            });
+        }
+    });
+
+    // One sorted vocabulary, so blocks store small ascending ids.
+    std::unordered_map<std::string, std::uint32_t, TermHash, std::equal_to<>> ids;
+    for (const auto& counts : blockCounts) {
+        for (const auto& entry : counts) ids.emplace(entry.first, 0);
+    }
+    vocabulary.clear();
+    vocabulary.reserve(ids.size());
+    for (const auto& entry : ids) vocabulary.push_back(entry.first);
+    std::sort(vocabulary.begin(), vocabulary.end());
+    for (size_t i = 0; i < vocabulary.size(); ++i) ids[vocabulary[i]] = static_cast<std::uint32_t>(i);
+
+    levels.assign(1, std::vector<Node>(blocks));
+    next = 0;
+    pg_runtime::parallelRegion([&](int, int) {
+        Entries entries;
+        for (size_t b; (b = next.fetch_add(1, std::memory_order_relaxed)) < blocks;) {
+            entries.clear();
+            for (const auto& [word, count] : blockCounts[b]) entries.emplace_back(ids.find(word)->second, count);
+            std::sort(entries.begin(), entries.end());
+            levels[0][b] = {blockTokens[b], encode(entries)};
+            BlockCounts().swap(blockCounts[b]);
+        }
+    });
+
+    // Segment tree: node k of level l + 1 merges nodes 2k and 2k + 1 of level l.
+    while (levels.back().size() > 1) {
+        const std::vector<Node>& below = levels.back();
+        std::vector<Node> above((below.size() + 1) / 2);
+        next = 0;
+        pg_runtime::parallelRegion([&](int, int) {
+            Entries merged;
+            for (size_t k; (k = next.fetch_add(1, std::memory_order_relaxed)) < above.size();) {
+                if (2 * k + 1 == below.size()) {
+                    above[k] = below[2 * k];
+                    continue;
+                }
+                merged.clear();
+                forEachEntry(below[2 * k].entries, [&](std::uint32_t id, unsigned long long c) { merged.emplace_back(id, c); });
+                const size_t left = merged.size();
+                forEachEntry(below[2 * k + 1].entries, [&](std::uint32_t id, unsigned long long c) { merged.emplace_back(id, c); });
+                std::inplace_merge(merged.begin(), merged.begin() + static_cast<std::ptrdiff_t>(left), merged.end());
+                size_t out = 0;
+                for (size_t i = 0; i < merged.size(); ++i) {
+                    if (out > 0 && merged[out - 1].first == merged[i].first) {
+                        merged[out - 1].second += merged[i].second;
+                    } else {
+                        merged[out++] = merged[i];
+                    }
+                }
+                merged.resize(out);
+                above[k] = {below[2 * k].tokens + below[2 * k + 1].tokens, encode(merged)};
+            }
+        });
+        levels.push_back(std::move(above));
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return true;
+}
+
+bool BlockSummary::save(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create summary file " << filename << std::endl;
+        return false;
+    }
+    std::string buffer(kMagic, sizeof(kMagic));
+    putVarint(buffer, blockBytes);
+    putVarint(buffer, sourceBytes);
+    putVarint(buffer, static_cast<unsigned long long>(sourceMtime));
+    putVarint(buffer, vocabulary.size());
+    for (const auto& w : vocabulary) {
+        putVarint(buffer, w.size());
+        buffer += w;
+    }
+    putVarint(buffer, getBlockCount());
+    for (size_t b = 1; b < bounds.size(); ++b) putVarint(buffer, bounds[b] - bounds[b - 1]);
+    putVarint(buffer, levels.size());
+    for (const auto& level : levels) {
+        putVarint(buffer, level.size());
+        for (const auto& node : level) {
+            putVarint(buffer, node.tokens);
+            putVarint(buffer, node.entries.size());
+            buffer += node.entries;
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(out);
+}
+
+bool BlockSummary::load(const std::string& filename) {
+    std::string contents;
+    if (!readWholeFile(filename, contents) || contents.size() < sizeof(kMagic) ||
+        std::memcmp(contents.data(), kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    const char* p = contents.data() + sizeof(kMagic);
+    const char* end = contents.data() + contents.size();
+    auto readBytes = [&](std::string& out) {
+        unsigned long long length = 0;
+        if (!getVarint(p, end, length) || length > static_cast<size_t>(end - p)) return false;
+        out.assign(p, static_cast<size_t>(length));
+        p += length;
+        return true;
+    };
+
+    unsigned long long block = 0, size = 0, mtime = 0, words = 0, blocks = 0, levelCount = 0;
+    if (!getVarint(p, end, block) || !getVarint(p, end, size) || !getVarint(p, end, mtime) ||
+        !getVarint(p, end, words) || words > contents.size()) {
+        return false;
+    }
+    std::vector<std::string> loadedVocabulary(static_cast<size_t>(words));
+    for (auto& w : loadedVocabulary) {
+        if (!readBytes(w)) return false;
+    }
+    if (!getVarint(p, end, blocks) || blocks > contents.size()) {
+        return false;
+    }
+    std::vector<unsigned long long> loadedBounds(static_cast<size_t>(blocks) + 1, 0);
+    for (size_t b = 1; b < loadedBounds.size(); ++b) {
+        unsigned long long length = 0;
+        if (!getVarint(p, end, length)) return false;
+        loadedBounds[b] = loadedBounds[b - 1] + length;
+    }
+    if (!getVarint(p, end, levelCount) || levelCount > 64) {
+        return false;
+    }
+    std::vector<std::vector<Node>> loadedLevels(static_cast<size_t>(levelCount));
+    for (auto& level : loadedLevels) {
+        unsigned long long nodes = 0;
+        if (!getVarint(p, end, nodes) || nodes > contents.size()) return false;
+        level.resize(static_cast<size_t>(nodes));
+        for (auto& node : level) {
+            if (!getVarint(p, end, node.tokens) || !readBytes(node.entries)) return false;
+        }
+    }
+
+    blockBytes = static_cast<size_t>(block);
+    sourceBytes = size;
+    sourceMtime = static_cast<long long>(mtime);
+    vocabulary = std::move(loadedVocabulary);
+    bounds = std::move(loadedBounds);
+    levels = std::move(loadedLevels);
+    executionTime = 0.0;
+    return true;
+}
+
+bool BlockSummary::matches(const std::string& sourceFile) const {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(sourceFile, ec);
+    return !ec && size == sourceBytes && modifiedTime(sourceFile) == sourceMtime;
+}
+
+bool BlockSummary::queryBytes(const std::string& sourceFile, unsigned long long begin, unsigned long long end,
+                              RangeResult& result) const {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    result = RangeResult();
+    std::ifstream in(sourceFile, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    const unsigned long long fileSize = static_cast<unsigned long long>(in.tellg());
+    end = std::min(end, fileSize);
+
+    // Whole blocks inside [begin, end): block i is the first starting at or
+    // after begin, block j - 1 the last ending at or before end.
+    size_t i = 0;
+    size_t j = 0;
+    if (!levels.empty() && begin < end) {
+        const size_t blocks = getBlockCount();
+        i = static_cast<size_t>(std::lower_bound(bounds.begin(), bounds.end() - 1, begin) - bounds.begin());
+        j = static_cast<size_t>(std::upper_bound(bounds.begin(), bounds.end(), end) - bounds.begin());
+        j = j > 0 ? j - 1 : 0;
+        j = std::min(j, blocks);
+    }
+
+    if (i >= j) {
+        result.bytesRescanned = countSpan(in, fileSize, begin, end, result.counts, result.totalWords);
+    } else {
+        result.bytesRescanned = countSpan(in, fileSize, begin, bounds[i], result.counts, result.totalWords);
+        result.bytesRescanned += countSpan(in, fileSize, bounds[j], end, result.counts, result.totalWords);
+
+        // Bottom-up segment tree walk: O(log blocks) nodes cover blocks [i, j).
+        std::vector<unsigned long long> dense(vocabulary.size(), 0);
+        std::vector<std::uint32_t> touched;
+        auto add = [&](const Node& node) {
+            ++result.summariesUsed;
+            result.totalWords += node.tokens;
+            forEachEntry(node.entries, [&](std::uint32_t id, unsigned long long c) {
+                if (dense[id] == 0) touched.push_back(id);
+                dense[id] += c;
+            });
+        };
+        for (size_t level = 0, lo = i, hi = j; lo < hi; ++level, lo >>= 1, hi >>= 1) {
+            if (lo & 1) add(levels[level][lo++]);
+            if (hi & 1) add(levels[level][--hi]);
+        }
+        result.counts.reserve(result.counts.size() + touched.size());
+        for (std::uint32_t id : touched) result.counts[vocabulary[id]] += dense[id];
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    result.executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return true;
+}
+
+size_t BlockSummary::getSummaryBytes() const {
+    size_t bytes = 0;
+    for (const auto& level : levels) {
+        for (const auto& node : level) bytes += node.entries.size();
+    }
+    return bytes;
+}
+
+unsigned long long BlockSummary::getTotalWords() const {
+    return levels.empty() || levels.back().empty() ? 0 : levels.back()[0].tokens;
+}
@@ -0,0 +1,79 @@
+#ifndef BLOCK_SUMMARY_H
+#define BLOCK_SUMMARY_H
+
+#include "word_counter_parallel.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Per-block word counts of a file, for "top words between offsets A
+ *        and B" queries that do not rescan the whole range.
+ *
+ * The file is cut into fixed-size, token-aligned blocks and every block's
+ * exact counts are stored as (word id, count) pairs over one shared sorted
+ * vocabulary, varint-delta encoded. Blocks are also merged pairwise into a
+ * segment tree (level l node covers 2^l aligned blocks), so any run of whole
+ * blocks is covered by O(log blocks) summaries. A query adds those
+ * summaries and rescans only the two partial edge blocks from the file.
+ *
+ * A word belongs to a range when its first byte does, the same rule the
+ * parallel counters use when they split a buffer.
+ */
+class BlockSummary {
+public:
+    static constexpr size_t kDefaultBlockBytes = 4 * 1024 * 1024;
+
+    struct RangeResult {
+        WordCounterParallel::WordMap counts;
+        unsigned long long totalWords = 0;
+        size_t summariesUsed = 0;   // tree nodes added
+        size_t bytesRescanned = 0;  // edge bytes read from the file
+        double executionTime = 0.0; // ms
+    };
+
+    explicit BlockSummary(size_t blockBytes = kDefaultBlockBytes);
+
+    /** @return false if the file cannot be read */
+    bool buildFromFile(const std::string& filename);
+
+    /** @return false if the summary file cannot be created */
+    bool save(const std::string& filename) const;
+    /** @return false if the file is missing or not a block summary */
+    bool load(const std::string& filename);
+    /** @brief Whether sourceFile still has the size and mtime the summary was built from. */
+    bool matches(const std::string& sourceFile) const;
+
+    /**
+     * @brief Counts of the words starting in [begin, end) of sourceFile.
+     *        Without blocks (nothing built or loaded) the range is scanned.
+     * @return false if the file cannot be read
+     */
+    bool queryBytes(const std::string& sourceFile, unsigned long long begin, unsigned long long end,
+                    RangeResult& result) const;
+
+    size_t getBlockBytes() const { return blockBytes; }
+    size_t getBlockCount() const { return bounds.empty() ? 0 : bounds.size() - 1; }
+    size_t getVocabularySize() const { return vocabulary.size(); }
+    size_t getSummaryBytes() const;
+    unsigned long long getTotalWords() const;
+    unsigned long long getSourceBytes() const { return sourceBytes; }
+    double getExecutionTime() const { return executionTime; }
+
+private:
+    struct Node {
+        unsigned long long tokens = 0;
+        std::string entries;  // varint (id delta, count) pairs, ids ascending
+    };
+
+    size_t blockBytes;
+    unsigned long long sourceBytes = 0;
+    long long sourceMtime = 0;
+    std::vector<std::string> vocabulary;      // sorted; ids are indices
+    std::vector<unsigned long long> bounds;   // block b is [bounds[b], bounds[b + 1])
+    std::vector<std::vector<Node>> levels;    // levels[0] = blocks
+    double executionTime = 0.0;
+};
+
+#endif // BLOCK_SUMMARY_H
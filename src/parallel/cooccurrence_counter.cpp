@@ -0,0 +1,233 @@
+#include "cooccurrence_counter.h"
+#include "file_reader.h"
+#include "parallel_runtime.h"
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+inline std::uint64_t mixKey(std::uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+} // namespace
+
+CooccurrenceCounter::PairTable::PairTable() : slots(1024, {kEmpty, 0}) {}
+
+void CooccurrenceCounter::PairTable::add(PairKey key, std::uint64_t amount) {
+    size_t mask = slots.size() - 1;
+    size_t i = static_cast<size_t>(mixKey(key)) & mask;
+    while (slots[i].first != kEmpty) {
+        if (slots[i].first == key) {
+            slots[i].second += amount;
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    slots[i] = {key, amount};
+    if (++used * 10 > slots.size() * 7) {
+        grow();
+    }
+}
+
+void CooccurrenceCounter::PairTable::grow() {
+    std::vector<std::pair<PairKey, std::uint64_t>> old(slots.size() * 2, {kEmpty, 0});
+    old.swap(slots);
+    size_t mask = slots.size() - 1;
+    for (const auto& slot : old) {
+        if (slot.first == kEmpty) continue;
+        size_t i = static_cast<size_t>(mixKey(slot.first)) & mask;
+        while (slots[i].first != kEmpty) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+CooccurrenceCounter::CooccurrenceCounter(size_t window) : window(std::max<size_t>(2, window)) {}
+
+bool CooccurrenceCounter::countFromFile(const std::string& filename) {
+    std::string contents;
+    if (!readWholeFile(filename, contents)) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        executionTime = 0.0;
+        return false;
+    }
+    countText(contents);
+    return true;
+}
+
+void CooccurrenceCounter::countText(const std::string& text) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const int maxThreads = omp_get_max_threads();
+    std::vector<std::vector<std::uint32_t>> chunkTokens(static_cast<size_t>(maxThreads));
+    std::vector<std::vector<const std::string*>> chunkWords(static_cast<size_t>(maxThreads));
+    std::vector<std::unordered_map<std::string, std::uint32_t>> chunkIds(static_cast<size_t>(maxThreads));
+    int numThreads = 1;
+
+    // Phase 1: tokenize each byte range and intern into a thread-local dictionary.
+    pg_runtime::parallelRegion([&](int t, int nt) {
+        if (t == 0) numThreads = nt;
+
+        std::string_view view(text);
+        size_t begin = tokenizer::alignToTokenStart(view, view.size() * static_cast<size_t>(t) / static_cast<size_t>(nt));
+        size_t end = tokenizer::alignToTokenStart(view, view.size() * static_cast<size_t>(t + 1) / static_cast<size_t>(nt));
+
+        auto& ids = chunkIds[static_cast<size_t>(t)];
+        auto& tokens = chunkTokens[static_cast<size_t>(t)];
+        auto& words = chunkWords[static_cast<size_t>(t)];
+        tokens.reserve((end - begin) / 5 + 1);
+        std::string scratch;
+        if (begin < end) {
+            tokenizer::forEachWord(view.substr(begin, end - begin), scratch, [&](std::string_view w) {
+                auto [it, inserted] = ids.try_emplace(std::string(w), static_cast<std::uint32_t>(ids.size()));
+                if (inserted) {
+                    words.push_back(&it->first);
+                }
+                tokens.push_back(it->second);
+            });
+        }
+    });
+
+    // Phase 2: assign global dense IDs. Serial, but only over each chunk's unique words.
+    vocabulary.clear();
+    std::unordered_map<std::string, std::uint32_t> globalIds;
+    std::vector<std::vector<std::uint32_t>> remap(static_cast<size_t>(numThreads));
+    for (int t = 0; t < numThreads; ++t) {
+        auto& r = remap[static_cast<size_t>(t)];
+        r.reserve(chunkWords[static_cast<size_t>(t)].size());
+        for (const std::string* w : chunkWords[static_cast<size_t>(t)]) {
+            auto [it, inserted] = globalIds.try_emplace(*w, static_cast<std::uint32_t>(vocabulary.size()));
+            if (inserted) {
+                vocabulary.push_back(*w);
+            }
+            r.push_back(it->second);
+        }
+    }
+
+    std::vector<size_t> offsets(static_cast<size_t>(numThreads) + 1, 0);
+    for (int t = 0; t < numThreads; ++t) {
+        offsets[static_cast<size_t>(t) + 1] = offsets[static_cast<size_t>(t)] + chunkTokens[static_cast<size_t>(t)].size();
+    }
+    const size_t tokenCount = offsets.back();
+    std::vector<std::uint32_t> tokens(tokenCount);
+
+    std::vector<std::vector<PairTable>> local(static_cast<size_t>(numThreads));
+    partitions.assign(static_cast<size_t>(numThreads), PairTable());
+
+    const size_t nt = static_cast<size_t>(numThreads);
+
+    // Phases 3-5 run as separate regions (the region boundary is the barrier);
+    // thread t takes units t, t + team, ..., so with a full team it keeps the
+    // same range and partition throughout.
+
+    // Phase 3: rewrite local IDs to global ones in the shared token array.
+    pg_runtime::parallelRegion([&](int t, int team) {
+        for (size_t c = static_cast<size_t>(t); c < nt; c += static_cast<size_t>(team)) {
+            const auto& r = remap[c];
+            std::uint32_t* out = tokens.data() + offsets[c];
+            for (std::uint32_t id : chunkTokens[c]) {
+                *out++ = r[id];
+            }
+            std::vector<std::uint32_t>().swap(chunkTokens[c]);
+        }
+    });
+
+    // Phase 4: count pairs for positions in each range; the window reads past
+    // the range end so pairs straddling ranges are counted once.
+    pg_runtime::parallelRegion([&](int t, int team) {
+        for (size_t c = static_cast<size_t>(t); c < nt; c += static_cast<size_t>(team)) {
+            auto& parts = local[c];
+            parts.assign(nt, PairTable());
+            size_t begin = tokenCount * c / nt;
+            size_t end = tokenCount * (c + 1) / nt;
+            for (size_t i = begin; i < end; ++i) {
+                size_t last = std::min(tokenCount, i + window);
+                for (size_t j = i + 1; j < last; ++j) {
+                    PairKey key = packPair(tokens[i], tokens[j]);
+                    parts[static_cast<size_t>(mixKey(key) >> 32) % nt].add(key, 1);
+                }
+            }
+        }
+    });
+
+    // Phase 5: partition p of every range's table merges into partitions[p].
+    pg_runtime::parallelRegion([&](int t, int team) {
+        for (size_t p = static_cast<size_t>(t); p < nt; p += static_cast<size_t>(team)) {
+            PairTable& merged = partitions[p];
+            for (size_t src = 0; src < nt; ++src) {
+                local[src][p].forEach([&](PairKey key, std::uint64_t count) { merged.add(key, count); });
+            }
+        }
+    });
+
+    totalWords = tokenCount;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+size_t CooccurrenceCounter::getUniquePairs() const {
+    size_t total = 0;
+    for (const auto& p : partitions) total += p.size();
+    return total;
+}
+
+std::vector<std::pair<CooccurrenceCounter::PairKey, std::uint64_t>>
+CooccurrenceCounter::getTopPairs(int n) const {
+    std::vector<std::pair<PairKey, std::uint64_t>> pairs;
+    pairs.reserve(getUniquePairs());
+    for (const auto& p : partitions) {
+        p.forEach([&](PairKey key, std::uint64_t count) { pairs.emplace_back(key, count); });
+    }
+
+    auto byCount = [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    if (n > 0 && n < static_cast<int>(pairs.size())) {
+        std::partial_sort(pairs.begin(), pairs.begin() + n, pairs.end(), byCount);
+        pairs.resize(static_cast<size_t>(n));
+    } else {
+        std::sort(pairs.begin(), pairs.end(), byCount);
+    }
+    return pairs;
+}
+
+void CooccurrenceCounter::saveResults(const std::string& filename, int topN) const {
+    std::ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Cannot create output file " << filename << std::endl;
+        return;
+    }
+
+    outFile << "Word Co-occurrence Results\n";
+    outFile << "================================\n";
+    outFile << "Window: " << window << " tokens\n";
+    outFile << "Total Words: " << totalWords << "\n";
+    outFile << "Vocabulary: " << vocabulary.size() << "\n";
+    outFile << "Unique Pairs: " << getUniquePairs() << "\n";
+    outFile << "Execution Time: " << std::fixed << std::setprecision(2)
+            << executionTime << " ms\n";
+    outFile << "================================\n\n";
+
+    outFile << std::left << std::setw(20) << "Word A" << std::setw(20) << "Word B"
+            << std::right << std::setw(15) << "Count" << std::setw(20) << "Pair Key" << "\n";
+    outFile << std::string(75, '-') << "\n";
+
+    for (const auto& [key, count] : getTopPairs(topN)) {
+        auto [a, b] = unpackPair(key);
+        outFile << std::left << std::setw(20) << vocabulary[a] << std::setw(20) << vocabulary[b]
+                << std::right << std::setw(15) << count << std::setw(20) << key << "\n";
+    }
+
+    outFile.close();
+    std::cout << "Results saved to: " << filename << std::endl;
+}
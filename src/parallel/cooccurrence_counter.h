@@ -0,0 +1,85 @@
+#ifndef COOCCURRENCE_COUNTER_H
+#define COOCCURRENCE_COUNTER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Sliding-window word co-occurrence counts.
+ *
+ * Words are interned into dense 32-bit IDs, so a pair is a single 64-bit key
+ * (smaller ID in the high half). Threads count pairs over static token ranges
+ * into per-thread tables already split into one partition per thread; the
+ * merge then has thread p fold partition p of every thread, so no two
+ * threads ever write the same table.
+ */
+class CooccurrenceCounter {
+public:
+    using PairKey = std::uint64_t;
+
+    /**
+     * @brief Open-addressing PairKey -> count table (empty key = ~0).
+     */
+    class PairTable {
+    public:
+        PairTable();
+        void add(PairKey key, std::uint64_t amount);
+        template <typename Fn>
+        void forEach(Fn&& fn) const {
+            for (const auto& slot : slots) {
+                if (slot.first != kEmpty) fn(slot.first, slot.second);
+            }
+        }
+        size_t size() const { return used; }
+
+    private:
+        static constexpr PairKey kEmpty = ~PairKey(0);
+        std::vector<std::pair<PairKey, std::uint64_t>> slots;
+        size_t used = 0;
+        void grow();
+    };
+
+    /**
+     * @param window Pairs are counted between tokens fewer than `window` positions apart
+     */
+    explicit CooccurrenceCounter(size_t window = 5);
+
+    /**
+     * @return false if the file cannot be read
+     */
+    bool countFromFile(const std::string& filename);
+    void countText(const std::string& text);
+
+    static PairKey packPair(std::uint32_t a, std::uint32_t b) {
+        if (a > b) std::swap(a, b);
+        return (static_cast<PairKey>(a) << 32) | b;
+    }
+    static std::pair<std::uint32_t, std::uint32_t> unpackPair(PairKey key) {
+        return {static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key)};
+    }
+
+    /** @brief Word for each dense ID. */
+    const std::vector<std::string>& getVocabulary() const { return vocabulary; }
+    /** @brief Merged table, one partition per counting thread. */
+    const std::vector<PairTable>& getPartitions() const { return partitions; }
+
+    /** @brief Top N pairs by count (0 = all), highest first. */
+    std::vector<std::pair<PairKey, std::uint64_t>> getTopPairs(int n) const;
+
+    void saveResults(const std::string& filename, int topN = 0) const;
+
+    double getExecutionTime() const { return executionTime; }
+    unsigned long long getTotalWords() const { return totalWords; }
+    size_t getUniquePairs() const;
+
+private:
+    size_t window;
+    std::vector<std::string> vocabulary;
+    std::vector<PairTable> partitions;
+    double executionTime = 0.0;
+    unsigned long long totalWords = 0;
+};
+
+#endif // COOCCURRENCE_COUNTER_H
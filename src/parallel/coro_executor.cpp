@@ -0,0 +1,152 @@
+#include "coro_executor.h"
+#include "file_reader.h"
+#include "topology.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+thread_local int workerIndex = -1;
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+} // namespace
+
+CoroExecutor::CoroExecutor(int workerCount, int ioThreadCount, size_t maxInFlight, const std::vector<int>& placement)
+    : maxInFlight(std::max<size_t>(1, maxInFlight)) {
+    if (workerCount <= 0) {
+        workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    if (ioThreadCount <= 0) {
+        ioThreadCount = 4 * workerCount;
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        const int cpu = placement.empty() ? -1 : placement[static_cast<size_t>(i) % placement.size()];
+        workers.emplace_back([this, i, cpu]() {
+            topology::pinCurrentThread(cpu);
+            workerLoop(i);
+        });
+    }
+    for (int i = 0; i < ioThreadCount; ++i) {
+        ioThreads.emplace_back([this]() { ioLoop(); });
+    }
+}
+
+CoroExecutor::~CoroExecutor() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    workReady.notify_all();
+    readReady.notify_all();
+    for (auto& t : workers) t.join();
+    for (auto& t : ioThreads) t.join();
+}
+
+int CoroExecutor::currentWorker() {
+    return workerIndex;
+}
+
+void CoroExecutor::run(size_t count, const std::function<Task(size_t)>& make) {
+    auto startTime = Clock::now();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stats = Stats();
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            slotFree.wait(guard, [&]() { return inFlight < maxInFlight; });
+            ++inFlight;
+            stats.peakInFlight = std::max(stats.peakInFlight, inFlight);
+        }
+        Task task = make(i);
+        auto handle = task.handle;
+        task.handle = nullptr;
+        handle.promise().owner = this;
+        schedule(handle);
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    // Also wait for workers to leave resume(), so their timings are in stats.
+    slotFree.wait(guard, [&]() { return inFlight == 0 && resuming == 0; });
+    stats.wallTime = elapsedMs(startTime);
+}
+
+void CoroExecutor::schedule(std::coroutine_handle<> h) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        runnable.push_back(h);
+    }
+    workReady.notify_one();
+}
+
+void CoroExecutor::submitRead(ReadAwaiter* read) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        reads.push_back(read);
+    }
+    readReady.notify_one();
+}
+
+void CoroExecutor::taskFinished() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        --inFlight;
+    }
+    slotFree.notify_all();
+}
+
+void CoroExecutor::workerLoop(int id) {
+    workerIndex = id;
+    for (;;) {
+        std::coroutine_handle<> h;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            workReady.wait(guard, [&]() { return stopping || !runnable.empty(); });
+            if (runnable.empty()) return;
+            h = runnable.front();
+            runnable.pop_front();
+            ++resuming;
+        }
+        // Runs until the coroutine's next co_await (or its end).
+        auto busyStart = Clock::now();
+        h.resume();
+        double busy = elapsedMs(busyStart);
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stats.computeTime += busy;
+            --resuming;
+        }
+        slotFree.notify_all();
+    }
+}
+
+void CoroExecutor::ioLoop() {
+    for (;;) {
+        ReadAwaiter* read;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            readReady.wait(guard, [&]() { return stopping || !reads.empty(); });
+            if (reads.empty()) return;
+            read = reads.front();
+            reads.pop_front();
+        }
+        auto readStart = Clock::now();
+        read->ok = readWholeFile(read->path, read->contents);
+        double elapsed = elapsedMs(readStart);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stats.readTime += elapsed;
+            ++stats.filesRead;
+        }
+        schedule(read->handle);
+    }
+}
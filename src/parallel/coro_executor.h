@@ -0,0 +1,146 @@
+#ifndef CORO_EXECUTOR_H
+#define CORO_EXECUTOR_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief C++20 coroutine executor that overlaps file reads with compute.
+ *
+ * A coroutine co_awaits readFile(); the read runs on a pool of blocking I/O
+ * threads (the "reactor") and the coroutine is resumed on one of the compute
+ * workers once the bytes are in memory. A handful of workers can therefore
+ * keep hundreds of files in flight on slow or network storage, where a
+ * thread that reads synchronously would sit idle for every file.
+ */
+class CoroExecutor {
+public:
+    /**
+     * @brief Detached, lazily started coroutine. run() starts it on a worker;
+     *        its frame is freed as soon as it finishes.
+     */
+    class Task {
+    public:
+        struct promise_type {
+            CoroExecutor* owner = nullptr;
+
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    CoroExecutor* owner = h.promise().owner;
+                    h.destroy();
+                    owner->taskFinished();
+                }
+                void await_resume() noexcept {}
+            };
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        Task(Task&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        ~Task() {
+            if (handle) handle.destroy();  // never handed to run()
+        }
+
+    private:
+        friend class CoroExecutor;
+        explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    /** @brief Awaitable returned by readFile(); yields false if the file could not be read. */
+    class ReadAwaiter {
+    public:
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            handle = h;
+            owner->submitRead(this);
+        }
+        bool await_resume() const noexcept { return ok; }
+
+    private:
+        friend class CoroExecutor;
+        ReadAwaiter(CoroExecutor* owner, const std::string& path, std::string& contents)
+            : owner(owner), path(path), contents(contents) {}
+
+        CoroExecutor* owner;
+        const std::string& path;
+        std::string& contents;
+        std::coroutine_handle<> handle;
+        bool ok = false;
+    };
+
+    struct Stats {
+        double wallTime = 0.0;     // ms for the whole run
+        double readTime = 0.0;     // ms summed over I/O threads
+        double computeTime = 0.0;  // ms summed over workers
+        size_t filesRead = 0;
+        size_t peakInFlight = 0;
+    };
+
+    /**
+     * @param workers Compute threads (<= 0 uses hardware concurrency)
+     * @param ioThreads Blocking read threads (<= 0 uses 4x workers)
+     * @param maxInFlight Tasks alive at once; bounds memory held by read buffers
+     * @param placement CPU plan: worker i is pinned to placement[i % size]
+     *        (empty = OS placement); IO threads are left unpinned
+     */
+    CoroExecutor(int workers, int ioThreads, size_t maxInFlight = 256, const std::vector<int>& placement = {});
+    ~CoroExecutor();
+
+    CoroExecutor(const CoroExecutor&) = delete;
+    CoroExecutor& operator=(const CoroExecutor&) = delete;
+
+    /** @brief co_await to read a whole file; resumes on a worker thread. */
+    ReadAwaiter readFile(const std::string& path, std::string& contents) { return ReadAwaiter(this, path, contents); }
+
+    /**
+     * @brief Start make(i) for every i in [0, count), at most maxInFlight at
+     *        a time, and block until all of them finished.
+     */
+    void run(size_t count, const std::function<Task(size_t)>& make);
+
+    /** @brief Index of the calling worker in [0, getWorkers()), or -1 off the pool. */
+    static int currentWorker();
+
+    int getWorkers() const { return static_cast<int>(workers.size()); }
+    int getIoThreads() const { return static_cast<int>(ioThreads.size()); }
+    size_t getMaxInFlight() const { return maxInFlight; }
+    const Stats& getStats() const { return stats; }
+
+private:
+    std::vector<std::thread> workers;
+    std::vector<std::thread> ioThreads;
+    size_t maxInFlight;
+    Stats stats;
+
+    std::mutex lock;  // guards everything below
+    std::condition_variable workReady;
+    std::condition_variable readReady;
+    std::condition_variable slotFree;
+    std::deque<std::coroutine_handle<>> runnable;
+    std::deque<ReadAwaiter*> reads;
+    size_t inFlight = 0;
+    size_t resuming = 0;  // workers inside resume()
+    bool stopping = false;
+
+    void workerLoop(int id);
+    void ioLoop();
+    void schedule(std::coroutine_handle<> h);
+    void submitRead(ReadAwaiter* read);
+    void taskFinished();
+};
+
+#endif // CORO_EXECUTOR_H
@@ -0,0 +1,344 @@
+#include "corpus_analyzer.h"
+#include "arena.h"
+#include "file_reader.h"
+#include "parallel_runtime.h"
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+constexpr size_t kRankBlock = 4;
+
+/**
+ * @brief Open-addressing word -> count set whose slots and key bytes live in
+ *        an Arena; clearing is an arena reset plus a fresh slot array.
+ */
+class DocumentVocabulary {
+public:
+    struct Slot {
+        const char* data;
+        size_t length;
+        size_t hash;
+        unsigned long long count;
+    };
+
+    explicit DocumentVocabulary(Arena& arena) : arena(arena) {}
+
+    void clear(size_t expectedWords) {
+        size_t capacity = 16;
+        while (capacity < expectedWords * 2) capacity <<= 1;
+        allocateSlots(capacity);
+        used = 0;
+    }
+
+    void add(std::string_view word) {
+        size_t h = std::hash<std::string_view>{}(word);
+        size_t i = h & mask;
+        while (slots[i].data != nullptr) {
+            if (slots[i].hash == h && slots[i].length == word.size() &&
+                std::memcmp(slots[i].data, word.data(), word.size()) == 0) {
+                ++slots[i].count;
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        std::string_view stored = arena.copy(word);
+        slots[i] = {stored.data(), stored.size(), h, 1};
+        if (++used * 2 > mask + 1) {
+            grow();
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t i = 0; i <= mask; ++i) {
+            if (slots[i].data != nullptr) {
+                fn(std::string_view(slots[i].data, slots[i].length), slots[i].count);
+            }
+        }
+    }
+
+    size_t size() const { return used; }
+
+private:
+    Arena& arena;
+    Slot* slots = nullptr;
+    size_t mask = 0;
+    size_t used = 0;
+
+    void allocateSlots(size_t capacity) {
+        slots = arena.allocateArray<Slot>(capacity);
+        std::memset(static_cast<void*>(slots), 0, sizeof(Slot) * capacity);
+        mask = capacity - 1;
+    }
+
+    void grow() {
+        Slot* old = slots;
+        size_t oldCapacity = mask + 1;
+        // The old array stays in the arena until the next reset.
+        allocateSlots(oldCapacity * 2);
+        for (size_t j = 0; j < oldCapacity; ++j) {
+            if (old[j].data != nullptr) {
+                size_t i = old[j].hash & mask;
+                while (slots[i].data != nullptr) i = (i + 1) & mask;
+                slots[i] = old[j];
+            }
+        }
+    }
+};
+
+/**
+ * @brief Per-thread scratch for scanning documents: the dedup vocabulary, its
+ *        arena, and TF/DF tables merged into the shared ones at the end.
+ */
+struct ScanState {
+    Arena arena;
+    DocumentVocabulary vocabulary{arena};
+    CorpusAnalyzer::WordMap localTF;
+    CorpusAnalyzer::WordMap localDF;
+    std::string scratch;
+};
+
+void scanDocument(const std::string& contents, CorpusAnalyzer::Document& doc, ScanState& state) {
+    state.arena.reset();
+    state.vocabulary.clear(contents.size() / 32);
+    tokenizer::forEachWord(contents, state.scratch, [&](std::string_view word) {
+        state.vocabulary.add(word);
+        ++doc.totalWords;
+    });
+
+    doc.terms.reserve(state.vocabulary.size());
+    state.vocabulary.forEach([&](std::string_view word, unsigned long long count) {
+        doc.terms.emplace_back(std::string(word), count);
+        state.localTF[doc.terms.back().first] += count;
+        state.localDF[doc.terms.back().first] += 1;
+    });
+}
+
+void mergeScanState(const ScanState& state, CorpusAnalyzer::WordMap& termFreq, CorpusAnalyzer::WordMap& docFreq) {
+    // Merge: the shared TF/DF tables are plain unordered_maps.
+    for (const auto& entry : state.localTF) {
+        termFreq[entry.first] += entry.second;
+    }
+    for (const auto& entry : state.localDF) {
+        docFreq[entry.first] += entry.second;
+    }
+}
+
+} // namespace
+
+CorpusAnalyzer::CorpusAnalyzer(size_t topTerms) : topTermCount(topTerms) {}
+
+std::vector<std::string> CorpusAnalyzer::listCorpus(const std::string& spec) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+
+    if (!spec.empty() && spec[0] == '@') {
+        std::ifstream list(spec.substr(1));
+        if (!list.is_open()) {
+            std::cerr << "Error: Cannot open corpus list " << spec.substr(1) << std::endl;
+            return files;
+        }
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) files.push_back(line);
+        }
+        return files;
+    }
+
+    std::error_code ec;
+    if (fs::is_directory(spec, ec)) {
+        for (const auto& entry : fs::recursive_directory_iterator(spec, ec)) {
+            if (entry.is_regular_file(ec)) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+    } else {
+        files.push_back(spec);
+    }
+    return files;
+}
+
+bool CorpusAnalyzer::analyze(const std::vector<std::string>& files) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    termFreq.clear();
+    docFreq.clear();
+    documents.assign(files.size(), Document());
+    std::vector<char> readable(files.size(), 0);
+    unsigned long long totalWordCount = asyncIoThreads > 0 ? scanAsync(files, readable) : scanThreads(files, readable);
+
+    size_t kept = 0;
+    for (size_t d = 0; d < documents.size(); ++d) {
+        if (readable[d]) {
+            if (kept != d) {
+                documents[kept] = std::move(documents[d]);
+            }
+            ++kept;
+        }
+    }
+    documents.resize(kept);
+    totalWords = totalWordCount;
+
+    rankDocuments();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return !documents.empty();
+}
+
+void CorpusAnalyzer::setAsyncIo(int ioThreads, size_t maxInFlight) {
+    asyncIoThreads = ioThreads;
+    asyncMaxInFlight = maxInFlight;
+}
+
+unsigned long long CorpusAnalyzer::scanThreads(const std::vector<std::string>& files, std::vector<char>& readable) {
+    std::atomic<unsigned long long> totalWordCount{0};
+    std::atomic<size_t> next{0};
+    std::mutex logLock;
+    std::mutex mergeLock;
+
+    // A shared cursor hands out one document at a time: document sizes vary
+    // far more than word lengths do.
+    pg_runtime::parallelRegion([&](int, int) {
+        ScanState state;
+        std::string contents;
+        unsigned long long words = 0;
+        for (size_t d; (d = next.fetch_add(1, std::memory_order_relaxed)) < files.size();) {
+            Document& doc = documents[d];
+            doc.path = files[d];
+            if (!readWholeFile(doc.path, contents)) {
+                std::lock_guard<std::mutex> guard(logLock);
+                std::cerr << "Warning: Cannot read " << doc.path << ", skipping" << std::endl;
+                continue;
+            }
+            readable[d] = 1;
+            scanDocument(contents, doc, state);
+            words += doc.totalWords;
+        }
+        totalWordCount.fetch_add(words, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> guard(mergeLock);
+        mergeScanState(state, termFreq, docFreq);
+    });
+    return totalWordCount.load();
+}
+
+unsigned long long CorpusAnalyzer::scanAsync(const std::vector<std::string>& files, std::vector<char>& readable) {
+    CoroExecutor executor(omp_get_max_threads(), asyncIoThreads, asyncMaxInFlight, pg_runtime::placement());
+    // One scan state per worker: a document is scanned without suspending,
+    // so it never migrates between workers halfway through.
+    std::vector<ScanState> states(static_cast<size_t>(executor.getWorkers()));
+    std::mutex logLock;
+
+    auto scanFile = [&](size_t d) -> CoroExecutor::Task {
+        Document& doc = documents[d];
+        doc.path = files[d];
+        std::string contents;
+        if (!co_await executor.readFile(doc.path, contents)) {
+            std::lock_guard<std::mutex> guard(logLock);
+            std::cerr << "Warning: Cannot read " << doc.path << ", skipping" << std::endl;
+            co_return;
+        }
+        readable[d] = 1;
+        scanDocument(contents, doc, states[static_cast<size_t>(CoroExecutor::currentWorker())]);
+    };
+    executor.run(files.size(), scanFile);
+    ioStats = executor.getStats();
+
+    unsigned long long totalWordCount = 0;
+    for (const auto& doc : documents) totalWordCount += doc.totalWords;
+    for (auto& state : states) mergeScanState(state, termFreq, docFreq);
+    return totalWordCount;
+}
+
+void CorpusAnalyzer::rankDocuments() {
+    const double docCount = static_cast<double>(documents.size());
+
+    // Documents are claimed kRankBlock at a time: ranking one is cheap.
+    std::atomic<size_t> next{0};
+    pg_runtime::parallelRegion([&](int, int) {
+        for (size_t block; (block = next.fetch_add(kRankBlock, std::memory_order_relaxed)) < documents.size();) {
+            const size_t blockEnd = std::min(documents.size(), block + kRankBlock);
+            for (size_t d = block; d < blockEnd; ++d) {
+                Document& doc = documents[d];
+                if (doc.totalWords == 0) {
+                    continue;
+                }
+                TermScores scores;
+                scores.reserve(doc.terms.size());
+                for (const auto& [term, count] : doc.terms) {
+                    // tf = count / |doc|, idf = ln(N / df); docFreq is read-only here.
+                    double tf = static_cast<double>(count) / static_cast<double>(doc.totalWords);
+                    double idf = std::log(docCount / static_cast<double>(docFreq.at(term)));
+                    scores.emplace_back(term, tf * idf);
+                }
+                size_t k = std::min(topTermCount, scores.size());
+                std::partial_sort(scores.begin(), scores.begin() + static_cast<long>(k), scores.end(),
+                                  [](const auto& a, const auto& b) {
+                                      return a.second != b.second ? a.second > b.second : a.first < b.first;
+                                  });
+                scores.resize(k);
+                doc.topTerms = std::move(scores);
+            }
+        }
+    });
+}
+
+void CorpusAnalyzer::saveResults(const std::string& filename, int topN) const {
+    std::ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Cannot create output file " << filename << std::endl;
+        return;
+    }
+
+    outFile << "Corpus Analysis Results\n";
+    outFile << "================================\n";
+    outFile << "Documents: " << documents.size() << "\n";
+    outFile << "Total Words: " << totalWords << "\n";
+    outFile << "Unique Words: " << termFreq.size() << "\n";
+    outFile << "Execution Time: " << std::fixed << std::setprecision(2)
+            << executionTime << " ms\n";
+    outFile << "================================\n\n";
+
+    std::vector<std::pair<std::string, unsigned long long>> terms(termFreq.begin(), termFreq.end());
+    std::sort(terms.begin(), terms.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (topN > 0 && topN < static_cast<int>(terms.size())) {
+        terms.resize(static_cast<size_t>(topN));
+    }
+
+    outFile << std::left << std::setw(30) << "Word"
+            << std::right << std::setw(15) << "Frequency"
+            << std::setw(15) << "Documents" << "\n";
+    outFile << std::string(60, '-') << "\n";
+    for (const auto& [w, freq] : terms) {
+        outFile << std::left << std::setw(30) << w << std::right << std::setw(15) << freq
+                << std::setw(15) << docFreq.at(w) << "\n";
+    }
+
+    outFile << "\nTop TF-IDF Terms per Document\n";
+    outFile << "================================\n";
+    for (const auto& doc : documents) {
+        outFile << "\n" << doc.path << " (" << doc.totalWords << " words)\n";
+        for (const auto& [term, score] : doc.topTerms) {
+            outFile << "  " << std::left << std::setw(28) << term << std::right
+                    << std::setw(15) << std::setprecision(6) << score << "\n";
+        }
+    }
+
+    outFile.close();
+    std::cout << "Results saved to: " << filename << std::endl;
+}
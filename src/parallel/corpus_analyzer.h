@@ -0,0 +1,97 @@
+#ifndef CORPUS_ANALYZER_H
+#define CORPUS_ANALYZER_H
+
+#include "coro_executor.h"
+#include "word_counter_parallel.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Term frequency, document frequency and per-document TF-IDF over a
+ *        multi-file corpus in a single parallel scan.
+ *
+ * Documents are distributed dynamically across OpenMP threads. Each thread
+ * builds the document's vocabulary in a dedup set drawn from a per-thread
+ * arena (reset in O(1) between documents), folds it into thread-local TF/DF
+ * tables, and the tables are merged into the shared ones once per thread.
+ * TF-IDF ranking afterwards only touches the per-document vocabularies, not
+ * the input.
+ *
+ * With setAsyncIo() the scan runs on a CoroExecutor instead: reads are
+ * co_awaited on I/O threads, so many files are in flight while the workers
+ * tokenize whichever ones have arrived.
+ */
+class CorpusAnalyzer {
+public:
+    using WordMap = WordCounterParallel::WordMap;
+    using TermScores = std::vector<std::pair<std::string, double>>;
+
+    struct Document {
+        std::string path;
+        unsigned long long totalWords = 0;
+        std::vector<std::pair<std::string, unsigned long long>> terms; // unique terms with in-document counts
+        TermScores topTerms;                                           // highest TF-IDF first
+    };
+
+    /**
+     * @param topTerms TF-IDF terms to keep per document
+     */
+    explicit CorpusAnalyzer(size_t topTerms = 10);
+
+    /**
+     * @brief Expand a corpus spec into file paths: a directory (recursive,
+     *        sorted) or "@list.txt" with one path per line.
+     */
+    static std::vector<std::string> listCorpus(const std::string& spec);
+
+    /**
+     * @brief Scan every file once; unreadable files are reported and skipped.
+     * @return false if no document could be read
+     */
+    bool analyze(const std::vector<std::string>& files);
+
+    /**
+     * @brief Overlap reads with counting on a coroutine executor.
+     * @param ioThreads Blocking read threads (0 = synchronous OpenMP scan)
+     * @param maxInFlight Files read or being counted at once
+     */
+    void setAsyncIo(int ioThreads, size_t maxInFlight = 256);
+    bool isAsyncIo() const { return asyncIoThreads > 0; }
+    /** @brief Read/compute overlap of the last async analyze(). */
+    const CoroExecutor::Stats& getIoStats() const { return ioStats; }
+
+    const WordMap& getTermFrequency() const { return termFreq; }
+    const WordMap& getDocumentFrequency() const { return docFreq; }
+    const std::vector<Document>& getDocuments() const { return documents; }
+
+    /**
+     * @brief Write corpus TF/DF for the top N terms followed by each
+     *        document's TF-IDF terms.
+     */
+    void saveResults(const std::string& filename, int topN = 0) const;
+
+    double getExecutionTime() const { return executionTime; }
+    unsigned long long getTotalWords() const { return totalWords; }
+    size_t getUniqueWords() const { return termFreq.size(); }
+    size_t getDocumentCount() const { return documents.size(); }
+
+private:
+    size_t topTermCount;
+    WordMap termFreq;
+    WordMap docFreq;
+    std::vector<Document> documents;
+    double executionTime = 0.0;
+    unsigned long long totalWords = 0;
+    int asyncIoThreads = 0;
+    size_t asyncMaxInFlight = 256;
+    CoroExecutor::Stats ioStats;
+
+    // Fill documents[d] (and readable[d]) plus the shared TF/DF tables; return total words.
+    unsigned long long scanThreads(const std::vector<std::string>& files, std::vector<char>& readable);
+    unsigned long long scanAsync(const std::vector<std::string>& files, std::vector<char>& readable);
+    void rankDocuments();
+};
+
+#endif // CORPUS_ANALYZER_H
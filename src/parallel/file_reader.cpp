@@ -0,0 +1,18 @@
+#include "file_reader.h"
+
+#include <fstream>
+
+bool readWholeFile(const std::string& filename, std::string& contents) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::streamoff size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    contents.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return size == 0 || static_cast<bool>(file.read(&contents[0], size));
+}
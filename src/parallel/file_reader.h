@@ -0,0 +1,12 @@
+#ifndef FILE_READER_H
+#define FILE_READER_H
+
+#include <string>
+
+/**
+ * @brief Read a whole file into memory in one pass (binary, no translation).
+ * @return false if the file cannot be opened or read
+ */
+bool readWholeFile(const std::string& filename, std::string& contents);
+
+#endif // FILE_READER_H
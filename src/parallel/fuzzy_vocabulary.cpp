@@ -0,0 +1,144 @@
+#include "fuzzy_vocabulary.h"
+#include "parallel_runtime.h"
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+
+namespace {
+
+// Match masks of a pattern of 1..64 bytes: bit i of peq[c] is set when a[i] == c.
+struct Pattern {
+    std::uint64_t peq[256] = {};
+    size_t length = 0;
+
+    explicit Pattern(std::string_view a) : length(a.size()) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            peq[static_cast<unsigned char>(a[i])] |= std::uint64_t{1} << i;
+        }
+    }
+};
+
+/**
+ * @brief Myers/Hyyrö bit-parallel Levenshtein distance between a pattern of
+ *        1..64 bytes and b: column j of the DP matrix is kept as vertical
+ *        +1/-1 delta bit vectors, and the score tracks the bottom cell.
+ */
+int myersDistance(const Pattern& pattern, std::string_view b) {
+    const size_t m = pattern.length;
+    const std::uint64_t* peq = pattern.peq;
+    const std::uint64_t high = std::uint64_t{1} << (m - 1);
+    std::uint64_t pv = ~std::uint64_t{0};
+    std::uint64_t mv = 0;
+    int score = static_cast<int>(m);
+    for (char c : b) {
+        const std::uint64_t eq = peq[static_cast<unsigned char>(c)];
+        const std::uint64_t xv = eq | mv;
+        const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        std::uint64_t ph = mv | ~(xh | pv);
+        std::uint64_t mh = pv & xh;
+        if (ph & high) {
+            ++score;
+        } else if (mh & high) {
+            --score;
+        }
+        // Global distance: the top row grows by one per text byte.
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+int dpDistance(std::string_view a, std::string_view b) {
+    std::vector<int> row(b.size() + 1);
+    std::iota(row.begin(), row.end(), 0);
+    for (size_t i = 1; i <= a.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= b.size(); ++j) {
+            int above = row[j];
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1] ? 1 : 0)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+} // namespace
+
+FuzzyVocabulary::FuzzyVocabulary(const WordCounterParallel::WordMap& counts) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (const auto& [word, count] : counts) {
+        if (word.size() >= buckets.size()) buckets.resize(word.size() + 1);
+        Bucket& bucket = buckets[word.size()];
+        bucket.bytes += word;
+        bucket.masks.push_back(maskOf(word));
+        bucket.counts.push_back(count);
+    }
+    wordCount = counts.size();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    buildTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+std::uint32_t FuzzyVocabulary::maskOf(std::string_view word) {
+    std::uint32_t mask = 0;
+    for (char c : word) mask |= std::uint32_t{1} << (static_cast<unsigned char>(c) % 32);
+    return mask;
+}
+
+int FuzzyVocabulary::editDistance(std::string_view a, std::string_view b) {
+    if (a.empty()) return static_cast<int>(b.size());
+    if (b.empty()) return static_cast<int>(a.size());
+    return a.size() <= 64 ? myersDistance(Pattern(a), b) : dpDistance(a, b);
+}
+
+std::vector<FuzzyVocabulary::Match> FuzzyVocabulary::lookup(std::string_view query, int maxEdits) const {
+    std::string normalized;
+    tokenizer::normalize(query, normalized);
+    std::vector<Match> matches;
+    if (maxEdits < 0) return matches;
+
+    const size_t k = static_cast<size_t>(maxEdits);
+    // Built once per query; every candidate then costs one pass over its bytes.
+    const bool bitParallel = !normalized.empty() && normalized.size() <= 64;
+    const Pattern pattern(bitParallel ? std::string_view(normalized) : std::string_view());
+    const std::uint32_t queryMask = maskOf(normalized);
+    const size_t minLength = normalized.size() > k ? normalized.size() - k : 1;
+    const size_t maxLength = std::min(normalized.size() + k, buckets.empty() ? 0 : buckets.size() - 1);
+    for (size_t length = minLength; length <= maxLength; ++length) {
+        const Bucket& bucket = buckets[length];
+        const size_t words = bucket.masks.size();
+        for (size_t i = 0; i < words; ++i) {
+            if (static_cast<size_t>(std::popcount(bucket.masks[i] ^ queryMask)) > 2 * k) continue;
+            std::string_view word(bucket.bytes.data() + i * length, length);
+            int distance = bitParallel ? myersDistance(pattern, word) : editDistance(normalized, word);
+            if (distance <= maxEdits) {
+                matches.push_back({std::string(word), bucket.counts[i], distance});
+            }
+        }
+    }
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        if (a.count != b.count) return a.count > b.count;
+        return a.word < b.word;
+    });
+    return matches;
+}
+
+std::vector<std::vector<FuzzyVocabulary::Match>>
+FuzzyVocabulary::lookupAll(const std::vector<std::string>& queries, int maxEdits) const {
+    std::vector<std::vector<Match>> results(queries.size());
+    std::atomic<size_t> next{0};
+    pg_runtime::parallelRegion([&](int, int) {
+        for (size_t q; (q = next.fetch_add(1, std::memory_order_relaxed)) < queries.size();) {
+            results[q] = lookup(queries[q], maxEdits);
+        }
+    });
+    return results;
+}
@@ -0,0 +1,63 @@
+#ifndef FUZZY_VOCABULARY_H
+#define FUZZY_VOCABULARY_H
+
+#include "word_counter_parallel.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Approximate lookup over a counted vocabulary: every word within
+ *        Levenshtein distance k of a query, with its count.
+ *
+ * Words are bucketed by length and stored back to back per bucket, each
+ * with a 32-bit mask of the bytes it contains. A query only visits the
+ * buckets within k of its own length, and skips any word whose mask differs
+ * from the query's in more than 2k bits (one edit flips at most two). The
+ * survivors are verified with Myers' bit-parallel edit distance, one machine
+ * word per text byte for queries up to 64 bytes.
+ *
+ * The vocabulary is read-only after construction, so lookupAll() runs many
+ * queries at once, one per thread.
+ */
+class FuzzyVocabulary {
+public:
+    struct Match {
+        std::string word;
+        unsigned long long count;
+        int distance;
+    };
+
+    explicit FuzzyVocabulary(const WordCounterParallel::WordMap& counts);
+
+    /**
+     * @brief Words within maxEdits of query (normalized first), closest
+     *        first, then by descending count.
+     */
+    std::vector<Match> lookup(std::string_view query, int maxEdits) const;
+    /** @brief lookup() for every query, in parallel across queries. */
+    std::vector<std::vector<Match>> lookupAll(const std::vector<std::string>& queries, int maxEdits) const;
+
+    /** @brief Levenshtein distance; bit-parallel when a is at most 64 bytes. */
+    static int editDistance(std::string_view a, std::string_view b);
+
+    size_t size() const { return wordCount; }
+    double getBuildTime() const { return buildTime; }
+
+private:
+    struct Bucket {
+        std::string bytes;                      // words of this length, back to back
+        std::vector<std::uint32_t> masks;       // bytes present, bit (byte % 32)
+        std::vector<unsigned long long> counts;
+    };
+
+    std::vector<Bucket> buckets;  // by word length
+    size_t wordCount = 0;
+    double buildTime = 0.0;
+
+    static std::uint32_t maskOf(std::string_view word);
+};
+
+#endif // FUZZY_VOCABULARY_H
@@ -0,0 +1,41 @@
+#ifndef LINE_CHUNKS_H
+#define LINE_CHUNKS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Default split for the chunked scans: several chunks per thread, so a chunk
+// that is slow to scan (dense with matches or distinct words) does not stall
+// the rest, and none smaller than is worth a separate task.
+constexpr size_t kChunksPerThread = 8;
+constexpr size_t kMinChunkBytes = 64 * 1024;
+
+/** @brief Chunks for `bytes` of input on `threads` threads: at least 1. */
+inline size_t chunksFor(size_t bytes, size_t threads, size_t minChunkBytes = kMinChunkBytes,
+                        size_t chunksPerThread = kChunksPerThread) {
+    return std::max<size_t>(1, std::min(threads * chunksPerThread, bytes / std::max<size_t>(1, minChunkBytes)));
+}
+
+/**
+ * @brief Split text into at most maxChunks chunks of at least minChunkBytes
+ *        that each end just past a '\n' (or at the end of the text), so no
+ *        line crosses a chunk boundary.
+ * @return chunks + 1 bounds; chunk c is [bounds[c], bounds[c + 1])
+ */
+inline std::vector<size_t> splitAtLines(std::string_view text, size_t maxChunks, size_t minChunkBytes) {
+    const size_t n = text.size();
+    const size_t chunks = chunksFor(n, maxChunks, minChunkBytes, 1);
+    std::vector<size_t> bounds(chunks + 1, n);
+    bounds[0] = 0;
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t pos = std::max(bounds[c - 1], n / chunks * c);
+        const void* nl = pos < n ? std::memchr(text.data() + pos, '\n', n - pos) : nullptr;
+        bounds[c] = nl != nullptr ? static_cast<size_t>(static_cast<const char*>(nl) - text.data()) + 1 : n;
+    }
+    return bounds;
+}
+
+#endif // LINE_CHUNKS_H
@@ -0,0 +1,225 @@
+#include "line_index.h"
+#include "file_reader.h"
+#include "line_chunks.h"
+#include "parallel_runtime.h"
+#include "sidecar_codec.h"
+#include "simd_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// Counting newlines is uniform work, so fewer, larger chunks than the default.
+constexpr size_t kLineChunksPerThread = 4;
+constexpr size_t kMinLineChunkBytes = 1024 * 1024;
+// Read size for readLines.
+constexpr size_t kReadBlock = 1024 * 1024;
+
+constexpr char kMagic[8] = {'P', 'G', 'L', 'I', 'D', 'X', '0', '1'};
+constexpr size_t kHeaderFields = 5;  // after the magic
+
+} // namespace
+
+LineIndex::LineIndex(size_t stride) : stride(std::max<size_t>(1, stride)) {}
+
+bool LineIndex::buildFromFile(const std::string& filename) {
+    std::string contents;
+    if (!readWholeFile(filename, contents)) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+    buildFromText(contents);
+    sourceMtime = modifiedTime(filename);
+    return true;
+}
+
+void LineIndex::buildFromText(std::string_view text) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const char* data = text.data();
+    const size_t n = text.size();
+    sourceBytes = n;
+    sourceMtime = 0;
+
+    const size_t threads = static_cast<size_t>(omp_get_max_threads());
+    const size_t chunks = chunksFor(n, threads, kMinLineChunkBytes, kLineChunksPerThread);
+    chunkCount = chunks;
+    auto chunkBegin = [&](size_t c) { return n / chunks * c; };
+    auto chunkEnd = [&](size_t c) { return c + 1 == chunks ? n : n / chunks * (c + 1); };
+
+    // Pass 1: newlines per chunk.
+    std::vector<unsigned long long> newlines(chunks, 0);
+    std::atomic<size_t> next{0};
+    pg_runtime::parallelRegion([&](int, int) {
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            newlines[c] = simd::countByte(data + chunkBegin(c), chunkEnd(c) - chunkBegin(c), '\n');
+        }
+    });
+
+    std::vector<unsigned long long> before(chunks, 0);
+    unsigned long long total = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+        before[c] = total;
+        total += newlines[c];
+    }
+    totalLines = total + (n > 0 && text.back() != '\n' ? 1 : 0);
+
+    // Pass 2: the 0-based line k > 0 starts just past the k-th newline, so
+    // each chunk records the stride multiples among its newline ranks.
+    std::vector<std::vector<std::uint64_t>> found(chunks);
+    next = 0;
+    pg_runtime::parallelRegion([&](int, int) {
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            const size_t end = chunkEnd(c);
+            size_t pos = chunkBegin(c);
+            unsigned long long consumed = before[c];
+            for (unsigned long long k = (before[c] / stride + 1) * stride; k <= before[c] + newlines[c]; k += stride) {
+                pos += simd::findNthByte(data + pos, end - pos, '\n', static_cast<size_t>(k - consumed));
+                consumed = k;
+                ++pos;
+                if (pos < n) found[c].push_back(pos);
+            }
+        }
+    });
+
+    offsets.clear();
+    offsets.reserve(static_cast<size_t>(totalLines / stride + 1));
+    if (n > 0) offsets.push_back(0);
+    for (const auto& part : found) offsets.insert(offsets.end(), part.begin(), part.end());
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+bool LineIndex::save(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create line index " << filename << std::endl;
+        return false;
+    }
+    const std::uint64_t header[kHeaderFields] = {
+        stride, totalLines, sourceBytes, static_cast<std::uint64_t>(sourceMtime), offsets.size()};
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()),
+              static_cast<std::streamsize>(offsets.size() * sizeof(std::uint64_t)));
+    return static_cast<bool>(out);
+}
+
+bool LineIndex::load(const std::string& filename) {
+    std::string contents;
+    std::uint64_t header[kHeaderFields];
+    if (!readWholeFile(filename, contents) || contents.size() < sizeof(kMagic) + sizeof(header) ||
+        std::memcmp(contents.data(), kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    std::memcpy(header, contents.data() + sizeof(kMagic), sizeof(header));
+    const size_t payload = contents.size() - sizeof(kMagic) - sizeof(header);
+    if (header[0] == 0 || header[4] != payload / sizeof(std::uint64_t) || payload % sizeof(std::uint64_t) != 0) {
+        return false;
+    }
+    stride = static_cast<size_t>(header[0]);
+    totalLines = header[1];
+    sourceBytes = header[2];
+    sourceMtime = static_cast<long long>(header[3]);
+    offsets.resize(static_cast<size_t>(header[4]));
+    std::memcpy(offsets.data(), contents.data() + sizeof(kMagic) + sizeof(header), payload);
+    chunkCount = 0;
+    executionTime = 0.0;
+    return true;
+}
+
+bool LineIndex::matches(const std::string& sourceFile) const {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(sourceFile, ec);
+    return !ec && size == sourceBytes && (sourceMtime == 0 || modifiedTime(sourceFile) == sourceMtime);
+}
+
+LineIndex::Checkpoint LineIndex::checkpointFor(unsigned long long line) const {
+    if (offsets.empty() || line <= 1) {
+        return {1, 0};
+    }
+    size_t i = std::min<size_t>(static_cast<size_t>((line - 1) / stride), offsets.size() - 1);
+    return {static_cast<unsigned long long>(i) * stride + 1, offsets[i]};
+}
+
+bool LineIndex::lineOffset(const std::string& sourceFile, unsigned long long line, unsigned long long& offset) const {
+    std::ifstream in(sourceFile, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    const Checkpoint checkpoint = checkpointFor(line);
+    in.seekg(static_cast<std::streamoff>(checkpoint.offset));
+    offset = checkpoint.offset;
+    unsigned long long remaining = line > checkpoint.line ? line - checkpoint.line : 0;
+    std::vector<char> block(kReadBlock);
+    while (remaining > 0) {
+        in.read(block.data(), static_cast<std::streamsize>(block.size()));
+        const size_t got = static_cast<size_t>(in.gcount());
+        if (got == 0) break;
+        size_t nl = simd::findNthByte(block.data(), got, '\n', static_cast<size_t>(remaining));
+        if (nl < got) {
+            offset += nl + 1;
+            return true;
+        }
+        remaining -= simd::countByte(block.data(), got, '\n');
+        offset += got;
+    }
+    return true;
+}
+
+bool LineIndex::readLines(const std::string& sourceFile, unsigned long long first, unsigned long long last,
+                          std::vector<std::string>& lines) const {
+    lines.clear();
+    std::ifstream in(sourceFile, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    first = std::max<unsigned long long>(1, first);
+    if (last < first) {
+        return true;
+    }
+
+    const Checkpoint checkpoint = checkpointFor(first);
+    in.seekg(static_cast<std::streamoff>(checkpoint.offset));
+    unsigned long long line = checkpoint.line;  // line the read cursor is on
+    std::vector<char> block(kReadBlock);
+    std::string current;
+    while (line <= last) {
+        in.read(block.data(), static_cast<std::streamsize>(block.size()));
+        const size_t got = static_cast<size_t>(in.gcount());
+        if (got == 0) break;
+        size_t pos = 0;
+        if (line < first) {
+            size_t nl = simd::findNthByte(block.data(), got, '\n', static_cast<size_t>(first - line));
+            if (nl == got) {
+                line += simd::countByte(block.data(), got, '\n');
+                continue;
+            }
+            line = first;
+            pos = nl + 1;
+        }
+        while (pos < got && line <= last) {
+            const void* nl = std::memchr(block.data() + pos, '\n', got - pos);
+            if (nl == nullptr) {
+                current.append(block.data() + pos, got - pos);
+                break;
+            }
+            size_t end = static_cast<size_t>(static_cast<const char*>(nl) - block.data());
+            current.append(block.data() + pos, end - pos);
+            lines.push_back(std::move(current));
+            current.clear();
+            ++line;
+            pos = end + 1;
+        }
+    }
+    if (!current.empty() && line <= last) {
+        lines.push_back(std::move(current));  // last line without a trailing '\n'
+    }
+    return true;
+}
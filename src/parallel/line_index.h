@@ -0,0 +1,84 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Sidecar index of line start offsets, for random access by line
+ *        number without rescanning the file.
+ *
+ * Every stride-th line start is recorded (lines 1, stride + 1, ...), so a
+ * lookup seeks to the nearest checkpoint and skips at most stride - 1
+ * newlines with the SIMD nth-byte scan.
+ *
+ * Building is two parallel SIMD passes over fixed byte chunks: count each
+ * chunk's newlines, prefix-sum them into global line numbers, then record
+ * the checkpoints falling inside each chunk.
+ *
+ * File layout (host byte order, every field 8 bytes, so the file can be
+ * mapped and offsets[] used in place):
+ *   magic "PGLIDX01" | stride | totalLines | sourceBytes | sourceMtime |
+ *   entries | offsets[entries]
+ */
+class LineIndex {
+public:
+    static constexpr size_t kDefaultStride = 1024;
+
+    struct Checkpoint {
+        unsigned long long line;    // 1-based
+        unsigned long long offset;  // byte offset of that line's start
+    };
+
+    explicit LineIndex(size_t stride = kDefaultStride);
+
+    /** @return false if the file cannot be read */
+    bool buildFromFile(const std::string& filename);
+    void buildFromText(std::string_view text);
+
+    /** @return false if the index file cannot be created */
+    bool save(const std::string& filename) const;
+    /** @return false if the file is missing or not a line index */
+    bool load(const std::string& filename);
+    /** @brief Whether sourceFile still has the size and mtime the index was built from. */
+    bool matches(const std::string& sourceFile) const;
+
+    /** @brief Nearest checkpoint at or before 1-based `line`. */
+    Checkpoint checkpointFor(unsigned long long line) const;
+
+    /**
+     * @brief Byte offset at which 1-based `line` starts in sourceFile (the
+     *        file size if it has fewer lines), found by seeking to the
+     *        nearest checkpoint and skipping the remaining newlines.
+     * @return false if the file cannot be read
+     */
+    bool lineOffset(const std::string& sourceFile, unsigned long long line, unsigned long long& offset) const;
+
+    /**
+     * @brief Lines [first, last] (1-based, inclusive, without '\n') of
+     *        sourceFile, read from the nearest checkpoint onwards only.
+     * @return false if the file cannot be read
+     */
+    bool readLines(const std::string& sourceFile, unsigned long long first, unsigned long long last,
+                   std::vector<std::string>& lines) const;
+
+    size_t getStride() const { return stride; }
+    unsigned long long getTotalLines() const { return totalLines; }
+    const std::vector<std::uint64_t>& getOffsets() const { return offsets; }
+    size_t getChunkCount() const { return chunkCount; }
+    unsigned long long getSourceBytes() const { return sourceBytes; }
+    double getExecutionTime() const { return executionTime; }
+
+private:
+    size_t stride;
+    unsigned long long totalLines = 0;
+    unsigned long long sourceBytes = 0;
+    long long sourceMtime = 0;
+    std::vector<std::uint64_t> offsets;
+    size_t chunkCount = 0;
+    double executionTime = 0.0;
+};
+
+#endif // LINE_INDEX_H
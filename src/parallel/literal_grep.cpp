@@ -0,0 +1,125 @@
+#include "literal_grep.h"
+#include "file_reader.h"
+#include "line_chunks.h"
+#include "parallel_runtime.h"
+#include "simd_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+struct ChunkResult {
+    std::vector<LiteralGrep::MatchLine> lines;  // lineNumber is chunk-local (0-based)
+    unsigned long long newlines = 0;
+    unsigned long long matches = 0;
+};
+
+/**
+ * @brief Scan [begin, end) of text; end is just past a '\n' or the end of
+ *        the text, so no line crosses the chunk boundary.
+ */
+void scanChunk(std::string_view text, size_t begin, size_t end, std::string_view pattern, ChunkResult& out) {
+    const char* data = text.data();
+    size_t cursor = begin;           // newlines before cursor are counted
+    unsigned long long line = 0;     // chunk-local line of cursor
+    size_t from = begin;
+    while (from < end) {
+        size_t hit = from + simd::findLiteral(data + from, end - from, pattern);
+        if (hit >= end) {
+            break;
+        }
+        size_t lineStart = hit;
+        while (lineStart > cursor && data[lineStart - 1] != '\n') --lineStart;
+        const void* nl = std::memchr(data + hit, '\n', end - hit);
+        size_t lineEnd = nl != nullptr ? static_cast<size_t>(static_cast<const char*>(nl) - data) : end;
+
+        line += simd::countByte(data + cursor, lineStart - cursor, '\n');
+        size_t onLine = 0;
+        for (size_t pos = hit; pos < lineEnd;) {
+            ++onLine;
+            pos += pattern.size();
+            pos += simd::findLiteral(data + pos, lineEnd - pos, pattern);
+        }
+        out.lines.push_back({line, lineStart, lineEnd - lineStart, onLine});
+        out.matches += onLine;
+
+        cursor = lineStart;
+        from = lineEnd < end ? lineEnd + 1 : end;
+    }
+    out.newlines = line + simd::countByte(data + cursor, end - cursor, '\n');
+}
+
+} // namespace
+
+LiteralGrep::LiteralGrep(std::string pattern) : pattern(std::move(pattern)) {}
+
+bool LiteralGrep::searchFile(const std::string& filename) {
+    if (!readWholeFile(filename, contents)) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+    searchText(contents);
+    return true;
+}
+
+void LiteralGrep::searchText(std::string_view input) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    text = input;
+    matches.clear();
+    matchCount = 0;
+
+    const size_t n = text.size();
+    const size_t threads = static_cast<size_t>(omp_get_max_threads());
+    const std::vector<size_t> bounds = splitAtLines(text, threads * kChunksPerThread, kMinChunkBytes);
+    const size_t chunks = bounds.size() - 1;
+    chunkCount = chunks;
+
+    std::vector<ChunkResult> results(chunks);
+    const bool searchable = !pattern.empty() && pattern.find('\n') == std::string::npos;
+    std::atomic<size_t> next{0};
+    pg_runtime::parallelRegion([&](int, int) {
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            if (searchable) {
+                scanChunk(text, bounds[c], bounds[c + 1], pattern, results[c]);
+            } else {
+                results[c].newlines = simd::countByte(text.data() + bounds[c], bounds[c + 1] - bounds[c], '\n');
+            }
+        }
+    });
+
+    // Exclusive prefix sum of chunk newline counts gives each chunk's first line.
+    unsigned long long firstLine = 1;
+    size_t lineCount = 0;
+    for (const auto& r : results) lineCount += r.lines.size();
+    matches.reserve(lineCount);
+    for (const auto& r : results) {
+        for (const auto& m : r.lines) {
+            matches.push_back({firstLine + m.lineNumber, m.offset, m.length, m.matches});
+        }
+        matchCount += r.matches;
+        firstLine += r.newlines;
+    }
+    totalLines = (firstLine - 1) + (n > 0 && text.back() != '\n' ? 1 : 0);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+void LiteralGrep::saveResults(const std::string& filename) const {
+    std::ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Cannot create output file " << filename << std::endl;
+        return;
+    }
+    for (const auto& m : matches) {
+        outFile << m.lineNumber << ':' << line(m) << '\n';
+    }
+    outFile.close();
+    std::cout << "Results saved to: " << filename << std::endl;
+}
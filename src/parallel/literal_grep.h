@@ -0,0 +1,63 @@
+#ifndef LITERAL_GREP_H
+#define LITERAL_GREP_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Parallel fixed-string search over one buffer, grep -n style.
+ *
+ * The input is cut into chunks that end on a newline, so every line belongs
+ * to exactly one chunk. Threads scan chunks independently (SIMD candidate
+ * filter, see simd_scan.h) and record matching lines with line numbers local
+ * to their chunk plus the chunk's newline count; an exclusive prefix sum over
+ * those counts then turns local numbers into global ones. Unlike a
+ * sequential grep, one large file therefore scales with the thread count.
+ */
+class LiteralGrep {
+public:
+    struct MatchLine {
+        unsigned long long lineNumber;  // 1-based
+        size_t offset;                  // line start in the searched text
+        size_t length;                  // without the trailing '\n'
+        size_t matches;                 // non-overlapping occurrences on the line
+    };
+
+    /**
+     * @param pattern Non-empty and without '\n' (matching is per line);
+     *        anything else never matches
+     */
+    explicit LiteralGrep(std::string pattern);
+
+    /** @return false if the file cannot be read */
+    bool searchFile(const std::string& filename);
+    /** @brief Search text; it must outlive calls to line(). */
+    void searchText(std::string_view text);
+
+    /** @brief Matching lines in input order. */
+    const std::vector<MatchLine>& getMatches() const { return matches; }
+    std::string_view line(const MatchLine& match) const { return text.substr(match.offset, match.length); }
+
+    /** @brief Write "lineNumber:line" for every matching line. */
+    void saveResults(const std::string& filename) const;
+
+    unsigned long long getMatchCount() const { return matchCount; }
+    unsigned long long getTotalLines() const { return totalLines; }
+    size_t getChunkCount() const { return chunkCount; }
+    double getExecutionTime() const { return executionTime; }
+    const std::string& getPattern() const { return pattern; }
+
+private:
+    std::string pattern;
+    std::string contents;  // owned input for searchFile
+    std::string_view text;
+    std::vector<MatchLine> matches;
+    unsigned long long matchCount = 0;
+    unsigned long long totalLines = 0;
+    size_t chunkCount = 0;
+    double executionTime = 0.0;
+};
+
+#endif // LITERAL_GREP_H
@@ -1,12 +1,86 @@
 #include "word_counter_parallel.h"
+#include "autotuner.h"
+#include "block_summary.h"
+#include "cooccurrence_counter.h"
+#include "corpus_analyzer.h"
+#include "fuzzy_vocabulary.h"
+#include "line_index.h"
+#include "literal_grep.h"
+#include "multi_pattern.h"
+#include "parallel_runtime.h"
+#include "positional_index.h"
+#include "regex_grep.h"
+#include "simd_scan.h"
+#include "topology.h"
+#include "trace_recorder.h"
+#include "windowed_counter.h"
+#include "word_filter.h"
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
-#include <omp.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
 
 /**
  * @brief Main driver program for parallel word counter
  *
- * Usage: parallel_counter <input_file> [output_file] [top_n] [num_threads]
+ * Usage: parallel_counter <input_file> [output_file] [top_n] [num_threads] [sync_mode] [--option value ...]
+ *
+ * Options:
+ *   --window <seconds>   Sliding-window mode over a timestamped log stream ("-" reads stdin)
+ *   --buckets <n>        Buckets per window (default 12)
+ *   --corpus             Treat the input as a corpus (directory or @list file) and report TF, DF and TF-IDF
+ *   --tfidf-top <k>      TF-IDF terms kept per document (default 10)
+ *   --async-io <n>       Corpus mode: co_await reads on n I/O threads, overlapping them with counting
+ *   --in-flight <n>      Corpus mode with --async-io: files in flight at once (default 256)
+ *   --cooccur <w>        Count word pairs co-occurring within a window of w tokens
+ *   --grep <literal>     Fixed-string search: matching lines with line numbers and match counts
+ *   --regex <pattern>    Regex search (ERE subset, lazy DFA): matching lines with line numbers
+ *   --patterns <file>    Count every occurrence of each fixed string in file (one per line)
+ *   --pattern-engine <e> auto (default: teddy up to 64 patterns, else aho-corasick), teddy,
+ *                        or ac / aho-corasick
+ *   --index              Build a positional inverted index of the input; output_file is the index
+ *   --query <words>      Input is an index: positions of a word, or of a phrase of several words
+ *   --near <k>           With a two-word --query: positions of the first word within k words of the second
+ *   --build-line-index   Write a sidecar of line start offsets of the input to output_file
+ *   --stride <n>         Lines between recorded offsets in the line index (default 1024)
+ *   --lines <a:b>        Copy lines a..b of the input to output_file, seeking via the line index
+ *   --line-index <file>  Line index for --lines (default <input_file>.lidx; scanned if missing or stale)
+ *   --build-summary      Write per-block word count summaries of the input to output_file
+ *   --block-bytes <n>    Block size for --build-summary (default 4194304)
+ *   --range <a:b>        Top words of bytes [a, b) of the input, from block summaries
+ *   --range-lines <a:b>  Top words of lines a..b of the input (line offsets from the line index)
+ *   --summary <file>     Summary for --range/--range-lines (default <input_file>.bsum; range scanned if missing or stale)
+ *   --fuzzy <words>      After counting, list vocabulary words within --max-edits of each query
+ *                        (comma-separated, or @file with one per line) instead of the top words
+ *   --max-edits <k>      Levenshtein distance for --fuzzy (default 2)
+ *   --phases <file>      Also write the phase timing (wall/CPU per phase and thread) as JSON to file
+ *   --perf               Read hardware counters (cycles, instructions, cache/TLB/branch misses) per
+ *                        phase and thread via perf_event_open; reported as unavailable if they cannot be opened
+ *   --trace <file>       Write a per-thread timeline of phases and pipeline chunks/batches as Chrome
+ *                        Trace Event JSON (chrome://tracing, Perfetto)
+ *   --memory             Report peak RSS, heap allocations and bytes, and the footprint of each table
+ *                        (rawWords, per-thread localMaps, merged wordFreq) per phase
+ *   --exclude-words <file> Drop the listed words (e.g. stopwords) before counting
+ *   --include-words <file> Count only the listed words
+ *   --executor <name>    Counting scheduler: omp (default), ws (work-stealing std::threads),
+ *                        numa (node-pinned threads, first-touch input, per-node tables)
+ *                        or pipeline (read -> tokenize -> count stages over SPSC rings)
+ *   --grain <bytes>      Largest work-stealing task before it is split / pipeline read block (default 262144)
+ *   --stages <r:t:c>     Pipeline reader, tokenizer and counter threads (default derived from threads)
+ *   --autotune           Time short calibration runs on a sample of the input, use the fastest
+ *                        threads/sync/executor/grain and save them to the host profile
+ *   --tune-sample <bytes> Sample size for --autotune (default 8388608)
+ *   --profile <path>     Host profile to load or save (default ~/.parallel_grepper/profile-<host>.txt);
+ *                        a saved profile supplies every setting not given explicitly; "none" ignores it
+ *   --affinity <policy>  Thread placement: auto (default; physical cores first, from sysfs),
+ *                        compact, scatter, cores (physical cores only), none (OS) or a CPU list "0,2,4-7"
  */
 static WordCounterParallel::SyncMethod parseSyncMethod(const std::string& s) {
     if (s == "critical") return WordCounterParallel::SyncMethod::Critical;
@@ -15,18 +89,830 @@ static WordCounterParallel::SyncMethod parseSyncMethod(const std::string& s) {
     return WordCounterParallel::SyncMethod::Reduction;
 }
 
+struct CliArgs {
+    std::vector<std::string> positional;
+    std::map<std::string, std::string> options;
+
+    std::string option(const std::string& name, const std::string& fallback = "") const {
+        auto it = options.find(name);
+        return it == options.end() ? fallback : it->second;
+    }
+    bool has(const std::string& name) const { return options.count(name) > 0; }
+};
+
+// Options that take no value.
+static const std::set<std::string> kFlagOptions = {"corpus",        "autotune", "index", "build-line-index",
+                                                   "build-summary", "perf",     "memory"};
+
+// Options that take a non-negative integer, with the largest value each accepts.
+static const std::map<std::string, unsigned long long> kNumericOptions = {
+    {"tune-sample", ULLONG_MAX}, {"grain", ULLONG_MAX},     {"window", LLONG_MAX},  {"buckets", ULONG_MAX},
+    {"tfidf-top", ULONG_MAX},    {"async-io", INT_MAX},     {"in-flight", ULONG_MAX}, {"cooccur", ULONG_MAX},
+    {"stride", ULLONG_MAX},      {"block-bytes", ULLONG_MAX}, {"near", ULLONG_MAX},   {"max-edits", INT_MAX}};
+
+/** @brief Whole string is a decimal number no larger than `max`. */
+static bool parseNumber(const std::string& s, unsigned long long& value, unsigned long long max = ULLONG_MAX) {
+    const char* end = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), end, value);
+    return !s.empty() && ec == std::errc() && ptr == end && value <= max;
+}
+
+static bool parseArgs(int argc, char* argv[], CliArgs& args) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            std::string name = arg.substr(2);
+            if (kFlagOptions.count(name)) {
+                args.options[name] = "1";
+            } else if (i + 1 < argc) {
+                args.options[name] = argv[++i];
+            } else {
+                std::cerr << "Error: option --" << name << " needs a value\n";
+                return false;
+            }
+        } else {
+            args.positional.push_back(arg);
+        }
+    }
+
+    // Validate numbers here so a typo is a usage error, not an uncaught exception later.
+    unsigned long long value = 0;
+    for (const auto& [name, max] : kNumericOptions) {
+        if (args.has(name) && !parseNumber(args.option(name), value, max)) {
+            std::cerr << "Error: --" << name << " needs a non-negative integer, got '" << args.option(name) << "'\n";
+            return false;
+        }
+    }
+    const char* positionalNames[] = {"top_n", "num_threads"};
+    for (size_t i = 2; i < 4 && i < args.positional.size(); ++i) {
+        if (!parseNumber(args.positional[i], value, INT_MAX)) {
+            std::cerr << "Error: " << positionalNames[i - 2] << " needs a non-negative integer, got '"
+                      << args.positional[i] << "'\n";
+            return false;
+        }
+    }
+    if (args.has("stages")) {
+        std::stringstream spec(args.option("stages"));
+        std::string part;
+        while (std::getline(spec, part, ':')) {
+            if (!part.empty() && !parseNumber(part, value, INT_MAX)) {
+                std::cerr << "Error: --stages needs readers:tokenizers:counters, got '" << args.option("stages") << "'\n";
+                return false;
+            }
+        }
+    }
+    return !args.positional.empty();
+}
+
+static void printTopWords(const std::vector<std::pair<std::string, unsigned long long>>& topWords) {
+    int rank = 1;
+    for (const auto& [word, freq] : topWords) {
+        std::cout << std::right << std::setw(3) << rank++ << ". "
+                  << std::left << std::setw(20) << word
+                  << std::right << std::setw(10) << freq << "\n";
+    }
+}
+
+/**
+ * @brief Stream a log file (or stdin) through a WindowedWordCounter, emitting
+ *        the window top-N every time a bucket closes.
+ */
+static int runWindowedMode(const std::string& inputFile, const std::string& outputFile, int topN,
+                           long long windowSeconds, size_t buckets, WordCounterParallel::SyncMethod mode) {
+    std::ifstream file;
+    if (inputFile != "-") {
+        file.open(inputFile);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file " << inputFile << std::endl;
+            return 1;
+        }
+    }
+    std::istream& in = (inputFile == "-") ? std::cin : file;
+
+    std::ofstream outFile(outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Cannot create output file " << outputFile << std::endl;
+        return 1;
+    }
+
+    WindowedWordCounter window(windowSeconds, buckets, mode);
+    std::cout << "Bucket Width: " << window.getBucketSeconds() << " s\n";
+    std::cout << "-------------------------------------------\n";
+
+    size_t emits = 0;
+    auto emit = [&]() {
+        auto top = window.getTopWords(static_cast<size_t>(topN));
+        std::cout << "\nWindow [" << window.getWindowStart() << ", " << window.getWindowEnd() << ")"
+                  << "  words=" << window.getWindowTotal()
+                  << "  changed keys=" << window.getLastChangedKeys()
+                  << "  update=" << std::fixed << std::setprecision(2) << window.getLastUpdateTime() << " ms\n";
+        printTopWords(window.getTopWords(std::min<size_t>(10, static_cast<size_t>(topN))));
+
+        outFile << "Window " << window.getWindowStart() << " " << window.getWindowEnd()
+                << " total=" << window.getWindowTotal() << "\n";
+        for (const auto& [w, freq] : top) {
+            outFile << std::left << std::setw(30) << w << std::right << std::setw(15) << freq << "\n";
+        }
+        outFile << "\n";
+        ++emits;
+    };
+
+    std::string line;
+    std::string rest;
+    long long timestamp = 0;
+    bool haveTimestamp = false;
+    // Lines before the first timestamp (headers) wait for it, so the first
+    // bucket starts at the log's own time rather than the wall clock.
+    std::vector<std::string> pending;
+    while (std::getline(in, line)) {
+        if (WindowedWordCounter::parseTimestamp(line, timestamp, rest)) {
+            haveTimestamp = true;
+            for (const auto& early : pending) window.addLine(timestamp, early);
+            pending.clear();
+        } else if (!haveTimestamp) {
+            pending.push_back(line);
+            continue;
+        } else {
+            // Untimestamped lines (continuations, "404 not found") keep the
+            // last timestamp seen.
+            rest = line;
+        }
+        if (window.addLine(timestamp, rest)) {
+            emit();
+        }
+    }
+    // No timestamp at all: the whole input is one window at time 0.
+    for (const auto& early : pending) window.addLine(0, early);
+    if (window.flush()) {
+        emit();
+    }
+
+    std::cout << "\nWindows emitted: " << emits << "\n";
+    std::cout << "Results saved to: " << outputFile << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Corpus analytics: TF and DF over every document plus per-document
+ *        top TF-IDF terms, in one parallel scan.
+ */
+static int runCorpusMode(const std::string& corpusSpec, const std::string& outputFile, int topN, size_t tfidfTop,
+                         int ioThreads, size_t maxInFlight) {
+    auto files = CorpusAnalyzer::listCorpus(corpusSpec);
+    std::cout << "Documents: " << files.size() << "\n";
+
+    CorpusAnalyzer analyzer(tfidfTop);
+    if (ioThreads > 0) {
+        analyzer.setAsyncIo(ioThreads, maxInFlight);
+        std::cout << "I/O: coroutines (" << ioThreads << " I/O threads, up to " << maxInFlight << " files in flight)\n";
+    }
+    std::cout << "-------------------------------------------\n";
+
+    std::cout << "Processing corpus...\n";
+    if (!analyzer.analyze(files)) {
+        std::cerr << "Error: No documents processed!\n";
+        return 1;
+    }
+
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Documents:       " << analyzer.getDocumentCount() << "\n";
+    std::cout << "Total Words:     " << analyzer.getTotalWords() << "\n";
+    std::cout << "Unique Words:    " << analyzer.getUniqueWords() << "\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(2)
+              << analyzer.getExecutionTime() << " ms\n";
+    if (analyzer.isAsyncIo()) {
+        const auto& io = analyzer.getIoStats();
+        std::cout << "Read Time:       " << io.readTime << " ms (summed over I/O threads)\n";
+        std::cout << "Compute Time:    " << io.computeTime << " ms (summed over workers)\n";
+        std::cout << "Peak In Flight:  " << io.peakInFlight << " files\n";
+    }
+
+    std::cout << "\nSaving results...\n";
+    analyzer.saveResults(outputFile, topN);
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Windowed co-occurrence counts over interned word IDs.
+ */
+static int runCooccurrenceMode(const std::string& inputFile, const std::string& outputFile, int topN, size_t window) {
+    std::cout << "Co-occurrence Window: " << window << " tokens\n";
+    std::cout << "-------------------------------------------\n";
+
+    CooccurrenceCounter counter(window);
+    std::cout << "Processing file...\n";
+    if (!counter.countFromFile(inputFile) || counter.getTotalWords() == 0) {
+        std::cerr << "Error: No words processed!\n";
+        return 1;
+    }
+
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Total Words:     " << counter.getTotalWords() << "\n";
+    std::cout << "Vocabulary:      " << counter.getVocabulary().size() << "\n";
+    std::cout << "Unique Pairs:    " << counter.getUniquePairs() << "\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(2)
+              << counter.getExecutionTime() << " ms\n";
+
+    std::cout << "\nTop " << std::min(10, topN) << " Pairs:\n";
+    std::cout << "-------------------------------------------\n";
+    int rank = 1;
+    for (const auto& [key, count] : counter.getTopPairs(std::min(10, topN))) {
+        auto [a, b] = CooccurrenceCounter::unpackPair(key);
+        std::cout << std::right << std::setw(3) << rank++ << ". "
+                  << std::left << std::setw(30) << (counter.getVocabulary()[a] + " " + counter.getVocabulary()[b])
+                  << std::right << std::setw(10) << count << "\n";
+    }
+
+    std::cout << "\nSaving results...\n";
+    counter.saveResults(outputFile, topN);
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Fixed-string search, one file scanned by all threads.
+ */
+static int runGrepMode(const std::string& inputFile, const std::string& outputFile, int topN,
+                       const std::string& pattern) {
+    if (pattern.empty() || pattern.find('\n') != std::string::npos) {
+        std::cerr << "Error: --grep needs a non-empty single-line pattern\n";
+        return 1;
+    }
+    std::cout << "Pattern: \"" << pattern << "\" (" << simd::kernelName() << " scan)\n";
+    std::cout << "-------------------------------------------\n";
+
+    LiteralGrep grep(pattern);
+    std::cout << "Searching file...\n";
+    if (!grep.searchFile(inputFile)) {
+        return 1;
+    }
+
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Total Lines:     " << grep.getTotalLines() << "\n";
+    std::cout << "Matching Lines:  " << grep.getMatches().size() << "\n";
+    std::cout << "Matches:         " << grep.getMatchCount() << "\n";
+    std::cout << "Chunks:          " << grep.getChunkCount() << "\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(2)
+              << grep.getExecutionTime() << " ms\n";
+
+    size_t shown = std::min<size_t>(static_cast<size_t>(std::max(0, std::min(10, topN))), grep.getMatches().size());
+    std::cout << "\nFirst " << shown << " Matching Lines:\n";
+    std::cout << "-------------------------------------------\n";
+    for (size_t i = 0; i < shown; ++i) {
+        const auto& m = grep.getMatches()[i];
+        std::string_view text = grep.line(m);
+        std::cout << std::right << std::setw(8) << m.lineNumber << ": " << text.substr(0, 100)
+                  << (text.size() > 100 ? "..." : "") << "\n";
+    }
+
+    std::cout << "\nSaving results...\n";
+    grep.saveResults(outputFile);
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Regex search: lazy DFA per thread, literal prefilter when possible.
+ */
+static int runRegexMode(const std::string& inputFile, const std::string& outputFile, int topN,
+                        const std::string& pattern) {
+    RegexGrep grep(pattern);
+    if (!grep.isValid()) {
+        std::cerr << "Error: Bad --regex pattern: " << grep.getError() << "\n";
+        return 1;
+    }
+    std::cout << "Regex: \"" << pattern << "\"\n";
+    std::cout << "Prefilter: "
+              << (grep.getRequiredLiteral().empty() ? std::string("none")
+                                                    : "\"" + grep.getRequiredLiteral() + "\" (" + simd::kernelName() + ")")
+              << "\n";
+    std::cout << "-------------------------------------------\n";
+
+    std::cout << "Searching file...\n";
+    if (!grep.searchFile(inputFile)) {
+        return 1;
+    }
+
+    const auto& stats = grep.getStats();
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Total Lines:     " << grep.getTotalLines() << "\n";
+    std::cout << "Matching Lines:  " << grep.getMatches().size() << "\n";
+    std::cout << "Lines Scanned:   " << stats.linesScanned << " (by the DFA)\n";
+    std::cout << "DFA States:      " << stats.dfaStates << " (" << stats.cacheFlushes << " cache flushes)\n";
+    std::cout << "Chunks:          " << grep.getChunkCount() << "\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(2)
+              << grep.getExecutionTime() << " ms\n";
+
+    size_t shown = std::min<size_t>(static_cast<size_t>(std::max(0, std::min(10, topN))), grep.getMatches().size());
+    std::cout << "\nFirst " << shown << " Matching Lines:\n";
+    std::cout << "-------------------------------------------\n";
+    for (size_t i = 0; i < shown; ++i) {
+        const auto& m = grep.getMatches()[i];
+        std::string_view text = grep.line(m);
+        std::cout << std::right << std::setw(8) << m.lineNumber << ": " << text.substr(0, 100)
+                  << (text.size() > 100 ? "..." : "") << "\n";
+    }
+
+    std::cout << "\nSaving results...\n";
+    grep.saveResults(outputFile);
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Per-pattern occurrence counts for a set of fixed strings.
+ */
+static int runPatternMode(const std::string& inputFile, const std::string& outputFile, int topN,
+                          const std::string& patternFile, const std::string& engineName) {
+    auto engine = MultiPatternMatcher::Engine::Auto;
+    if (!MultiPatternMatcher::parseEngine(engineName, engine)) {
+        std::cerr << "Error: Unknown --pattern-engine '" << engineName << "' (auto, teddy, ac or aho-corasick)\n";
+        return 1;
+    }
+    std::vector<std::string> patterns;
+    if (!MultiPatternMatcher::loadPatterns(patternFile, patterns) || patterns.empty()) {
+        std::cerr << "Error: Cannot read patterns from " << patternFile << "\n";
+        return 1;
+    }
+
+    MultiPatternMatcher matcher(std::move(patterns), engine);
+    std::cout << "Patterns: " << matcher.getPatterns().size() << " ("
+              << MultiPatternMatcher::engineName(matcher.getEngine()) << ")\n";
+    std::cout << "-------------------------------------------\n";
+
+    std::cout << "Searching file...\n";
+    if (!matcher.countFile(inputFile)) {
+        return 1;
+    }
+
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Total Matches:   " << matcher.getTotalMatches() << "\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(2)
+              << matcher.getExecutionTime() << " ms\n";
+    std::cout << "Throughput:      "
+              << (matcher.getExecutionTime() > 0.0
+                      ? matcher.getBytesScanned() / (1024.0 * 1024.0) / (matcher.getExecutionTime() / 1000.0)
+                      : 0.0)
+              << " MB/s\n";
+
+    std::cout << "\nTop " << std::min(10, topN) << " Patterns:\n";
+    std::cout << "-------------------------------------------\n";
+    printTopWords(WordCounterParallel::getTopWords(matcher.getCounts(), std::min(10, topN)));
+
+    std::cout << "\nSaving results...\n";
+    matcher.saveResults(outputFile, topN);
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Write the line-offset sidecar of the input to indexFile.
+ */
+static int runLineIndexMode(const std::string& inputFile, const std::string& indexFile, size_t stride) {
+    LineIndex index(stride);
+    std::cout << "Line Index: every " << index.getStride() << " lines (" << simd::kernelName() << " scan)\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Scanning file...\n";
+    if (!index.buildFromFile(inputFile)) {
+        return 1;
+    }
+
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Total Lines:     " << index.getTotalLines() << "\n";
+    std::cout << "Checkpoints:     " << index.getOffsets().size() << "\n";
+    std::cout << "Chunks:          " << index.getChunkCount() << "\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(2) << index.getExecutionTime() << " ms\n";
+    std::cout << "Throughput:      "
+              << (index.getExecutionTime() > 0.0
+                      ? index.getSourceBytes() / (1024.0 * 1024.0) / (index.getExecutionTime() / 1000.0)
+                      : 0.0)
+              << " MB/s\n";
+
+    std::cout << "\nSaving index...\n";
+    if (!index.save(indexFile)) {
+        return 1;
+    }
+    std::cout << "Index saved to: " << indexFile << std::endl;
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Copy lines first..last of the input to outputFile, seeking through
+ *        a line-offset sidecar (indexFile, or built in memory if unusable).
+ */
+static int runLineRangeMode(const std::string& inputFile, const std::string& outputFile, const std::string& range,
+                            const std::string& indexFile) {
+    unsigned long long first = 0;
+    unsigned long long last = 0;
+    size_t colon = range.find(':');
+    bool parsed = parseNumber(range.substr(0, colon), first);
+    if (colon == std::string::npos) {
+        last = first;
+    } else {
+        parsed = parsed && parseNumber(range.substr(colon + 1), last);
+    }
+    if (!parsed || first == 0 || last < first) {
+        std::cerr << "Error: --lines needs a 1-based range first:last\n";
+        return 1;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    LineIndex index;
+    if (index.load(indexFile) && index.matches(inputFile)) {
+        std::cout << "Line Index: " << indexFile << " (every " << index.getStride() << " lines)\n";
+    } else {
+        std::cout << "Line Index: " << indexFile << " missing or stale, scanning the input\n";
+        if (!index.buildFromFile(inputFile)) {
+            return 1;
+        }
+    }
+    std::vector<std::string> lines;
+    if (!index.readLines(inputFile, first, last, lines)) {
+        std::cerr << "Error: Cannot open file " << inputFile << std::endl;
+        return 1;
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Lines:           " << first << "-" << last << " (" << lines.size() << " returned)\n";
+    std::cout << "Start Offset:    " << index.checkpointFor(first).offset << " (nearest checkpoint)\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(3) << elapsed << " ms\n";
+
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create output file " << outputFile << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < lines.size(); ++i) out << first + i << ':' << lines[i] << '\n';
+    std::cout << "\nResults saved to: " << outputFile << std::endl;
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Write per-block word count summaries of the input to summaryFile.
+ */
+static int runSummaryMode(const std::string& inputFile, const std::string& summaryFile, size_t blockBytes) {
+    BlockSummary summary(blockBytes);
+    std::cout << "Block Summary: " << summary.getBlockBytes() << "-byte blocks\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Counting blocks...\n";
+    if (!summary.buildFromFile(inputFile)) {
+        return 1;
+    }
+
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Total Words:     " << summary.getTotalWords() << "\n";
+    std::cout << "Unique Words:    " << summary.getVocabularySize() << "\n";
+    std::cout << "Blocks:          " << summary.getBlockCount() << "\n";
+    std::cout << "Summary Bytes:   " << summary.getSummaryBytes() << " (all tree levels)\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(2) << summary.getExecutionTime() << " ms\n";
+
+    std::cout << "\nSaving summary...\n";
+    if (!summary.save(summaryFile)) {
+        return 1;
+    }
+    std::cout << "Summary saved to: " << summaryFile << std::endl;
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Top words of a byte range (--range a:b, b exclusive) or line range
+ *        (--range-lines a:b, inclusive) of the input, from block summaries.
+ */
+static int runRangeMode(const std::string& inputFile, const std::string& outputFile, int topN, const std::string& range,
+                        bool lines, const std::string& summaryFile, const std::string& lineIndexFile) {
+    size_t colon = range.find(':');
+    if (colon == std::string::npos) {
+        std::cerr << "Error: " << (lines ? "--range-lines" : "--range") << " needs first:last\n";
+        return 1;
+    }
+    unsigned long long first = 0;
+    unsigned long long last = 0;
+    if (!parseNumber(range.substr(0, colon), first) || !parseNumber(range.substr(colon + 1), last)) {
+        std::cerr << "Error: " << (lines ? "--range-lines" : "--range") << " needs first:last\n";
+        return 1;
+    }
+
+    BlockSummary summary;
+    if (summary.load(summaryFile) && summary.matches(inputFile)) {
+        std::cout << "Block Summary: " << summaryFile << " (" << summary.getBlockCount() << " blocks)\n";
+    } else {
+        summary = BlockSummary();
+        std::cout << "Block Summary: " << summaryFile << " missing or stale, scanning the range\n";
+    }
+
+    unsigned long long begin = first;
+    unsigned long long end = last;
+    if (lines) {
+        LineIndex index;
+        if (!index.load(lineIndexFile) || !index.matches(inputFile)) {
+            std::cout << "Line Index: " << lineIndexFile << " missing or stale, scanning the input\n";
+            if (!index.buildFromFile(inputFile)) {
+                return 1;
+            }
+        }
+        if (first == 0 || !index.lineOffset(inputFile, first, begin) || !index.lineOffset(inputFile, last + 1, end)) {
+            std::cerr << "Error: Cannot locate lines " << range << " in " << inputFile << "\n";
+            return 1;
+        }
+    }
+    std::cout << "Range: bytes [" << begin << ", " << end << ")\n";
+    std::cout << "-------------------------------------------\n";
+
+    BlockSummary::RangeResult result;
+    if (!summary.queryBytes(inputFile, begin, end, result)) {
+        std::cerr << "Error: Cannot open file " << inputFile << std::endl;
+        return 1;
+    }
+
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Total Words:     " << result.totalWords << "\n";
+    std::cout << "Unique Words:    " << result.counts.size() << "\n";
+    std::cout << "Summaries Used:  " << result.summariesUsed << "\n";
+    std::cout << "Bytes Rescanned: " << result.bytesRescanned << "\n";
+    std::cout << "Execution Time:  " << std::fixed << std::setprecision(3) << result.executionTime << " ms\n";
+
+    std::cout << "\nTop " << std::min(10, topN) << " Most Frequent Words:\n";
+    std::cout << "-------------------------------------------\n";
+    printTopWords(WordCounterParallel::getTopWords(result.counts, std::min(10, topN)));
+
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create output file " << outputFile << std::endl;
+        return 1;
+    }
+    out << "Range: bytes [" << begin << ", " << end << ")\n";
+    out << "Total Words: " << result.totalWords << "\n";
+    out << "Unique Words: " << result.counts.size() << "\n";
+    out << std::string(45, '-') << "\n";
+    for (const auto& [w, freq] : WordCounterParallel::getTopWords(result.counts, topN)) {
+        out << std::left << std::setw(30) << w << std::right << std::setw(15) << freq << "\n";
+    }
+    std::cout << "\nResults saved to: " << outputFile << std::endl;
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Build a positional inverted index of the input and write it to indexFile.
+ */
+static int runIndexMode(const std::string& inputFile, const std::string& indexFile, int topN) {
+    PositionalIndex index;
+    std::cout << "Indexing file...\n";
+    if (!index.buildFromFile(inputFile)) {
+        return 1;
+    }
+
+    std::cout << "\nStatistics:\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Total Words:     " << index.getTotalTokens() << "\n";
+    std::cout << "Unique Words:    " << index.getTerms().size() << "\n";
+    std::cout << "Postings Bytes:  " << index.getPostingsBytes() << " ("
+              << std::fixed << std::setprecision(2)
+              << (index.getTotalTokens() > 0 ? static_cast<double>(index.getPostingsBytes()) / index.getTotalTokens() : 0.0)
+              << " bytes/position)\n";
+    std::cout << "Chunks:          " << index.getChunkCount() << "\n";
+    std::cout << "Execution Time:  " << index.getExecutionTime() << " ms\n";
+    std::cout << "Throughput:      "
+              << (index.getExecutionTime() > 0.0
+                      ? index.getBytesIndexed() / (1024.0 * 1024.0) / (index.getExecutionTime() / 1000.0)
+                      : 0.0)
+              << " MB/s\n";
+
+    WordCounterParallel::WordMap counts;
+    for (const auto& term : index.getTerms()) counts.emplace(term.word, term.count);
+    std::cout << "\nTop " << std::min(10, topN) << " Most Frequent Words:\n";
+    std::cout << "-------------------------------------------\n";
+    printTopWords(WordCounterParallel::getTopWords(counts, std::min(10, topN)));
+
+    std::cout << "\nSaving index...\n";
+    if (!index.save(indexFile)) {
+        return 1;
+    }
+    std::cout << "Index saved to: " << indexFile << std::endl;
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Answer a word, phrase ("a b c") or proximity (two words, near > 0)
+ *        query from an index written by --index.
+ */
+static int runQueryMode(const std::string& indexFile, const std::string& outputFile, int topN,
+                        const std::string& query, unsigned long long near) {
+    std::vector<std::string> words;
+    std::istringstream fields(query);
+    for (std::string w; fields >> w;) words.push_back(w);
+    if (words.empty() || (near > 0 && words.size() != 2)) {
+        std::cerr << "Error: --query needs one or more words (exactly two with --near)\n";
+        return 1;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    PositionalIndex index;
+    if (!index.load(indexFile)) {
+        std::cerr << "Error: Cannot read index " << indexFile << "\n";
+        return 1;
+    }
+    double loadTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    startTime = std::chrono::high_resolution_clock::now();
+    std::vector<unsigned long long> hits = near > 0       ? index.near(words[0], words[1], near)
+                                           : words.size() == 1 ? index.positions(words[0])
+                                                               : index.phrase(words);
+    double queryTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    std::cout << "Query: \"" << query << "\" ("
+              << (near > 0 ? "within " + std::to_string(near) + " words" : words.size() == 1 ? "word" : "phrase") << ")\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Indexed Words:   " << index.getTotalTokens() << "\n";
+    std::cout << "Matches:         " << hits.size() << "\n";
+    std::cout << "Load Time:       " << std::fixed << std::setprecision(2) << loadTime << " ms\n";
+    std::cout << "Query Time:      " << std::setprecision(3) << queryTime << " ms\n";
+
+    size_t shown = std::min<size_t>(static_cast<size_t>(std::max(0, std::min(10, topN))), hits.size());
+    std::cout << "\nFirst " << shown << " Positions:\n";
+    std::cout << "-------------------------------------------\n";
+    for (size_t i = 0; i < shown; ++i) {
+        std::cout << std::right << std::setw(12) << hits[i] << "\n";
+    }
+
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create output file " << outputFile << std::endl;
+        return 1;
+    }
+    for (unsigned long long p : hits) out << p << '\n';
+    std::cout << "\nResults saved to: " << outputFile << std::endl;
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
+/**
+ * @brief Every counted word within maxEdits of each query, with its count,
+ *        looked up in parallel across queries.
+ */
+static int runFuzzyLookup(const WordCounterParallel::WordMap& wordFreq, const std::string& outputFile, int topN,
+                          const std::string& spec, int maxEdits) {
+    std::vector<std::string> queries;
+    if (!spec.empty() && spec[0] == '@') {
+        if (!WordFilter::loadWords(spec.substr(1), queries)) {
+            std::cerr << "Error: Cannot read query list " << spec.substr(1) << "\n";
+            return 1;
+        }
+    } else {
+        std::stringstream list(spec);
+        for (std::string q; std::getline(list, q, ',');) {
+            if (!q.empty()) queries.push_back(q);
+        }
+    }
+    if (queries.empty()) {
+        std::cerr << "Error: --fuzzy needs one or more words\n";
+        return 1;
+    }
+
+    FuzzyVocabulary vocabulary(wordFreq);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto results = vocabulary.lookupAll(queries, maxEdits);
+    double lookupTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    size_t totalMatches = 0;
+    for (const auto& matches : results) totalMatches += matches.size();
+    std::cout << "\nFuzzy Lookup (max " << maxEdits << " edits):\n";
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Queries:         " << queries.size() << "\n";
+    std::cout << "Matches:         " << totalMatches << "\n";
+    std::cout << "Build Time:      " << std::fixed << std::setprecision(2) << vocabulary.getBuildTime() << " ms\n";
+    std::cout << "Lookup Time:     " << std::setprecision(3) << lookupTime << " ms\n";
+
+    size_t shown = static_cast<size_t>(std::max(0, std::min(10, topN)));
+    for (size_t q = 0; q < queries.size() && q < shown; ++q) {
+        std::cout << "\n\"" << queries[q] << "\" (" << results[q].size() << " matches):\n";
+        for (size_t i = 0; i < results[q].size() && i < shown; ++i) {
+            const auto& m = results[q][i];
+            std::cout << std::right << std::setw(3) << m.distance << "  " << std::left << std::setw(20) << m.word
+                      << std::right << std::setw(10) << m.count << "\n";
+        }
+    }
+
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create output file " << outputFile << std::endl;
+        return 1;
+    }
+    for (size_t q = 0; q < queries.size(); ++q) {
+        out << "Query " << queries[q] << " matches=" << results[q].size() << "\n";
+        for (const auto& m : results[q]) {
+            out << std::left << std::setw(30) << m.word << std::right << std::setw(15) << m.count
+                << std::setw(5) << m.distance << "\n";
+        }
+        out << "\n";
+    }
+    std::cout << "\nResults saved to: " << outputFile << std::endl;
+
+    std::cout << "\nProcessing complete!\n";
+    std::cout << "===========================================\n";
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file> [output_file] [top_n] [num_threads]\n";
+    CliArgs args;
+    if (!parseArgs(argc, argv, args)) {
+        std::cerr << "Usage: " << argv[0] << " <input_file> [output_file] [top_n] [num_threads] [sync_mode] [--option value ...]\n";
         std::cerr << "Example: " << argv[0] << " data/test_10mb.txt results/output.txt 100 4\n";
+        std::cerr << "Window:  " << argv[0] << " logs/app.log results/window.txt 20 4 --window 300 --buckets 30\n";
+        std::cerr << "Corpus:  " << argv[0] << " data/corpus results/corpus.txt 100 8 --corpus --tfidf-top 10\n";
+        std::cerr << "Pairs:   " << argv[0] << " data/test_10mb.txt results/pairs.txt 100 8 --cooccur 5\n";
+        std::cerr << "Grep:    " << argv[0] << " data/test_10mb.txt results/grep.txt 10 8 --grep needle\n";
+        std::cerr << "Regex:   " << argv[0] << " logs/app.log results/regex.txt 10 8 --regex \"ERROR [0-9]+ ms$\"\n";
+        std::cerr << "Multi:   " << argv[0] << " logs/app.log results/iocs.txt 100 8 --patterns iocs.txt\n";
+        std::cerr << "Lines:   " << argv[0] << " logs/app.log logs/app.log.lidx 10 8 --build-line-index\n";
+        std::cerr << "         " << argv[0] << " logs/app.log results/lines.txt 10 8 --lines 1000000:1000020\n";
+        std::cerr << "Ranges:  " << argv[0] << " logs/app.log logs/app.log.bsum 10 8 --build-summary\n";
+        std::cerr << "         " << argv[0] << " logs/app.log results/range.txt 10 8 --range-lines 1000000:2000000\n";
+        std::cerr << "Fuzzy:   " << argv[0] << " data/test_10mb.txt results/fuzzy.txt 10 8 --fuzzy recieve,teh --max-edits 2\n";
+        std::cerr << "Index:   " << argv[0] << " data/test_10mb.txt results/test.pidx 10 8 --index\n";
+        std::cerr << "Query:   " << argv[0] << " results/test.pidx results/hits.txt 10 8 --query \"of the\"\n";
         return 1;
     }
 
-    std::string inputFile = argv[1];
-    std::string outputFile = (argc > 2) ? argv[2] : "results/parallel/output.txt";
-    int topN = (argc > 3) ? std::stoi(argv[3]) : 100;
-    int numThreads = (argc > 4) ? std::stoi(argv[4]) : 0;
-    std::string syncModeStr = (argc > 5) ? argv[5] : "reduction";
+    const auto& pos = args.positional;
+    std::string inputFile = pos[0];
+    std::string outputFile = (pos.size() > 1) ? pos[1] : "results/parallel/output.txt";
+    int topN = (pos.size() > 2) ? std::stoi(pos[2]) : 100;
+    int numThreads = (pos.size() > 3) ? std::stoi(pos[3]) : 0;
+    std::string syncModeStr = (pos.size() > 4) ? pos[4] : "reduction";
+
+    // A host profile fills in whatever was not given on the command line.
+    std::string profilePath = args.option("profile", TuningProfile::defaultPath());
+    TuningProfile profile;
+    bool haveProfile = false;
+    if (args.has("autotune")) {
+        size_t sampleBytes = static_cast<size_t>(std::stoull(args.option("tune-sample", "8388608")));
+        Autotuner tuner(sampleBytes);
+        std::cout << "Autotuning on the first " << sampleBytes << " bytes of " << inputFile << "...\n";
+        if (!tuner.tune(inputFile, numThreads, profile)) {
+            std::cerr << "Error: Cannot autotune on " << inputFile << "\n";
+            return 1;
+        }
+        std::cout << std::right << std::setw(8) << "Threads" << std::setw(11) << "Sync" << std::setw(10) << "Executor"
+                  << std::setw(10) << "Grain" << std::setw(12) << "Best ms" << "\n";
+        for (const auto& trial : tuner.getTrials()) {
+            std::cout << std::setw(8) << trial.config.threads << std::setw(11) << trial.config.sync
+                      << std::setw(10) << trial.config.executor << std::setw(10) << trial.config.grain
+                      << std::setw(12) << std::fixed << std::setprecision(2) << trial.time << "\n";
+        }
+        if (profilePath == "none") {
+            // Tune for this run only.
+        } else if (profile.save(profilePath)) {
+            std::cout << "Profile saved to: " << profilePath << "\n";
+        } else {
+            std::cerr << "Warning: Cannot write profile " << profilePath << "\n";
+        }
+        haveProfile = true;
+    } else if (profilePath != "none") {
+        haveProfile = profile.load(profilePath) && profile.host == TuningProfile::hostName();
+    }
+    if (haveProfile) {
+        if (pos.size() <= 3) numThreads = profile.threads;
+        if (pos.size() <= 4) syncModeStr = profile.sync;
+        if (!args.has("executor")) args.options["executor"] = profile.executor;
+        if (!args.has("grain")) args.options["grain"] = std::to_string(profile.grain);
+    }
     auto mode = parseSyncMethod(syncModeStr);
 
     if (numThreads > 0) {
@@ -34,17 +920,137 @@ int main(int argc, char* argv[]) {
     }
 
     std::cout << "===========================================\n";
-    std::cout << "  Parallel Word Frequency Counter (OpenMP)\n";
+    std::cout << "  Parallel Word Frequency Counter (" << WordCounterParallel::runtimeName() << ")\n";
     std::cout << "===========================================\n";
     std::cout << "Input File: " << inputFile << "\n";
     std::cout << "Output File: " << outputFile << "\n";
     std::cout << "Top N Words: " << topN << "\n";
     std::cout << "Threads: " << omp_get_max_threads() << "\n";
     std::cout << "Sync Mode: " << syncModeStr << "\n";
-    std::cout << "-------------------------------------------\n";
+    if (haveProfile) {
+        std::cout << "Profile: " << profilePath << " (" << profile.executor << ", " << profile.threads
+                  << " threads, grain " << profile.grain << ")\n";
+    }
+    std::string executorName = args.option("executor", "omp");
+
+    topology::Placement placement;
+    std::vector<int> explicitCpus;
+    std::string affinity = args.option("affinity", "auto");
+    if (!topology::parsePlacement(affinity, placement, explicitCpus)) {
+        std::cerr << "Error: Unknown --affinity policy '" << affinity << "'\n";
+        return 1;
+    }
+    std::vector<int> cpuPlan = topology::planPlacement(placement, omp_get_max_threads(), explicitCpus);
+    std::cout << "Placement: " << topology::placementName(placement) << " -> "
+              << topology::describePlan(cpuPlan) << "\n";
+    // Applied per parallel region (and by the counting engine through
+    // setThreadPlacement), never to this thread for the rest of the run.
+    pg_runtime::setPlacement(cpuPlan);
+
+    if (args.has("window")) {
+        long long windowSeconds = std::stoll(args.option("window"));
+        size_t buckets = static_cast<size_t>(std::stoul(args.option("buckets", "12")));
+        std::cout << "Window: " << windowSeconds << " s in " << buckets << " buckets\n";
+        return runWindowedMode(inputFile, outputFile, topN, windowSeconds, buckets, mode);
+    }
+    if (args.has("corpus")) {
+        size_t tfidfTop = static_cast<size_t>(std::stoul(args.option("tfidf-top", "10")));
+        int ioThreads = std::stoi(args.option("async-io", "0"));
+        size_t maxInFlight = static_cast<size_t>(std::stoul(args.option("in-flight", "256")));
+        return runCorpusMode(inputFile, outputFile, topN, tfidfTop, ioThreads, maxInFlight);
+    }
+    if (args.has("cooccur")) {
+        return runCooccurrenceMode(inputFile, outputFile, topN, static_cast<size_t>(std::stoul(args.option("cooccur"))));
+    }
+    if (args.has("grep")) {
+        return runGrepMode(inputFile, outputFile, topN, args.option("grep"));
+    }
+    if (args.has("regex")) {
+        return runRegexMode(inputFile, outputFile, topN, args.option("regex"));
+    }
+    if (args.has("patterns")) {
+        return runPatternMode(inputFile, outputFile, topN, args.option("patterns"), args.option("pattern-engine", "auto"));
+    }
+    if (args.has("build-line-index")) {
+        return runLineIndexMode(inputFile, outputFile,
+                                static_cast<size_t>(std::stoull(args.option("stride", std::to_string(LineIndex::kDefaultStride)))));
+    }
+    if (args.has("lines")) {
+        return runLineRangeMode(inputFile, outputFile, args.option("lines"), args.option("line-index", inputFile + ".lidx"));
+    }
+    if (args.has("build-summary")) {
+        return runSummaryMode(inputFile, outputFile,
+                              static_cast<size_t>(std::stoull(args.option("block-bytes", std::to_string(BlockSummary::kDefaultBlockBytes)))));
+    }
+    if (args.has("range") || args.has("range-lines")) {
+        bool lines = args.has("range-lines");
+        return runRangeMode(inputFile, outputFile, topN, args.option(lines ? "range-lines" : "range"), lines,
+                            args.option("summary", inputFile + ".bsum"), args.option("line-index", inputFile + ".lidx"));
+    }
+    if (args.has("index")) {
+        return runIndexMode(inputFile, outputFile, topN);
+    }
+    if (args.has("query")) {
+        return runQueryMode(inputFile, outputFile, topN, args.option("query"), std::stoull(args.option("near", "0")));
+    }
 
     // Create word counter instance
     WordCounterParallel counter(mode);
+    counter.setThreadPlacement(cpuPlan);
+    counter.getPhaseTimer().setCounters(args.has("perf"));
+    if (args.has("memory")) {
+        MemoryReport::startCounting();
+        counter.getMemoryReport().setEnabled(true);
+    }
+    if (args.has("trace")) {
+        TraceRecorder::start("parallel_counter");
+        TraceRecorder::nameThread("main");
+    }
+    if (args.has("exclude-words") || args.has("include-words")) {
+        if (args.has("exclude-words") && args.has("include-words")) {
+            std::cerr << "Error: --exclude-words and --include-words are mutually exclusive\n";
+            return 1;
+        }
+        bool include = args.has("include-words");
+        std::string listFile = args.option(include ? "include-words" : "exclude-words");
+        std::vector<std::string> words;
+        if (!WordFilter::loadWords(listFile, words)) {
+            std::cerr << "Error: Cannot read word list " << listFile << "\n";
+            return 1;
+        }
+        auto filter = std::make_shared<const WordFilter>(
+            words, include ? WordFilter::Mode::Include : WordFilter::Mode::Exclude);
+        std::cout << "Word Filter: " << (include ? "include " : "exclude ") << filter->size()
+                  << " words from " << listFile << "\n";
+        counter.setWordFilter(filter);
+    }
+    if (executorName == "ws") {
+        size_t grain = static_cast<size_t>(std::stoull(args.option("grain", "262144")));
+        counter.setExecutor(WordCounterParallel::Executor::WorkStealing,
+                            numThreads > 0 ? numThreads : omp_get_max_threads(), grain);
+        std::cout << "Executor: work-stealing (grain " << grain << " bytes)\n";
+    } else if (executorName == "numa") {
+        counter.setExecutor(WordCounterParallel::Executor::Numa,
+                            numThreads > 0 ? numThreads : omp_get_max_threads());
+        std::cout << "Executor: numa\n";
+    } else if (executorName == "pipeline") {
+        size_t grain = static_cast<size_t>(std::stoull(args.option("grain", "262144")));
+        counter.setExecutor(WordCounterParallel::Executor::Pipeline,
+                            numThreads > 0 ? numThreads : omp_get_max_threads(), grain);
+        if (args.has("stages")) {
+            int stages[3] = {0, 0, 0};
+            std::stringstream spec(args.option("stages"));
+            std::string part;
+            for (int i = 0; i < 3 && std::getline(spec, part, ':'); ++i) {
+                stages[i] = part.empty() ? 0 : std::stoi(part);
+            }
+            counter.setPipelineStages(stages[0], stages[1], stages[2]);
+        }
+        std::cout << "Executor: pipeline (block " << grain << " bytes)\n";
+    } else {
+        std::cout << "Executor: " << WordCounterParallel::runtimeName() << "\n";
+    }
+    std::cout << "-------------------------------------------\n";
 
     // Process file
     std::cout << "Processing file...\n";
@@ -58,31 +1064,105 @@ int main(int argc, char* argv[]) {
     // Display statistics
     std::cout << "\nStatistics:\n";
     std::cout << "-------------------------------------------\n";
-    std::cout << "Total Words:     " << counter.getTotalWords() << "\n";
+    std::cout << "Total Words:     " << counter.getTotalWords() + counter.getFilteredWords() << "\n";
+    if (counter.getWordFilter() != nullptr) {
+        std::cout << "Filtered Words:  " << counter.getFilteredWords() << "\n";
+        std::cout << "Kept Words:      " << counter.getTotalWords() << "\n";
+    }
     std::cout << "Unique Words:    " << counter.getUniqueWords() << "\n";
     std::cout << "Execution Time:  " << std::fixed << std::setprecision(2)
               << counter.getExecutionTime() << " ms\n";
     std::cout << "                 " << std::fixed << std::setprecision(4)
               << counter.getExecutionTime() / 1000.0 << " seconds\n";
 
+    if (counter.getExecutor() == WordCounterParallel::Executor::WorkStealing) {
+        const auto& stats = counter.getExecutorStats();
+        std::cout << "\nPer-Thread Scheduling (work-stealing):\n";
+        std::cout << "-------------------------------------------\n";
+        std::cout << std::right << std::setw(6) << "Thread" << std::setw(12) << "Busy ms"
+                  << std::setw(12) << "Idle ms" << std::setw(8) << "Tasks" << std::setw(8) << "Stolen" << "\n";
+        for (size_t t = 0; t < stats.busyTime.size(); ++t) {
+            std::cout << std::setw(6) << t << std::setw(12) << std::setprecision(2) << stats.busyTime[t]
+                      << std::setw(12) << stats.idleTime[t] << std::setw(8) << stats.tasksRun[t]
+                      << std::setw(8) << stats.tasksStolen[t] << "\n";
+        }
+    }
+
+    if (counter.getExecutor() == WordCounterParallel::Executor::Pipeline) {
+        const auto& stats = counter.getPipelineStats();
+        std::cout << "\nPipeline Stages:\n";
+        std::cout << "-------------------------------------------\n";
+        std::cout << std::right << std::setw(10) << "Stage" << std::setw(8) << "Threads" << std::setw(10) << "Items"
+                  << std::setw(12) << "Busy ms" << std::setw(12) << "Full stalls" << std::setw(12) << "Empty polls"
+                  << "\n";
+        auto printStage = [](const char* name, const PipelineCounter::StageStats& stage) {
+            std::cout << std::setw(10) << name << std::setw(8) << stage.threads << std::setw(10) << stage.items
+                      << std::setw(12) << std::setprecision(2) << stage.busyTime << std::setw(12) << stage.fullStalls
+                      << std::setw(12) << stage.emptyPolls << "\n";
+        };
+        printStage("read", stats.read);
+        printStage("tokenize", stats.tokenize);
+        printStage("count", stats.count);
+    }
+
+    if (counter.getExecutor() == WordCounterParallel::Executor::Numa) {
+        const auto& numa = counter.getNumaStats();
+        std::cout << "\nNUMA Placement (" << numa.nodeIds.size() << " node(s)):\n";
+        std::cout << "-------------------------------------------\n";
+        std::cout << std::right << std::setw(6) << "Thread" << std::setw(6) << "Node" << std::setw(6) << "CPU"
+                  << std::setw(12) << "Local pg" << std::setw(12) << "Remote pg" << "\n";
+        for (size_t t = 0; t < numa.threadNode.size(); ++t) {
+            std::cout << std::setw(6) << t << std::setw(6) << numa.threadNode[t] << std::setw(6) << numa.threadCpu[t]
+                      << std::setw(12) << numa.localPages[t] << std::setw(12) << numa.remotePages[t] << "\n";
+        }
+        if (numa.pageQueryAvailable) {
+            std::cout << "Remote Access Ratio: " << std::setprecision(2) << numa.remoteRatio * 100.0 << " %\n";
+        } else {
+            std::cout << "Remote Access Ratio: unavailable (page placement query not supported)\n";
+        }
+    }
+
+    if (args.has("fuzzy")) {
+        return runFuzzyLookup(wordFreq, outputFile, topN, args.option("fuzzy"), std::stoi(args.option("max-edits", "2")));
+    }
+
     // Display top words
     std::cout << "\nTop " << std::min(10, topN) << " Most Frequent Words:\n";
     std::cout << "-------------------------------------------\n";
-    auto topWords = counter.getTopWords(wordFreq, 10);
-
-    int rank = 1;
-    for (const auto& [word, freq] : topWords) {
-        std::cout << std::right << std::setw(3) << rank++ << ". "
-                  << std::left << std::setw(20) << word
-                  << std::right << std::setw(10) << freq << "\n";
+    {
+        PhaseTimer::Scope topKPhase(counter.getPhaseTimer(), PhaseTimer::TopK);
+        printTopWords(counter.getTopWords(wordFreq, 10));
     }
 
     // Save results
     std::cout << "\nSaving results...\n";
     counter.saveResults(wordFreq, outputFile, topN);
 
+    counter.getPhaseTimer().print(std::cout, counter.getTotalWords());
+    if (args.has("phases")) {
+        std::ofstream phases(args.option("phases"));
+        if (!phases.is_open()) {
+            std::cerr << "Error: Cannot create phase file " << args.option("phases") << std::endl;
+            return 1;
+        }
+        counter.getPhaseTimer().writeJson(phases, counter.getTotalWords());
+        std::cout << "Phase timing saved to: " << args.option("phases") << std::endl;
+    }
+    if (args.has("memory")) {
+        std::error_code ec;
+        auto inputBytes = std::filesystem::file_size(inputFile, ec);
+        counter.getMemoryReport().print(std::cout, ec ? 0 : static_cast<size_t>(inputBytes), counter.getUniqueWords(),
+                                        "wordFreq");
+    }
+    if (args.has("trace")) {
+        if (!TraceRecorder::write(args.option("trace"))) {
+            return 1;
+        }
+        std::cout << "Trace (" << TraceRecorder::spanCount() << " spans) saved to: " << args.option("trace") << std::endl;
+    }
+
     std::cout << "\nProcessing complete!\n";
     std::cout << "===========================================\n";
 
     return 0;
-}
\ No newline at end of file
+}
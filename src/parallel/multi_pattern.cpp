@@ -0,0 +1,349 @@
+#include "multi_pattern.h"
+#include "file_reader.h"
+#include "line_chunks.h"
+#include "parallel_runtime.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+constexpr bool kHaveShuffle = true;
+#else
+constexpr bool kHaveShuffle = false;
+#endif
+
+} // namespace
+
+MultiPatternMatcher::MultiPatternMatcher(std::vector<std::string> input, Engine requested) : engine(requested) {
+    input.erase(std::remove(input.begin(), input.end(), std::string()), input.end());
+    std::sort(input.begin(), input.end());
+    input.erase(std::unique(input.begin(), input.end()), input.end());
+    patterns = std::move(input);
+    counts.assign(patterns.size(), 0);
+    for (const auto& p : patterns) maxLength = std::max(maxLength, p.size());
+
+    if (engine == Engine::Auto) {
+        engine = (kHaveShuffle && !patterns.empty() && patterns.size() <= kMaxTeddyPatterns) ? Engine::Teddy
+                                                                                           : Engine::AhoCorasick;
+    }
+    if (engine == Engine::Teddy) {
+        buildTeddy();
+    } else {
+        buildAutomaton();
+    }
+}
+
+const char* MultiPatternMatcher::engineName(Engine engine) {
+    switch (engine) {
+        case Engine::Teddy: return kHaveShuffle ? "teddy" : "teddy (scalar)";
+        case Engine::AhoCorasick: return "aho-corasick";
+        default: return "auto";
+    }
+}
+
+bool MultiPatternMatcher::parseEngine(const std::string& name, Engine& engine) {
+    if (name == "auto") {
+        engine = Engine::Auto;
+    } else if (name == "teddy") {
+        engine = Engine::Teddy;
+    } else if (name == "ac" || name == "aho-corasick") {
+        engine = Engine::AhoCorasick;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool MultiPatternMatcher::loadPatterns(const std::string& filename, std::vector<std::string>& out) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) out.push_back(line);
+    }
+    return true;
+}
+
+void MultiPatternMatcher::buildTeddy() {
+    size_t minLength = patterns.empty() ? 1 : patterns.front().size();
+    for (const auto& p : patterns) minLength = std::min(minLength, p.size());
+    fingerprint = std::min<size_t>(3, minLength);
+
+    // Patterns are sorted, so contiguous runs share prefixes and a bucket's
+    // nibble masks stay sparse.
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        size_t b = i * 8 / patterns.size();
+        buckets[b].push_back(static_cast<std::uint32_t>(i));
+        for (size_t k = 0; k < fingerprint; ++k) {
+            auto byte = static_cast<unsigned char>(patterns[i][k]);
+            loMask[k][byte & 0x0f] |= static_cast<std::uint8_t>(1u << b);
+            hiMask[k][byte >> 4] |= static_cast<std::uint8_t>(1u << b);
+        }
+    }
+}
+
+void MultiPatternMatcher::buildAutomaton() {
+    // Byte classes: one per byte used by some pattern, class 0 for the rest.
+    // If all 256 byte values occur, the last one wraps to class 0, which is
+    // then otherwise unused.
+    bool used[256] = {};
+    for (const auto& p : patterns) {
+        for (char c : p) {
+            auto byte = static_cast<unsigned char>(c);
+            if (!used[byte]) {
+                used[byte] = true;
+                byteClass[byte] = static_cast<std::uint8_t>(numClasses++);
+            }
+        }
+    }
+    numClasses = std::min<size_t>(numClasses, 256);
+
+    // Trie; 0 marks a missing edge (the root is never a child).
+    std::vector<std::uint32_t> trie(numClasses, 0);
+    match.assign(1, -1);
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        std::uint32_t s = 0;
+        for (char c : patterns[id]) {
+            size_t slot = s * numClasses + byteClass[static_cast<unsigned char>(c)];
+            if (trie[slot] == 0) {
+                trie[slot] = static_cast<std::uint32_t>(match.size());
+                match.push_back(-1);
+                trie.resize(trie.size() + numClasses, 0);
+            }
+            s = trie[s * numClasses + byteClass[static_cast<unsigned char>(c)]];
+        }
+        match[s] = static_cast<std::int32_t>(id);
+    }
+
+    // BFS: fail links, output links and the completed DFA in one pass.
+    const size_t states = match.size();
+    delta.assign(states * numClasses, 0);
+    outLink.assign(states, -1);
+    outHead.assign(states, -1);
+    std::vector<std::uint32_t> fail(states, 0);
+    std::deque<std::uint32_t> queue;
+    for (size_t c = 0; c < numClasses; ++c) {
+        std::uint32_t child = trie[c];
+        delta[c] = child;
+        if (child != 0) queue.push_back(child);
+    }
+    while (!queue.empty()) {
+        std::uint32_t s = queue.front();
+        queue.pop_front();
+        std::uint32_t f = fail[s];
+        outLink[s] = match[f] >= 0 ? static_cast<std::int32_t>(f) : outLink[f];
+        outHead[s] = match[s] >= 0 ? static_cast<std::int32_t>(s) : outLink[s];
+        for (size_t c = 0; c < numClasses; ++c) {
+            std::uint32_t child = trie[s * numClasses + c];
+            if (child != 0) {
+                fail[child] = delta[f * numClasses + c];
+                delta[s * numClasses + c] = child;
+                queue.push_back(child);
+            } else {
+                delta[s * numClasses + c] = delta[f * numClasses + c];
+            }
+        }
+    }
+}
+
+void MultiPatternMatcher::scanTeddy(std::string_view text, size_t begin, size_t end,
+                                    std::vector<unsigned long long>& local) const {
+    const char* data = text.data();
+    const size_t n = text.size();
+    auto verify = [&](size_t pos, unsigned bucketBits) {
+        while (bucketBits != 0) {
+            int b = std::countr_zero(bucketBits);
+            bucketBits &= bucketBits - 1;
+            for (std::uint32_t id : buckets[b]) {
+                const std::string& p = patterns[id];
+                if (pos + p.size() <= n && std::memcmp(data + pos, p.data(), p.size()) == 0) {
+                    ++local[id];
+                }
+            }
+        }
+    };
+
+    size_t i = begin;
+#if defined(__AVX2__)
+    constexpr size_t kWidth = 32;
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i lo[3], hi[3];
+    for (size_t k = 0; k < fingerprint; ++k) {
+        lo[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(loMask[k])));
+        hi[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hiMask[k])));
+    }
+    alignas(32) std::uint8_t bits[kWidth];
+    for (; i + kWidth <= end && i + kWidth + fingerprint - 1 <= n; i += kWidth) {
+        __m256i res = _mm256_set1_epi8(static_cast<char>(0xff));
+        for (size_t k = 0; k < fingerprint; ++k) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + k));
+            __m256i l = _mm256_shuffle_epi8(lo[k], _mm256_and_si256(v, nibble));
+            __m256i h = _mm256_shuffle_epi8(hi[k], _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+            res = _mm256_and_si256(res, _mm256_and_si256(l, h));
+        }
+        auto candidates = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(res, _mm256_setzero_si256())));
+        if (candidates == 0) continue;
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bits), res);
+        while (candidates != 0) {
+            int j = std::countr_zero(candidates);
+            candidates &= candidates - 1;
+            verify(i + static_cast<size_t>(j), bits[j]);
+        }
+    }
+#elif defined(__SSSE3__)
+    constexpr size_t kWidth = 16;
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    __m128i lo[3], hi[3];
+    for (size_t k = 0; k < fingerprint; ++k) {
+        lo[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(loMask[k]));
+        hi[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hiMask[k]));
+    }
+    alignas(16) std::uint8_t bits[kWidth];
+    for (; i + kWidth <= end && i + kWidth + fingerprint - 1 <= n; i += kWidth) {
+        __m128i res = _mm_set1_epi8(static_cast<char>(0xff));
+        for (size_t k = 0; k < fingerprint; ++k) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + k));
+            __m128i l = _mm_shuffle_epi8(lo[k], _mm_and_si128(v, nibble));
+            __m128i h = _mm_shuffle_epi8(hi[k], _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+            res = _mm_and_si128(res, _mm_and_si128(l, h));
+        }
+        auto candidates = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(res, _mm_setzero_si128()))) & 0xffffu;
+        if (candidates == 0) continue;
+        _mm_store_si128(reinterpret_cast<__m128i*>(bits), res);
+        while (candidates != 0) {
+            int j = std::countr_zero(candidates);
+            candidates &= candidates - 1;
+            verify(i + static_cast<size_t>(j), bits[j]);
+        }
+    }
+#endif
+    // Tail (and the whole chunk without SSSE3): same masks, one position at a time.
+    for (; i < end; ++i) {
+        unsigned bucketBits = 0xff;
+        for (size_t k = 0; k < fingerprint && bucketBits != 0; ++k) {
+            if (i + k >= n) {
+                bucketBits = 0;
+                break;
+            }
+            auto byte = static_cast<unsigned char>(data[i + k]);
+            bucketBits &= loMask[k][byte & 0x0f] & hiMask[k][byte >> 4];
+        }
+        if (bucketBits != 0) verify(i, bucketBits);
+    }
+}
+
+void MultiPatternMatcher::scanAutomaton(std::string_view text, size_t begin, size_t end,
+                                        std::vector<unsigned long long>& local) const {
+    // Starting from the root at `begin` finds every match that starts at or
+    // after it; read on until the longest match starting before `end` ends.
+    const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+    const size_t stop = std::min(text.size(), end + maxLength - 1);
+    const std::uint32_t* table = delta.data();
+    const size_t classes = numClasses;
+    std::uint32_t s = 0;
+    for (size_t i = begin; i < stop; ++i) {
+        s = table[s * classes + byteClass[data[i]]];
+        for (std::int32_t t = outHead[s]; t >= 0; t = outLink[static_cast<size_t>(t)]) {
+            auto id = static_cast<size_t>(match[static_cast<size_t>(t)]);
+            if (i + 1 - patterns[id].size() < end) {
+                ++local[id];
+            }
+        }
+    }
+}
+
+bool MultiPatternMatcher::countFile(const std::string& filename) {
+    std::string contents;
+    if (!readWholeFile(filename, contents)) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+    countText(contents);
+    return true;
+}
+
+void MultiPatternMatcher::countText(std::string_view text) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::fill(counts.begin(), counts.end(), 0);
+    bytesScanned = text.size();
+
+    const size_t n = text.size();
+    const size_t threads = static_cast<size_t>(omp_get_max_threads());
+    const size_t chunks = chunksFor(n, threads);
+    const size_t chunkBytes = (n + chunks - 1) / chunks;
+
+    std::atomic<size_t> next{0};
+    std::mutex mergeLock;
+    if (!patterns.empty()) {
+        pg_runtime::parallelRegion([&](int, int) {
+            std::vector<unsigned long long> local(patterns.size(), 0);
+            for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+                size_t begin = std::min(n, c * chunkBytes);
+                size_t end = std::min(n, begin + chunkBytes);
+                if (engine == Engine::Teddy) {
+                    scanTeddy(text, begin, end, local);
+                } else {
+                    scanAutomaton(text, begin, end, local);
+                }
+            }
+            std::lock_guard<std::mutex> guard(mergeLock);
+            for (size_t id = 0; id < local.size(); ++id) counts[id] += local[id];
+        });
+    }
+    totalMatches = std::accumulate(counts.begin(), counts.end(), 0ULL);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+WordCounterParallel::WordMap MultiPatternMatcher::getCounts() const {
+    WordCounterParallel::WordMap map;
+    map.reserve(patterns.size());
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        map.emplace(patterns[id], counts[id]);
+    }
+    return map;
+}
+
+void MultiPatternMatcher::saveResults(const std::string& filename, int topN) const {
+    std::ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Cannot create output file " << filename << std::endl;
+        return;
+    }
+
+    outFile << "Multi-Pattern Match Results\n";
+    outFile << "================================\n";
+    outFile << "Engine: " << engineName(engine) << "\n";
+    outFile << "Patterns: " << patterns.size() << "\n";
+    outFile << "Total Matches: " << totalMatches << "\n";
+    outFile << "Execution Time: " << std::fixed << std::setprecision(2) << executionTime << " ms\n";
+    outFile << "================================\n\n";
+
+    outFile << std::left << std::setw(30) << "Pattern" << std::right << std::setw(15) << "Count" << "\n";
+    outFile << std::string(45, '-') << "\n";
+    for (const auto& [p, count] : WordCounterParallel::getTopWords(getCounts(), topN)) {
+        outFile << std::left << std::setw(30) << p << std::right << std::setw(15) << count << "\n";
+    }
+
+    outFile.close();
+    std::cout << "Results saved to: " << filename << std::endl;
+}
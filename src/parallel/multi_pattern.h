@@ -0,0 +1,91 @@
+#ifndef MULTI_PATTERN_H
+#define MULTI_PATTERN_H
+
+#include "word_counter_parallel.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Counts occurrences of many fixed strings at once, in parallel.
+ *
+ * Two engines behind one interface:
+ *  - Teddy (up to kMaxTeddyPatterns): patterns are spread over 8 buckets and
+ *    a SIMD nibble-mask shuffle over their first 1-3 bytes flags candidate
+ *    positions with a bucket bitmask; only flagged positions are verified.
+ *  - Aho-Corasick: a full DFA over byte classes (bytes that occur in no
+ *    pattern share one class), so the transition table stays narrow and one
+ *    lookup per input byte finds every pattern ending there.
+ *
+ * Every occurrence is counted, overlapping ones included. The input is cut
+ * into fixed-size chunks; a chunk owns the matches that *start* inside it and
+ * reads up to the longest pattern past its end, so matches straddling a
+ * chunk boundary are counted exactly once.
+ */
+class MultiPatternMatcher {
+public:
+    enum class Engine { Auto, Teddy, AhoCorasick };
+
+    static constexpr size_t kMaxTeddyPatterns = 64;
+
+    /**
+     * @param patterns Empty strings are dropped and duplicates merged
+     * @param engine Auto picks Teddy for small sets when SIMD shuffles are available
+     */
+    explicit MultiPatternMatcher(std::vector<std::string> patterns, Engine engine = Engine::Auto);
+
+    /** @brief One pattern per line (trailing '\r' stripped, blank lines skipped). */
+    static bool loadPatterns(const std::string& filename, std::vector<std::string>& patterns);
+
+    /** @return false if the file cannot be read */
+    bool countFile(const std::string& filename);
+    void countText(std::string_view text);
+
+    /** @brief Per-pattern counts keyed by pattern, for the usual top-N output. */
+    WordCounterParallel::WordMap getCounts() const;
+    void saveResults(const std::string& filename, int topN = 0) const;
+
+    const std::vector<std::string>& getPatterns() const { return patterns; }
+    const std::vector<unsigned long long>& getPatternCounts() const { return counts; }
+    Engine getEngine() const { return engine; }
+    static const char* engineName(Engine engine);
+    /** @brief "auto", "teddy", "ac" or "aho-corasick"; false for anything else. */
+    static bool parseEngine(const std::string& name, Engine& engine);
+
+    unsigned long long getTotalMatches() const { return totalMatches; }
+    size_t getBytesScanned() const { return bytesScanned; }
+    double getExecutionTime() const { return executionTime; }
+
+private:
+    std::vector<std::string> patterns;
+    std::vector<unsigned long long> counts;
+    Engine engine;
+    size_t maxLength = 0;
+
+    // Teddy: fingerprint masks and the patterns in each bucket.
+    size_t fingerprint = 0;             // leading bytes in the filter (1-3)
+    std::uint8_t loMask[3][16] = {};    // bit b: some bucket-b pattern has this low nibble
+    std::uint8_t hiMask[3][16] = {};
+    std::vector<std::uint32_t> buckets[8];
+
+    // Aho-Corasick DFA over byte classes.
+    std::uint8_t byteClass[256] = {};
+    size_t numClasses = 1;
+    std::vector<std::uint32_t> delta;   // state * numClasses + class -> state
+    std::vector<std::int32_t> match;    // pattern ending at state, or -1
+    std::vector<std::int32_t> outLink;  // next state on the fail chain with a match, or -1
+    std::vector<std::int32_t> outHead;  // first state to report from this state, or -1
+
+    unsigned long long totalMatches = 0;
+    size_t bytesScanned = 0;
+    double executionTime = 0.0;
+
+    void buildTeddy();
+    void buildAutomaton();
+    void scanTeddy(std::string_view text, size_t begin, size_t end, std::vector<unsigned long long>& local) const;
+    void scanAutomaton(std::string_view text, size_t begin, size_t end, std::vector<unsigned long long>& local) const;
+};
+
+#endif // MULTI_PATTERN_H
@@ -0,0 +1,110 @@
+#ifndef PARALLEL_RUNTIME_H
+#define PARALLEL_RUNTIME_H
+
+/**
+ * @brief Build-time choice of threading runtime.
+ *
+ * The default build uses OpenMP. Building with -DPG_NO_OPENMP (and without
+ * -fopenmp) drops the libgomp dependency: the word-count engine runs its
+ * parallel region on std::threads instead, and the handful of omp_* queries
+ * used across the tree resolve to the stand-ins below. Code outside the
+ * engine runs its teams through parallelRegion() rather than `#pragma omp`,
+ * so every mode keeps its parallelism in either build.
+ */
+#ifndef PG_NO_OPENMP
+
+#include <omp.h>
+
+#else
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace pg_runtime {
+// Thread budget set by omp_set_num_threads (0 = hardware concurrency).
+inline int requestedThreads = 0;
+}
+
+inline void omp_set_num_threads(int n) {
+    pg_runtime::requestedThreads = n;
+}
+
+// Threads a parallel region would use; sizes std::thread pools in this build.
+inline int omp_get_max_threads() {
+    return pg_runtime::requestedThreads > 0 ? pg_runtime::requestedThreads
+                                            : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// Outside a real OpenMP region every caller is the only thread.
+inline int omp_get_thread_num() {
+    return 0;
+}
+
+inline int omp_get_num_threads() {
+    return 1;
+}
+
+#endif // PG_NO_OPENMP
+
+#include "topology.h"
+
+#include <vector>
+
+namespace pg_runtime {
+
+// Process-wide CPU plan from --affinity (thread t runs on plan[t % size]);
+// empty leaves placement to the OS. Only applied inside parallel work:
+// callers pin with topology::ScopedPin, so the thread that started the work
+// gets its own mask back and later threads it creates are not confined.
+inline std::vector<int> placementPlan;
+
+inline void setPlacement(std::vector<int> plan) {
+    placementPlan = std::move(plan);
+}
+
+inline const std::vector<int>& placement() {
+    return placementPlan;
+}
+
+/** @brief CPU for team member t under `cpus`, or -1 (no pinning) if the plan is empty. */
+inline int plannedCpu(int t, const std::vector<int>& cpus = placement()) {
+    return cpus.empty() ? -1 : cpus[static_cast<size_t>(t) % cpus.size()];
+}
+
+/**
+ * @brief Run fn(threadId, numThreads) once on every thread of a team: an
+ *        OpenMP parallel region, or std::threads in the OpenMP-free build.
+ *        For code that schedules its own work (e.g. an atomic cursor).
+ *        Thread t runs on cpus[t % cpus.size()] (by default the --affinity
+ *        plan) for the duration of the region.
+ */
+template <typename Fn>
+void parallelRegion(Fn&& fn, const std::vector<int>& cpus = placement()) {
+#ifndef PG_NO_OPENMP
+#pragma omp parallel
+    {
+        const topology::ScopedPin pin(plannedCpu(omp_get_thread_num(), cpus));
+        fn(omp_get_thread_num(), omp_get_num_threads());
+    }
+#else
+    const int n = omp_get_max_threads();
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(n - 1));
+    for (int t = 1; t < n; ++t) {
+        threads.emplace_back([&fn, &cpus, t, n]() {
+            topology::pinCurrentThread(plannedCpu(t, cpus));  // the thread ends with the region
+            fn(t, n);
+        });
+    }
+    const topology::ScopedPin pin(plannedCpu(0, cpus));
+    fn(0, n);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+#endif
+}
+
+} // namespace pg_runtime
+
+#endif // PARALLEL_RUNTIME_H
@@ -0,0 +1,462 @@
+#include "pipeline_counter.h"
+#include "arena.h"
+#include "phase_timer.h"
+#include "spsc_ring.h"
+#include "tokenizer.h"
+#include "topology.h"
+#include "trace_recorder.h"
+#include "word_filter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// Token-aligned slice of the input. File blocks own their bytes; text blocks
+// are views into the caller's buffer.
+struct Block {
+    std::string storage;
+    std::string_view text;
+};
+
+struct Record {
+    std::uint64_t hash;
+    std::uint32_t offset;  // into Batch::bytes
+    std::uint32_t length;
+};
+
+// Normalized words for one counter partition, packed back to back.
+struct Batch {
+    std::string bytes;
+    std::vector<Record> records;
+};
+
+using BlockPtr = std::unique_ptr<Block>;
+using BatchPtr = std::unique_ptr<Batch>;
+
+/**
+ * @brief Open-addressing word -> count table for one partition; words live
+ *        in an arena, the caller's hash is stored so probing rarely compares bytes.
+ */
+class PartitionTable {
+public:
+    PartitionTable() : slots(1024) {}
+
+    void add(std::uint64_t hash, std::string_view word) {
+        size_t mask = slots.size() - 1;
+        size_t i = static_cast<size_t>(hash) & mask;
+        while (slots[i].data != nullptr) {
+            Slot& s = slots[i];
+            if (s.hash == hash && s.length == word.size() && std::memcmp(s.data, word.data(), word.size()) == 0) {
+                ++s.count;
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        slots[i] = {hash, arena.copy(word).data(), static_cast<std::uint32_t>(word.size()), 1};
+        if (++used * 10 > slots.size() * 7) {
+            grow();
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& s : slots) {
+            if (s.data != nullptr) fn(std::string_view(s.data, s.length), s.count);
+        }
+    }
+
+    size_t size() const { return used; }
+
+private:
+    struct Slot {
+        std::uint64_t hash = 0;
+        const char* data = nullptr;  // nullptr = empty slot
+        std::uint32_t length = 0;
+        unsigned long long count = 0;
+    };
+
+    std::vector<Slot> slots;
+    size_t used = 0;
+    Arena arena{256 * 1024};
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for (const auto& s : old) {
+            if (s.data == nullptr) continue;
+            size_t i = static_cast<size_t>(s.hash) & mask;
+            while (slots[i].data != nullptr) i = (i + 1) & mask;
+            slots[i] = s;
+        }
+    }
+};
+
+/**
+ * @brief First offset >= pos that starts a token (file twin of
+ *        tokenizer::alignToTokenStart).
+ */
+size_t alignFileOffset(std::ifstream& in, size_t pos, size_t size) {
+    if (pos == 0 || pos >= size) {
+        return std::min(pos, size);
+    }
+    std::string buf(4096, '\0');
+    size_t cur = pos - 1;
+    while (cur < size) {
+        size_t n = std::min(buf.size(), size - cur);
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(cur));
+        if (!in.read(&buf[0], static_cast<std::streamsize>(n))) {
+            return size;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (tokenizer::isSpace(buf[i])) return cur + i + 1;
+        }
+        cur += n;
+    }
+    return size;
+}
+
+/** @brief Push to a fixed ring, yielding while it is full. */
+template <typename T>
+void pushBlocking(SpscRing<T>& ring, T& item, PipelineCounter::StageStats& stage) {
+    while (!ring.tryPush(item)) {
+        ++stage.fullStalls;
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Poll every input ring until all are closed and drained, calling
+ *        handle(item) for each item popped.
+ */
+template <typename T, typename Fn>
+void drainInputs(std::vector<SpscRing<T>*>& inputs, PipelineCounter::StageStats& stage, Fn&& handle) {
+    T item;
+    for (;;) {
+        bool gotAny = false;
+        bool allFinished = true;
+        for (auto* ring : inputs) {
+            if (ring->tryPop(item)) {
+                gotAny = true;
+                allFinished = false;
+                handle(item);
+            } else if (!ring->finished()) {
+                allFinished = false;
+            }
+        }
+        if (!gotAny) {
+            if (allFinished) return;
+            ++stage.emptyPolls;
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace
+
+PipelineCounter::Config PipelineCounter::configFor(int totalThreads) {
+    Config config;
+    int rest = std::max(0, totalThreads - 1);
+    config.readers = 1;
+    config.counters = std::max(1, rest / 4);
+    config.tokenizers = std::max(1, rest - config.counters);
+    return config;
+}
+
+PipelineCounter::PipelineCounter(const Config& config) : config(config) {
+    this->config.readers = std::max(1, config.readers);
+    this->config.tokenizers = std::max(1, config.tokenizers);
+    this->config.counters = std::max(1, config.counters);
+    this->config.blockBytes = std::max<size_t>(4096, config.blockBytes);
+    this->config.batchRecords = std::max<size_t>(1, config.batchRecords);
+    this->config.ringCapacity = std::max<size_t>(2, config.ringCapacity);
+}
+
+bool PipelineCounter::countFile(const std::string& filename, WordMap& wordFreq, unsigned long long& totalWords) {
+    std::ifstream probe(filename, std::ios::binary | std::ios::ate);
+    if (!probe.is_open()) {
+        return false;
+    }
+    std::streamoff size = probe.tellg();
+    if (size < 0) {
+        return false;
+    }
+    return run({&filename, std::string_view(), static_cast<size_t>(size)}, wordFreq, totalWords);
+}
+
+void PipelineCounter::countText(std::string_view text, WordMap& wordFreq, unsigned long long& totalWords) {
+    run({nullptr, text, text.size()}, wordFreq, totalWords);
+}
+
+bool PipelineCounter::run(const Source& source, WordMap& wordFreq, unsigned long long& totalWords) {
+    auto startTime = Clock::now();
+
+    const size_t R = static_cast<size_t>(config.readers);
+    const size_t T = static_cast<size_t>(config.tokenizers);
+    const size_t C = static_cast<size_t>(config.counters);
+
+    // blockRings[r * T + t]: reader r -> tokenizer t; batchRings[t * C + c]: tokenizer t -> counter c.
+    std::vector<std::unique_ptr<SpscRing<BlockPtr>>> blockRings;
+    std::vector<std::unique_ptr<SpscRing<BatchPtr>>> batchRings;
+    for (size_t i = 0; i < R * T; ++i) blockRings.push_back(std::make_unique<SpscRing<BlockPtr>>(config.ringCapacity));
+    for (size_t i = 0; i < T * C; ++i) batchRings.push_back(std::make_unique<SpscRing<BatchPtr>>(config.ringCapacity));
+
+    std::vector<StageStats> threadStats(R + T + C);
+    std::vector<PartitionTable> tables(C);
+    std::vector<unsigned long long> partitionTotals(C, 0);
+    std::vector<unsigned long long> tokenizerFiltered(T, 0);
+    std::vector<double> threadCpu(R + T + C, 0.0);
+    std::vector<PerfCounters::Values> threadCounters(R + T + C);
+    const bool readCounters = phaseTimer != nullptr && phaseTimer->getCountersEnabled();
+    auto countersNow = [&]() { return readCounters ? PerfCounters::readThread() : PerfCounters::Values(); };
+    std::atomic<bool> readFailed{false};
+
+    auto pin = [&](size_t index) {
+        if (!placement.empty()) topology::pinCurrentThread(placement[index % placement.size()]);
+    };
+
+    auto reader = [&](size_t r) {
+        pin(r);
+        TraceRecorder::nameThread("read", static_cast<long long>(r));
+        const double cpuStart = PhaseTimer::threadCpuMs();
+        const PerfCounters::Values countersStart = countersNow();
+        StageStats& stage = threadStats[r];
+        size_t nextRing = r % T;
+        auto send = [&](BlockPtr& block) {
+            for (;;) {
+                // Any tokenizer will do: take the first ring with room, starting after the last one used.
+                for (size_t k = 0; k < T; ++k) {
+                    size_t t = (nextRing + k) % T;
+                    if (blockRings[r * T + t]->tryPush(block)) {
+                        nextRing = (t + 1) % T;
+                        ++stage.items;
+                        return;
+                    }
+                }
+                ++stage.fullStalls;
+                std::this_thread::yield();
+            }
+        };
+
+        std::unique_ptr<std::ifstream> in;
+        size_t begin = source.size * r / R;
+        size_t end = source.size * (r + 1) / R;
+        if (source.filename != nullptr) {
+            in = std::make_unique<std::ifstream>(*source.filename, std::ios::binary);
+            if (!in->is_open()) {
+                readFailed = true;
+                begin = end = 0;
+            } else {
+                begin = alignFileOffset(*in, begin, source.size);
+                end = alignFileOffset(*in, end, source.size);
+                in->clear();
+                in->seekg(static_cast<std::streamoff>(begin));
+            }
+        } else {
+            begin = tokenizer::alignToTokenStart(source.text, begin);
+            end = tokenizer::alignToTokenStart(source.text, end);
+        }
+
+        std::string carry;
+        size_t pos = begin;
+        while (pos < end) {
+            auto busyStart = Clock::now();
+            TraceRecorder::Span span("chunk read", "pipeline");
+            auto block = std::make_unique<Block>();
+            if (in) {
+                size_t n = std::min(config.blockBytes, end - pos);
+                block->storage = std::move(carry);
+                carry.clear();
+                size_t old = block->storage.size();
+                block->storage.resize(old + n);
+                if (!in->read(&block->storage[old], static_cast<std::streamsize>(n))) {
+                    readFailed = true;
+                    break;
+                }
+                pos += n;
+                if (pos < end) {
+                    // Cut after the last whitespace; the partial token starts the next block.
+                    size_t cut = block->storage.size();
+                    while (cut > 0 && !tokenizer::isSpace(block->storage[cut - 1])) --cut;
+                    if (cut == 0) {
+                        carry = std::move(block->storage);  // token longer than a block
+                        stage.busyTime += elapsedMs(busyStart);
+                        continue;
+                    }
+                    carry.assign(block->storage, cut, std::string::npos);
+                    block->storage.resize(cut);
+                }
+                block->text = block->storage;
+            } else {
+                size_t next = pos + config.blockBytes >= end
+                                  ? end
+                                  : std::min(end, tokenizer::alignToTokenStart(source.text, pos + config.blockBytes));
+                block->text = source.text.substr(pos, next - pos);
+                pos = next;
+            }
+            stage.busyTime += elapsedMs(busyStart);
+            span.stop();
+            send(block);
+        }
+        for (size_t t = 0; t < T; ++t) blockRings[r * T + t]->close();
+        threadCpu[r] = PhaseTimer::threadCpuMs() - cpuStart;
+        threadCounters[r] = countersNow().since(countersStart);
+    };
+
+    auto tokenizerStage = [&](size_t t) {
+        pin(R + t);
+        TraceRecorder::nameThread("tokenize", static_cast<long long>(t));
+        const double cpuStart = PhaseTimer::threadCpuMs();
+        const PerfCounters::Values countersStart = countersNow();
+        StageStats& stage = threadStats[R + t];
+        std::vector<SpscRing<BlockPtr>*> inputs;
+        for (size_t r = 0; r < R; ++r) inputs.push_back(blockRings[r * T + t].get());
+
+        std::vector<BatchPtr> pending(C);
+        for (auto& b : pending) {
+            b = std::make_unique<Batch>();
+            b->records.reserve(config.batchRecords);
+        }
+        auto flush = [&](size_t c) {
+            pushBlocking(*batchRings[t * C + c], pending[c], stage);
+            pending[c] = std::make_unique<Batch>();
+            pending[c]->records.reserve(config.batchRecords);
+        };
+
+        std::hash<std::string_view> hasher;
+        std::string scratch;
+        unsigned long long filtered = 0;
+        drainInputs(inputs, stage, [&](BlockPtr& block) {
+            auto busyStart = Clock::now();
+            TraceRecorder::Span span("tokenize batch", "pipeline");
+            tokenizer::forEachWord(block->text, scratch, [&](std::string_view w) {
+                if (wordFilter != nullptr && !wordFilter->keeps(w)) {
+                    ++filtered;
+                    return;
+                }
+                std::uint64_t h = hasher(w);
+                // High hash bits pick the partition; the table probes with the low bits.
+                size_t c = static_cast<size_t>(((h >> 32) * C) >> 32);
+                Batch& batch = *pending[c];
+                batch.records.push_back({h, static_cast<std::uint32_t>(batch.bytes.size()),
+                                         static_cast<std::uint32_t>(w.size())});
+                batch.bytes.append(w);
+                if (batch.records.size() >= config.batchRecords) {
+                    flush(c);
+                }
+            });
+            block.reset();
+            ++stage.items;
+            stage.busyTime += elapsedMs(busyStart);
+        });
+
+        for (size_t c = 0; c < C; ++c) {
+            if (!pending[c]->records.empty()) flush(c);
+            batchRings[t * C + c]->close();
+        }
+        tokenizerFiltered[t] = filtered;
+        threadCpu[R + t] = PhaseTimer::threadCpuMs() - cpuStart;
+        threadCounters[R + t] = countersNow().since(countersStart);
+    };
+
+    auto counter = [&](size_t c) {
+        pin(R + T + c);
+        TraceRecorder::nameThread("count", static_cast<long long>(c));
+        const double cpuStart = PhaseTimer::threadCpuMs();
+        const PerfCounters::Values countersStart = countersNow();
+        StageStats& stage = threadStats[R + T + c];
+        std::vector<SpscRing<BatchPtr>*> inputs;
+        for (size_t t = 0; t < T; ++t) inputs.push_back(batchRings[t * C + c].get());
+
+        PartitionTable& table = tables[c];
+        unsigned long long total = 0;
+        drainInputs(inputs, stage, [&](BatchPtr& batch) {
+            auto busyStart = Clock::now();
+            TraceRecorder::Span span("table flush", "pipeline");
+            const char* bytes = batch->bytes.data();
+            for (const Record& rec : batch->records) {
+                table.add(rec.hash, std::string_view(bytes + rec.offset, rec.length));
+            }
+            total += batch->records.size();
+            batch.reset();
+            ++stage.items;
+            stage.busyTime += elapsedMs(busyStart);
+        });
+        partitionTotals[c] = total;
+        threadCpu[R + T + c] = PhaseTimer::threadCpuMs() - cpuStart;
+        threadCounters[R + T + c] = countersNow().since(countersStart);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(R + T + C);
+    for (size_t r = 0; r < R; ++r) threads.emplace_back(reader, r);
+    for (size_t t = 0; t < T; ++t) threads.emplace_back(tokenizerStage, t);
+    for (size_t c = 0; c < C; ++c) threads.emplace_back(counter, c);
+    for (auto& th : threads) th.join();
+
+    if (phaseTimer != nullptr) {
+        // Stages overlap in time: a stage's phase wall time is its busiest thread.
+        phaseTimer->reserveThreads(R + T + C);
+        auto record = [&](PhaseTimer::Phase phase, size_t first, size_t count) {
+            double wall = 0.0;
+            double cpu = 0.0;
+            for (size_t i = first; i < first + count; ++i) {
+                phaseTimer->addThread(phase, i, threadStats[i].busyTime, threadCpu[i], threadCounters[i]);
+                wall = std::max(wall, threadStats[i].busyTime);
+                cpu += threadCpu[i];
+            }
+            phaseTimer->add(phase, wall, cpu);
+        };
+        record(PhaseTimer::Read, 0, R);
+        record(PhaseTimer::Tokenize, R, T);
+        record(PhaseTimer::Count, R + T, C);
+    }
+
+    // Partitions are disjoint, so the final map is a plain concatenation.
+    std::optional<PhaseTimer::Scope> mergePhase;
+    if (phaseTimer != nullptr) mergePhase.emplace(*phaseTimer, PhaseTimer::Merge);
+    size_t unique = 0;
+    for (const auto& table : tables) unique += table.size();
+    wordFreq.clear();
+    wordFreq.reserve(unique);
+    totalWords = 0;
+    for (size_t c = 0; c < C; ++c) {
+        tables[c].forEach([&](std::string_view w, unsigned long long count) { wordFreq.emplace(std::string(w), count); });
+        totalWords += partitionTotals[c];
+    }
+    mergePhase.reset();
+
+    stats = Stats();
+    auto fold = [&](StageStats& into, size_t first, size_t count) {
+        into.threads = static_cast<int>(count);
+        for (size_t i = first; i < first + count; ++i) {
+            into.items += threadStats[i].items;
+            into.busyTime += threadStats[i].busyTime;
+            into.fullStalls += threadStats[i].fullStalls;
+            into.emptyPolls += threadStats[i].emptyPolls;
+        }
+    };
+    fold(stats.read, 0, R);
+    fold(stats.tokenize, R, T);
+    fold(stats.count, R + T, C);
+    for (unsigned long long f : tokenizerFiltered) stats.filteredWords += f;
+    stats.wallTime = elapsedMs(startTime);
+
+    return !readFailed;
+}
@@ -0,0 +1,102 @@
+#ifndef PIPELINE_COUNTER_H
+#define PIPELINE_COUNTER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class PhaseTimer;
+class WordFilter;
+
+/**
+ * @brief Three-stage streaming word counter: read -> tokenize -> count.
+ *
+ * Readers cut their byte range into token-aligned blocks, tokenizers turn
+ * blocks into batches of (hash, word) records bucketed by hash partition, and
+ * each counter thread owns one partition's table outright, so counting needs
+ * no locks or atomics. Every producer/consumer pair is joined by its own
+ * SpscRing; a full ring stalls the producer (backpressure), so memory in
+ * flight is bounded by the ring capacities, not by the input size.
+ */
+class PipelineCounter {
+public:
+    using WordMap = std::unordered_map<std::string, unsigned long long>;
+
+    struct Config {
+        int readers = 1;
+        int tokenizers = 1;
+        int counters = 1;
+        size_t blockBytes = 256 * 1024;  // read block size
+        size_t batchRecords = 4096;      // records per tokenizer -> counter batch
+        size_t ringCapacity = 8;         // slots per SPSC ring
+    };
+
+    struct StageStats {
+        int threads = 0;
+        size_t items = 0;        // blocks read / blocks tokenized / batches counted
+        double busyTime = 0.0;   // ms summed over the stage's threads
+        size_t fullStalls = 0;   // pushes retried because the next ring was full
+        size_t emptyPolls = 0;   // polls that found every input ring empty
+    };
+
+    struct Stats {
+        double wallTime = 0.0;
+        StageStats read;
+        StageStats tokenize;
+        StageStats count;
+        unsigned long long filteredWords = 0;  // dropped by the word filter while tokenizing
+    };
+
+    /**
+     * @brief Split a thread budget across the stages: one reader, a quarter
+     *        of the rest counting, the remainder tokenizing (at least 1 each).
+     */
+    static Config configFor(int totalThreads);
+
+    explicit PipelineCounter(const Config& config);
+
+    /** @brief Pin pipeline thread i (readers, then tokenizers, then counters) to cpus[i % size]. */
+    void setPlacement(const std::vector<int>& cpus) { placement = cpus; }
+
+    /** @brief Tokenizers drop words the filter rejects before batching them; null counts all. */
+    void setWordFilter(const WordFilter* filter) { wordFilter = filter; }
+
+    /**
+     * @brief Record each stage thread's busy and CPU time (and hardware
+     *        counters, if the timer reads them) under the read, tokenize and
+     *        count phases (thread index as in setPlacement), and the final
+     *        concatenation as merge; null records nothing.
+     */
+    void setPhaseTimer(PhaseTimer* timer) { phaseTimer = timer; }
+
+    /**
+     * @brief Stream a file through the pipeline; it is never held in memory whole.
+     * @return false if the file cannot be opened or read
+     */
+    bool countFile(const std::string& filename, WordMap& wordFreq, unsigned long long& totalWords);
+
+    /** @brief Count an in-memory buffer; readers hand out views, nothing is copied. */
+    void countText(std::string_view text, WordMap& wordFreq, unsigned long long& totalWords);
+
+    const Config& getConfig() const { return config; }
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Source {
+        const std::string* filename;  // nullptr: count `text`
+        std::string_view text;
+        size_t size;
+    };
+
+    Config config;
+    std::vector<int> placement;
+    const WordFilter* wordFilter = nullptr;
+    PhaseTimer* phaseTimer = nullptr;
+    Stats stats;
+
+    bool run(const Source& source, WordMap& wordFreq, unsigned long long& totalWords);
+};
+
+#endif // PIPELINE_COUNTER_H
@@ -0,0 +1,291 @@
+#include "positional_index.h"
+#include "file_reader.h"
+#include "line_chunks.h"
+#include "parallel_runtime.h"
+#include "sidecar_codec.h"
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+// Each chunk builds per-partition word tables, so chunks are larger than the scans'.
+constexpr size_t kMinIndexChunkBytes = 256 * 1024;
+
+constexpr char kMagic[8] = {'P', 'G', 'P', 'I', 'D', 'X', '0', '1'};
+
+// Partial postings of one word within one chunk; positions are chunk-local.
+struct Partial {
+    unsigned long long first = 0;
+    unsigned long long last = 0;
+    unsigned long long count = 0;
+    std::string deltas;  // varint deltas after `first`
+};
+using PartialTable = std::unordered_map<std::string, Partial, TermHash, std::equal_to<>>;
+
+struct ChunkResult {
+    std::vector<PartialTable> partitions;
+    unsigned long long tokens = 0;
+};
+
+size_t partitionOf(std::string_view word, size_t partitions) {
+    std::uint64_t h = std::hash<std::string_view>{}(word);
+    return static_cast<size_t>(((h >> 32) * partitions) >> 32);
+}
+
+} // namespace
+
+bool PositionalIndex::buildFromFile(const std::string& filename) {
+    std::string contents;
+    if (!readWholeFile(filename, contents)) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+    buildFromText(contents);
+    return true;
+}
+
+void PositionalIndex::buildFromText(std::string_view text) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    terms.clear();
+    totalTokens = 0;
+    bytesIndexed = text.size();
+
+    const size_t threads = static_cast<size_t>(omp_get_max_threads());
+    const size_t n = text.size();
+    const size_t chunks = chunksFor(n, threads, kMinIndexChunkBytes);
+    chunkCount = chunks;
+    std::vector<size_t> bounds(chunks + 1, n);
+    bounds[0] = 0;
+    for (size_t c = 1; c < chunks; ++c) {
+        bounds[c] = std::max(bounds[c - 1], tokenizer::alignToTokenStart(text, n / chunks * c));
+    }
+
+    // Phase 1: partial postings per chunk, bucketed by the partition that will merge them.
+    std::vector<ChunkResult> results(chunks);
+    std::atomic<size_t> next{0};
+    pg_runtime::parallelRegion([&](int, int) {
+        std::string scratch;
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            ChunkResult& result = results[c];
+            result.partitions.resize(threads);
+            unsigned long long position = 0;
+            tokenizer::forEachWord(text.substr(bounds[c], bounds[c + 1] - bounds[c]), scratch,
+                                   [&](std::string_view w) {
+                PartialTable& table = result.partitions[partitionOf(w, threads)];
+                auto it = table.find(w);
+                if (it == table.end()) {
+                    it = table.emplace(std::string(w), Partial{position, position, 1, {}}).first;
+                } else {
+                    putVarint(it->second.deltas, position - it->second.last);
+                    it->second.last = position;
+                    ++it->second.count;
+                }
+                ++position;
+            });
+            result.tokens = position;
+        }
+    });
+
+    // Exclusive prefix sum of chunk token counts gives each chunk's first position.
+    std::vector<unsigned long long> base(chunks, 0);
+    for (size_t c = 0; c < chunks; ++c) {
+        base[c] = totalTokens;
+        totalTokens += results[c].tokens;
+    }
+
+    // Phase 2: one thread per partition concatenates that partition's partials in chunk order.
+    std::vector<std::vector<Term>> merged(threads);
+    pg_runtime::parallelRegion([&](int t, int nthreads) {
+        for (size_t p = static_cast<size_t>(t); p < threads; p += static_cast<size_t>(nthreads)) {
+            std::unordered_map<std::string, size_t, TermHash, std::equal_to<>> slot;
+            std::vector<unsigned long long> last;
+            std::vector<Term>& out = merged[p];
+            for (size_t c = 0; c < chunks; ++c) {
+                for (auto& [word, partial] : results[c].partitions[p]) {
+                    auto it = slot.find(word);
+                    if (it == slot.end()) {
+                        it = slot.emplace(word, out.size()).first;
+                        out.push_back({word, 0, {}});
+                        last.push_back(0);
+                    }
+                    Term& term = out[it->second];
+                    putVarint(term.postings, base[c] + partial.first - last[it->second]);
+                    term.postings += partial.deltas;
+                    term.count += partial.count;
+                    last[it->second] = base[c] + partial.last;
+                }
+                PartialTable().swap(results[c].partitions[p]);
+            }
+        }
+    });
+
+    size_t vocabulary = 0;
+    for (const auto& part : merged) vocabulary += part.size();
+    terms.reserve(vocabulary);
+    for (auto& part : merged) {
+        std::move(part.begin(), part.end(), std::back_inserter(terms));
+    }
+    std::sort(terms.begin(), terms.end(), [](const Term& a, const Term& b) { return a.word < b.word; });
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+bool PositionalIndex::save(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create index file " << filename << std::endl;
+        return false;
+    }
+    std::string header(kMagic, sizeof(kMagic));
+    putVarint(header, totalTokens);
+    putVarint(header, terms.size());
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    std::string entry;
+    for (const auto& term : terms) {
+        entry.clear();
+        putVarint(entry, term.word.size());
+        entry += term.word;
+        putVarint(entry, term.count);
+        putVarint(entry, term.postings.size());
+        out.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+        out.write(term.postings.data(), static_cast<std::streamsize>(term.postings.size()));
+    }
+    return static_cast<bool>(out);
+}
+
+bool PositionalIndex::load(const std::string& filename) {
+    std::string contents;
+    if (!readWholeFile(filename, contents) || contents.size() < sizeof(kMagic) ||
+        std::memcmp(contents.data(), kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    const char* p = contents.data() + sizeof(kMagic);
+    const char* end = contents.data() + contents.size();
+    unsigned long long tokens = 0;
+    unsigned long long count = 0;
+    if (!getVarint(p, end, tokens) || !getVarint(p, end, count)) {
+        return false;
+    }
+
+    std::vector<Term> loaded;
+    loaded.reserve(static_cast<size_t>(std::min<unsigned long long>(count, contents.size())));
+    for (unsigned long long i = 0; i < count; ++i) {
+        unsigned long long wordLen = 0;
+        unsigned long long postingsLen = 0;
+        Term term;
+        if (!getVarint(p, end, wordLen) || wordLen > static_cast<size_t>(end - p)) return false;
+        term.word.assign(p, static_cast<size_t>(wordLen));
+        p += wordLen;
+        if (!getVarint(p, end, term.count) || !getVarint(p, end, postingsLen) ||
+            postingsLen > static_cast<size_t>(end - p)) {
+            return false;
+        }
+        term.postings.assign(p, static_cast<size_t>(postingsLen));
+        p += postingsLen;
+        loaded.push_back(std::move(term));
+    }
+
+    terms = std::move(loaded);
+    totalTokens = tokens;
+    chunkCount = 0;
+    bytesIndexed = 0;
+    return true;
+}
+
+const PositionalIndex::Term* PositionalIndex::find(std::string_view word) const {
+    std::string normalized;
+    tokenizer::normalize(word, normalized);
+    auto it = std::lower_bound(terms.begin(), terms.end(), normalized,
+                               [](const Term& t, const std::string& w) { return t.word < w; });
+    return it != terms.end() && it->word == normalized ? &*it : nullptr;
+}
+
+std::vector<unsigned long long> PositionalIndex::decode(const Term& term) {
+    std::vector<unsigned long long> out;
+    out.reserve(static_cast<size_t>(term.count));
+    const char* p = term.postings.data();
+    const char* end = p + term.postings.size();
+    unsigned long long position = 0;
+    unsigned long long delta = 0;
+    while (p < end && getVarint(p, end, delta)) {
+        position += delta;
+        out.push_back(position);
+    }
+    return out;
+}
+
+std::vector<unsigned long long> PositionalIndex::positions(std::string_view word) const {
+    const Term* term = find(word);
+    return term != nullptr ? decode(*term) : std::vector<unsigned long long>();
+}
+
+std::vector<unsigned long long> PositionalIndex::phrase(const std::vector<std::string>& words) const {
+    std::vector<unsigned long long> hits;
+    if (words.empty()) return hits;
+
+    std::vector<std::vector<unsigned long long>> lists;
+    for (const auto& w : words) {
+        const Term* term = find(w);
+        if (term == nullptr) return hits;
+        lists.push_back(decode(*term));
+    }
+
+    // Walk the rarest word's positions; the others are probed with cursors
+    // that only move forward, since candidate starts increase.
+    size_t anchor = 0;
+    for (size_t i = 1; i < lists.size(); ++i) {
+        if (lists[i].size() < lists[anchor].size()) anchor = i;
+    }
+    std::vector<size_t> cursor(lists.size(), 0);
+    for (unsigned long long p : lists[anchor]) {
+        if (p < anchor) continue;
+        const unsigned long long start = p - anchor;
+        bool all = true;
+        for (size_t i = 0; i < lists.size() && all; ++i) {
+            if (i == anchor) continue;
+            const auto& list = lists[i];
+            size_t& c = cursor[i];
+            while (c < list.size() && list[c] < start + i) ++c;
+            all = c < list.size() && list[c] == start + i;
+        }
+        if (all) hits.push_back(start);
+    }
+    return hits;
+}
+
+std::vector<unsigned long long> PositionalIndex::near(std::string_view a, std::string_view b,
+                                                      unsigned long long distance) const {
+    std::vector<unsigned long long> hits;
+    const Term* termA = find(a);
+    const Term* termB = find(b);
+    if (termA == nullptr || termB == nullptr) return hits;
+
+    const auto listA = decode(*termA);
+    const auto listB = decode(*termB);
+    size_t j = 0;
+    for (unsigned long long p : listA) {
+        const unsigned long long low = p > distance ? p - distance : 0;
+        while (j < listB.size() && listB[j] < low) ++j;
+        // Skip p itself, so "x near x" needs a second occurrence.
+        size_t k = j;
+        while (k < listB.size() && listB[k] == p) ++k;
+        if (k < listB.size() && listB[k] <= p + distance) hits.push_back(p);
+    }
+    return hits;
+}
+
+size_t PositionalIndex::getPostingsBytes() const {
+    size_t bytes = 0;
+    for (const auto& term : terms) bytes += term.postings.size();
+    return bytes;
+}
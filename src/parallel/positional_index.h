@@ -0,0 +1,68 @@
+#ifndef POSITIONAL_INDEX_H
+#define POSITIONAL_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Positional inverted index: for every word, the token positions at
+ *        which it occurs, so word, phrase and proximity queries are answered
+ *        without rescanning the text.
+ *
+ * A position is the 0-based index of a word among all counted words (same
+ * tokenization as WordCounterParallel). Postings are sorted positions stored
+ * as LEB128 varint deltas, the first one relative to 0.
+ *
+ * Building cuts the text into token-aligned chunks. Each chunk is tokenized
+ * independently into partial postings with chunk-local positions, bucketed
+ * by hash partition; the partials are then concatenated in chunk order, one
+ * thread per partition, shifting each chunk by the prefix sum of the token
+ * counts before it. Only the first delta of every partial is re-encoded, the
+ * rest is copied as bytes.
+ */
+class PositionalIndex {
+public:
+    struct Term {
+        std::string word;
+        unsigned long long count = 0;  // occurrences (= positions in postings)
+        std::string postings;          // varint deltas
+    };
+
+    /** @return false if the file cannot be read */
+    bool buildFromFile(const std::string& filename);
+    void buildFromText(std::string_view text);
+
+    /** @brief Write the index as a binary file; false if it cannot be created. */
+    bool save(const std::string& filename) const;
+    /** @return false if the file is missing or not an index */
+    bool load(const std::string& filename);
+
+    /** @brief Term for a word (normalized first), or nullptr if it never occurs. */
+    const Term* find(std::string_view word) const;
+    static std::vector<unsigned long long> decode(const Term& term);
+
+    /** @brief Positions of a single word. */
+    std::vector<unsigned long long> positions(std::string_view word) const;
+    /** @brief Start positions at which the words occur consecutively. */
+    std::vector<unsigned long long> phrase(const std::vector<std::string>& words) const;
+    /** @brief Positions of `a` with an occurrence of `b` at most `distance` tokens away (either side). */
+    std::vector<unsigned long long> near(std::string_view a, std::string_view b, unsigned long long distance) const;
+
+    /** @brief Terms sorted by word. */
+    const std::vector<Term>& getTerms() const { return terms; }
+    unsigned long long getTotalTokens() const { return totalTokens; }
+    size_t getPostingsBytes() const;
+    size_t getChunkCount() const { return chunkCount; }
+    size_t getBytesIndexed() const { return bytesIndexed; }
+    double getExecutionTime() const { return executionTime; }
+
+private:
+    std::vector<Term> terms;
+    unsigned long long totalTokens = 0;
+    size_t chunkCount = 0;
+    size_t bytesIndexed = 0;
+    double executionTime = 0.0;
+};
+
+#endif // POSITIONAL_INDEX_H
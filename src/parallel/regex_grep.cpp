@@ -0,0 +1,739 @@
+#include "regex_grep.h"
+#include "file_reader.h"
+#include "line_chunks.h"
+#include "parallel_runtime.h"
+#include "simd_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+// Bounds NFA size, since counted repetition copies its operand.
+constexpr size_t kMaxNodes = 1 << 20;
+constexpr int kMaxRepeat = 1000;
+
+// ---------------------------------------------------------------- parsing
+
+struct AstNode {
+    enum class Kind { Empty, Set, Concat, Alt, Repeat, Bol, Eol } kind;
+    std::bitset<256> set;
+    std::vector<std::unique_ptr<AstNode>> children;
+    int min = 0;
+    int max = -1;  // -1 = unbounded
+
+    explicit AstNode(Kind kind) : kind(kind) {}
+};
+
+using AstPtr = std::unique_ptr<AstNode>;
+
+std::bitset<256> anyButNewline() {
+    std::bitset<256> set;
+    set.set();
+    set.reset(static_cast<unsigned char>('\n'));
+    return set;
+}
+
+std::bitset<256> classEscape(char c) {
+    std::bitset<256> set;
+    switch (c) {
+        case 'd': case 'D':
+            for (int b = '0'; b <= '9'; ++b) set.set(static_cast<size_t>(b));
+            break;
+        case 'w': case 'W':
+            for (int b = 0; b < 256; ++b) {
+                if (std::isalnum(b) || b == '_') set.set(static_cast<size_t>(b));
+            }
+            break;
+        case 's': case 'S':
+            for (char b : {' ', '\t', '\r', '\f', '\v'}) set.set(static_cast<unsigned char>(b));
+            break;
+    }
+    if (std::isupper(static_cast<unsigned char>(c))) {
+        set = ~set;
+        set.reset(static_cast<unsigned char>('\n'));
+    }
+    return set;
+}
+
+/** @brief POSIX bracket class `[:name:]` (C locale); false for an unknown name. */
+bool namedClass(const std::string& name, std::bitset<256>& set) {
+    int (*test)(int) = nullptr;
+    if (name == "alpha") test = [](int b) { return std::isalpha(b); };
+    else if (name == "digit") test = [](int b) { return std::isdigit(b); };
+    else if (name == "alnum") test = [](int b) { return std::isalnum(b); };
+    else if (name == "upper") test = [](int b) { return std::isupper(b); };
+    else if (name == "lower") test = [](int b) { return std::islower(b); };
+    else if (name == "space") test = [](int b) { return std::isspace(b); };
+    else if (name == "blank") test = [](int b) { return b == ' ' || b == '\t' ? 1 : 0; };
+    else if (name == "punct") test = [](int b) { return std::ispunct(b); };
+    else if (name == "xdigit") test = [](int b) { return std::isxdigit(b); };
+    else if (name == "cntrl") test = [](int b) { return std::iscntrl(b); };
+    else if (name == "print") test = [](int b) { return std::isprint(b); };
+    else if (name == "graph") test = [](int b) { return std::isgraph(b); };
+    else return false;
+    for (int b = 0; b < 256; ++b) {
+        if (test(b)) set.set(static_cast<size_t>(b));
+    }
+    return true;
+}
+
+/**
+ * @brief Recursive-descent parser:
+ *        alt := concat ('|' concat)*, concat := repeat*,
+ *        repeat := atom ('*' | '+' | '?' | '{m,n}')*
+ */
+class Parser {
+public:
+    explicit Parser(const std::string& pattern) : pattern(pattern) {}
+
+    AstPtr parse(std::string& error) {
+        AstPtr root = parseAlt();
+        if (err.empty() && pos < pattern.size()) fail("unmatched ')'");
+        error = err;
+        return err.empty() ? std::move(root) : nullptr;
+    }
+
+private:
+    const std::string& pattern;
+    size_t pos = 0;
+    std::string err;
+
+    bool more() const { return pos < pattern.size() && err.empty(); }
+    void fail(const std::string& message) {
+        if (err.empty()) err = message + " at offset " + std::to_string(pos);
+    }
+
+    AstPtr parseAlt() {
+        AstPtr first = parseConcat();
+        if (!more() || pattern[pos] != '|') return first;
+        auto alt = std::make_unique<AstNode>(AstNode::Kind::Alt);
+        alt->children.push_back(std::move(first));
+        while (more() && pattern[pos] == '|') {
+            ++pos;
+            alt->children.push_back(parseConcat());
+        }
+        return alt;
+    }
+
+    AstPtr parseConcat() {
+        auto concat = std::make_unique<AstNode>(AstNode::Kind::Concat);
+        while (more() && pattern[pos] != '|' && pattern[pos] != ')') {
+            AstPtr item = parseRepeat();
+            if (!item) break;
+            // Flatten nested concatenations so literal runs stay adjacent.
+            if (item->kind == AstNode::Kind::Concat) {
+                for (auto& child : item->children) concat->children.push_back(std::move(child));
+            } else if (item->kind != AstNode::Kind::Empty) {
+                concat->children.push_back(std::move(item));
+            }
+        }
+        if (concat->children.empty()) return std::make_unique<AstNode>(AstNode::Kind::Empty);
+        if (concat->children.size() == 1) return std::move(concat->children.front());
+        return concat;
+    }
+
+    AstPtr parseRepeat() {
+        AstPtr atom = parseAtom();
+        while (atom && more()) {
+            int min, max;
+            char c = pattern[pos];
+            if (c == '*') { min = 0; max = -1; ++pos; }
+            else if (c == '+') { min = 1; max = -1; ++pos; }
+            else if (c == '?') { min = 0; max = 1; ++pos; }
+            else if (c == '{' && parseBounds(min, max)) {}
+            else break;
+            if (atom->kind == AstNode::Kind::Bol || atom->kind == AstNode::Kind::Eol) {
+                fail("repetition of an anchor");
+                return nullptr;
+            }
+            auto repeat = std::make_unique<AstNode>(AstNode::Kind::Repeat);
+            repeat->min = min;
+            repeat->max = max;
+            repeat->children.push_back(std::move(atom));
+            atom = std::move(repeat);
+        }
+        return atom;
+    }
+
+    // {m}, {m,} or {m,n}; a '{' that does not start one is a literal.
+    bool parseBounds(int& min, int& max) {
+        size_t p = pos + 1;
+        auto number = [&](int& out) {
+            size_t digits = p;
+            long long v = 0;
+            while (p < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[p]))) {
+                v = std::min<long long>(v * 10 + (pattern[p++] - '0'), kMaxRepeat + 1);
+            }
+            out = static_cast<int>(v);
+            return p > digits;
+        };
+        if (!number(min)) return false;
+        max = min;
+        if (p < pattern.size() && pattern[p] == ',') {
+            ++p;
+            if (!number(max)) max = -1;
+        }
+        if (p >= pattern.size() || pattern[p] != '}') return false;
+        pos = p + 1;
+        if (min > kMaxRepeat || max > kMaxRepeat || (max >= 0 && max < min)) {
+            fail("bad repetition count");
+        }
+        return true;
+    }
+
+    AstPtr makeSet(const std::bitset<256>& set) {
+        auto node = std::make_unique<AstNode>(AstNode::Kind::Set);
+        node->set = set;
+        return node;
+    }
+
+    AstPtr parseAtom() {
+        char c = pattern[pos++];
+        switch (c) {
+            case '(': {
+                AstPtr inner = parseAlt();
+                if (pos >= pattern.size() || pattern[pos] != ')') {
+                    fail("missing ')'");
+                    return nullptr;
+                }
+                ++pos;
+                return inner;
+            }
+            case '[': return parseClass();
+            case '.': return makeSet(anyButNewline());
+            case '^': return std::make_unique<AstNode>(AstNode::Kind::Bol);
+            case '$': return std::make_unique<AstNode>(AstNode::Kind::Eol);
+            case '*': case '+': case '?':
+                --pos;
+                fail("repetition without operand");
+                return nullptr;
+            case '\\': {
+                if (pos >= pattern.size()) {
+                    fail("trailing backslash");
+                    return nullptr;
+                }
+                char e = pattern[pos++];
+                if (e != '\0' && std::strchr("dDwWsS", e) != nullptr) return makeSet(classEscape(e));
+                std::bitset<256> set;
+                set.set(static_cast<unsigned char>(e == 't' ? '\t' : e));
+                return makeSet(set);
+            }
+            default: {
+                std::bitset<256> set;
+                set.set(static_cast<unsigned char>(c));
+                return makeSet(set);
+            }
+        }
+    }
+
+    AstPtr parseClass() {
+        bool negate = pos < pattern.size() && pattern[pos] == '^';
+        if (negate) ++pos;
+        std::bitset<256> set;
+        bool first = true;
+        while (pos < pattern.size() && (pattern[pos] != ']' || first)) {
+            first = false;
+            if (pattern.compare(pos, 2, "[:") == 0) {
+                size_t close = pattern.find(":]", pos + 2);
+                if (close == std::string::npos) {
+                    fail("missing ':]'");
+                    return nullptr;
+                }
+                std::string name = pattern.substr(pos + 2, close - pos - 2);
+                if (!namedClass(name, set)) {
+                    fail("unsupported character class [:" + name + ":]");
+                    return nullptr;
+                }
+                pos = close + 2;
+                continue;
+            }
+            unsigned char lo = static_cast<unsigned char>(pattern[pos++]);
+            if (lo == '\\' && pos < pattern.size()) {
+                char e = pattern[pos++];
+                if (e != '\0' && std::strchr("dDwWsS", e) != nullptr) {
+                    set |= classEscape(e);
+                    continue;
+                }
+                lo = static_cast<unsigned char>(e == 't' ? '\t' : e);
+            }
+            unsigned char hi = lo;
+            if (pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']') {
+                hi = static_cast<unsigned char>(pattern[pos + 1]);
+                pos += 2;
+                if (hi < lo) {
+                    fail("bad class range");
+                    return nullptr;
+                }
+            }
+            for (unsigned b = lo; b <= hi; ++b) set.set(b);
+        }
+        if (pos >= pattern.size()) {
+            fail("missing ']'");
+            return nullptr;
+        }
+        ++pos;
+        if (negate) set = ~set;
+        set.reset(static_cast<unsigned char>('\n'));
+        return makeSet(set);
+    }
+};
+
+/**
+ * @brief Longest run of single-byte atoms in the top-level concatenation;
+ *        every match contains it. Anchors are zero-width and do not break a run.
+ */
+std::string extractRequiredLiteral(const AstNode& root) {
+    auto singleByte = [](const AstNode& n, char& out) {
+        if (n.kind != AstNode::Kind::Set || n.set.count() != 1) return false;
+        for (size_t b = 0; b < 256; ++b) {
+            if (n.set[b]) out = static_cast<char>(b);
+        }
+        return true;
+    };
+    std::string best, run;
+    char c = 0;
+    if (root.kind == AstNode::Kind::Concat) {
+        for (const auto& child : root.children) {
+            if (singleByte(*child, c)) {
+                run += c;
+            } else if (child->kind != AstNode::Kind::Bol && child->kind != AstNode::Kind::Eol) {
+                run.clear();
+            }
+            if (run.size() > best.size()) best = run;
+        }
+    } else if (singleByte(root, c)) {
+        best = std::string(1, c);
+    }
+    return best;
+}
+
+// ---------------------------------------------------------------- lazy DFA
+
+/**
+ * @brief One thread's DFA cache over a shared RegexProgram.
+ *
+ * A DFA state is the sorted set of NFA nodes that can still make progress
+ * (Set nodes, pending `$` nodes and Match). Transitions are filled in on
+ * first use. A state is named by its row offset in the transition table and
+ * an entry holds the target's row plus flags, so the inner loop is one load
+ * and one compare per byte. The newline column records whether the line
+ * matches if it ends there.
+ */
+class LazyDfa {
+public:
+    LazyDfa(const RegexProgram& program, size_t budgetBytes)
+        : program(program),
+          classes(program.getClassCount()),
+          maxStates(std::clamp<size_t>(budgetBytes / (program.getClassCount() * sizeof(std::uint32_t)), 16,
+                                       (kDeadBit - 1) / program.getClassCount())),
+          mark(program.getNodes().size(), 0) {
+        for (int b = 0; b < 256; ++b) byteClass[b] = program.classOf(static_cast<unsigned char>(b));
+        newGeneration();
+        closure(program.getStart(), false, false, startSet);
+        std::sort(startSet.begin(), startSet.end());
+    }
+
+    /**
+     * @brief Run the DFA over the line starting at p.
+     * @return the line end ('\n' or end); matched tells whether it matched
+     */
+    const unsigned char* runLine(const unsigned char* p, const unsigned char* end, bool& matched) {
+        if (bolState == kUnknown) {
+            std::vector<std::uint32_t> set;
+            newGeneration();
+            closure(program.getStart(), true, false, set);
+            bolState = intern(set);
+        }
+        std::uint32_t s = bolState;
+        if (s & kFlags) {
+            matched = (s & kMatchBit) != 0;
+            return skipLine(p, end);
+        }
+        const std::uint32_t* table = transitions.data();
+        while (p < end) {
+            std::uint32_t t = table[s + byteClass[*p]];
+            if (t < kDeadBit) {
+                s = t;
+                ++p;
+                continue;
+            }
+            if (t == kEolReject || t == kEolAccept) {
+                matched = t == kEolAccept;
+                return p;
+            }
+            if (t == kUnknown) {
+                t = computeTransition(s, byteClass[*p]);
+                table = transitions.data();
+                if (t < kDeadBit) {
+                    s = t;
+                    ++p;
+                    continue;
+                }
+            }
+            matched = (t & kMatchBit) != 0;
+            return skipLine(p + 1, end);
+        }
+        matched = table[s + program.newlineClass()] == kEolAccept;
+        return end;
+    }
+
+    size_t statesBuilt = 0;
+    size_t flushes = 0;
+
+private:
+    static constexpr std::uint32_t kUnknown = 0xffffffffu;
+    static constexpr std::uint32_t kEolReject = 0xfffffffeu;  // newline column: line does not match
+    static constexpr std::uint32_t kEolAccept = 0xfffffffdu;  // newline column: `$` completes a match
+    static constexpr std::uint32_t kMatchBit = 1u << 31;
+    static constexpr std::uint32_t kDeadBit = 1u << 30;
+    static constexpr std::uint32_t kFlags = kMatchBit | kDeadBit;
+
+    const RegexProgram& program;
+    const size_t classes;
+    const size_t maxStates;
+
+    std::uint8_t byteClass[256];
+    std::vector<std::uint32_t> transitions;  // row + class -> encoded row
+    std::vector<std::vector<std::uint32_t>> stateSets;  // by row / classes
+    std::unordered_map<std::string, std::uint32_t> index;
+    std::uint32_t bolState = kUnknown;
+    std::vector<std::uint32_t> startSet;  // closure of the start away from a line start
+
+    std::vector<std::uint32_t> mark;
+    std::uint32_t generation = 0;
+    std::vector<std::uint32_t> stack;
+
+    static const unsigned char* skipLine(const unsigned char* p, const unsigned char* end) {
+        const void* nl = p < end ? std::memchr(p, '\n', static_cast<size_t>(end - p)) : nullptr;
+        return nl != nullptr ? static_cast<const unsigned char*>(nl) : end;
+    }
+
+    void newGeneration() {
+        if (++generation == 0) {
+            std::fill(mark.begin(), mark.end(), 0);
+            generation = 1;
+        }
+    }
+
+    /**
+     * @brief Add the epsilon closure of `from` to out, skipping nodes already
+     *        marked in this generation. `^` / `$` edges are followed only when
+     *        bol / eol hold; unresolved `$` nodes are kept in the set.
+     */
+    void closure(std::uint32_t from, bool bol, bool eol, std::vector<std::uint32_t>& out) {
+        const auto& nodes = program.getNodes();
+        stack.push_back(from);
+        while (!stack.empty()) {
+            std::uint32_t n = stack.back();
+            stack.pop_back();
+            if (mark[n] == generation) continue;
+            mark[n] = generation;
+            const auto& node = nodes[n];
+            switch (node.kind) {
+                case RegexProgram::Node::Kind::Split:
+                    stack.push_back(node.out1);
+                    stack.push_back(node.out);
+                    break;
+                case RegexProgram::Node::Kind::Bol:
+                    if (bol) stack.push_back(node.out);
+                    break;
+                case RegexProgram::Node::Kind::Eol:
+                    if (eol) stack.push_back(node.out);
+                    else out.push_back(n);
+                    break;
+                default:
+                    out.push_back(n);
+                    break;
+            }
+        }
+    }
+
+    std::uint32_t intern(std::vector<std::uint32_t>& set) {
+        std::sort(set.begin(), set.end());
+        std::string key(reinterpret_cast<const char*>(set.data()), set.size() * sizeof(std::uint32_t));
+        auto found = index.find(key);
+        if (found != index.end()) {
+            return found->second;
+        }
+
+        const auto& nodes = program.getNodes();
+        bool match = false;
+        bool pendingEol = false;
+        for (std::uint32_t n : set) {
+            match |= nodes[n].kind == RegexProgram::Node::Kind::Match;
+            pendingEol |= nodes[n].kind == RegexProgram::Node::Kind::Eol;
+        }
+        bool acceptsAtEol = match;
+        if (!match && pendingEol) {
+            std::vector<std::uint32_t> atEol;
+            newGeneration();
+            for (std::uint32_t n : set) {
+                if (nodes[n].kind == RegexProgram::Node::Kind::Eol) closure(nodes[n].out, false, true, atEol);
+            }
+            for (std::uint32_t n : atEol) acceptsAtEol |= nodes[n].kind == RegexProgram::Node::Kind::Match;
+        }
+
+        auto row = static_cast<std::uint32_t>(transitions.size());
+        stateSets.push_back(set);
+        transitions.resize(transitions.size() + classes, kUnknown);
+        transitions[row + program.newlineClass()] = acceptsAtEol ? kEolAccept : kEolReject;
+        ++statesBuilt;
+
+        std::uint32_t encoded = row;
+        if (match) encoded |= kMatchBit;
+        else if (set.empty()) encoded |= kDeadBit;
+        index.emplace(std::move(key), encoded);
+        return encoded;
+    }
+
+    std::uint32_t computeTransition(std::uint32_t& s, size_t cls) {
+        if (stateSets.size() >= maxStates) {
+            // Budget reached: drop the cache and keep only the current state.
+            std::vector<std::uint32_t> current = stateSets[s / classes];
+            transitions.clear();
+            stateSets.clear();
+            index.clear();
+            bolState = kUnknown;
+            ++flushes;
+            s = intern(current) & ~kFlags;
+        }
+
+        const auto& nodes = program.getNodes();
+        std::vector<std::uint32_t> next;
+        newGeneration();
+        for (std::uint32_t n : stateSets[s / classes]) {
+            if (nodes[n].kind == RegexProgram::Node::Kind::Set && program.accepts(n, cls)) {
+                closure(nodes[n].out, false, false, next);
+            }
+        }
+        // Unanchored search: a match may also start after this byte.
+        for (std::uint32_t n : startSet) {
+            if (mark[n] != generation) {
+                mark[n] = generation;
+                next.push_back(n);
+            }
+        }
+        std::uint32_t target = intern(next);
+        transitions[s + cls] = target;
+        return target;
+    }
+};
+
+struct ChunkResult {
+    std::vector<RegexGrep::MatchLine> lines;  // lineNumber is chunk-local (0-based)
+    unsigned long long newlines = 0;
+    size_t linesScanned = 0;
+};
+
+void scanChunk(std::string_view text, size_t begin, size_t end, const std::string& literal, LazyDfa& dfa,
+               ChunkResult& out) {
+    const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+    size_t cursor = begin;  // newlines before cursor are counted
+    unsigned long long line = 0;
+    size_t from = begin;    // always a line start
+    while (from < end) {
+        size_t lineStart = from;
+        if (!literal.empty()) {
+            size_t hit = from + simd::findLiteral(text.data() + from, end - from, literal);
+            if (hit >= end) {
+                break;
+            }
+            lineStart = hit;
+            while (lineStart > from && data[lineStart - 1] != '\n') --lineStart;
+        }
+        bool matched = false;
+        size_t lineEnd = static_cast<size_t>(dfa.runLine(data + lineStart, data + end, matched) - data);
+        ++out.linesScanned;
+        if (matched) {
+            line += simd::countByte(text.data() + cursor, lineStart - cursor, '\n');
+            cursor = lineStart;
+            out.lines.push_back({line, lineStart, lineEnd - lineStart});
+        }
+        from = lineEnd < end ? lineEnd + 1 : end;
+    }
+    out.newlines = line + simd::countByte(text.data() + cursor, end - cursor, '\n');
+}
+
+} // namespace
+
+RegexProgram::RegexProgram(const std::string& pattern) {
+    if (pattern.find('\n') != std::string::npos) {
+        error = "pattern contains a newline";
+        return;
+    }
+    AstPtr ast = Parser(pattern).parse(error);
+    if (!ast) {
+        return;
+    }
+    requiredLiteral = extractRequiredLiteral(*ast);
+
+    // Thompson construction, back to front: emit(n, next) returns the entry
+    // node of a fragment for n that continues at `next`.
+    auto add = [&](Node node) {
+        nodes.push_back(node);
+        return static_cast<std::uint32_t>(nodes.size() - 1);
+    };
+    auto emit = [&](auto& self, const AstNode& n, std::uint32_t next) -> std::uint32_t {
+        if (nodes.size() > kMaxNodes) {
+            error = "pattern too large";
+            return next;
+        }
+        switch (n.kind) {
+            case AstNode::Kind::Empty:
+                return next;
+            case AstNode::Kind::Set:
+                sets.push_back(n.set);
+                return add({Node::Kind::Set, next, 0, static_cast<std::uint32_t>(sets.size() - 1)});
+            case AstNode::Kind::Bol:
+                return add({Node::Kind::Bol, next, 0, 0});
+            case AstNode::Kind::Eol:
+                return add({Node::Kind::Eol, next, 0, 0});
+            case AstNode::Kind::Concat:
+                for (auto it = n.children.rbegin(); it != n.children.rend(); ++it) next = self(self, **it, next);
+                return next;
+            case AstNode::Kind::Alt: {
+                std::uint32_t entry = self(self, *n.children.back(), next);
+                for (size_t i = n.children.size() - 1; i-- > 0;) {
+                    std::uint32_t branch = self(self, *n.children[i], next);
+                    entry = add({Node::Kind::Split, branch, entry, 0});
+                }
+                return entry;
+            }
+            case AstNode::Kind::Repeat: {
+                const AstNode& body = *n.children.front();
+                std::uint32_t tail = next;
+                if (n.max < 0) {
+                    std::uint32_t loop = add({Node::Kind::Split, 0, next, 0});
+                    std::uint32_t entry = self(self, body, loop);
+                    nodes[loop].out = entry;
+                    tail = loop;
+                } else {
+                    for (int i = n.min; i < n.max; ++i) {
+                        tail = add({Node::Kind::Split, self(self, body, tail), next, 0});
+                    }
+                }
+                for (int i = 0; i < n.min; ++i) tail = self(self, body, tail);
+                return tail;
+            }
+        }
+        return next;
+    };
+    std::uint32_t match = add({Node::Kind::Match, 0, 0, 0});
+    start = emit(emit, *ast, match);
+    if (!error.empty()) {
+        nodes.clear();
+        return;
+    }
+
+    // Byte classes: refine {everything} by '\n' and then by every byte set.
+    std::uint8_t cls[256] = {};
+    cls[static_cast<unsigned char>('\n')] = 1;
+    classCount = 2;
+    for (const auto& set : sets) {
+        std::map<std::pair<int, bool>, int> split;
+        size_t count = 0;
+        std::uint8_t refined[256];
+        for (int b = 0; b < 256; ++b) {
+            auto key = std::make_pair(static_cast<int>(cls[b]), static_cast<bool>(set[static_cast<size_t>(b)]));
+            auto it = split.find(key);
+            if (it == split.end()) it = split.emplace(key, static_cast<int>(count++)).first;
+            refined[b] = static_cast<std::uint8_t>(it->second);
+        }
+        std::memcpy(cls, refined, sizeof(cls));
+        classCount = count;
+    }
+    std::memcpy(byteClass, cls, sizeof(byteClass));
+    classSets.resize(sets.size());
+    for (int b = 0; b < 256; ++b) {
+        for (size_t s = 0; s < sets.size(); ++s) {
+            if (sets[s][static_cast<size_t>(b)]) classSets[s].set(byteClass[b]);
+        }
+    }
+}
+
+RegexGrep::RegexGrep(const std::string& pattern) : program(std::make_unique<RegexProgram>(pattern)) {}
+
+RegexGrep::~RegexGrep() = default;
+
+bool RegexGrep::searchFile(const std::string& filename) {
+    if (!isValid()) {
+        return false;
+    }
+    if (!readWholeFile(filename, contents)) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+    searchText(contents);
+    return true;
+}
+
+void RegexGrep::searchText(std::string_view input) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    text = input;
+    matches.clear();
+    stats = Stats();
+
+    const size_t n = text.size();
+    const size_t threads = static_cast<size_t>(omp_get_max_threads());
+    const std::vector<size_t> bounds = splitAtLines(text, threads * kChunksPerThread, kMinChunkBytes);
+    const size_t chunks = bounds.size() - 1;
+    chunkCount = chunks;
+
+    std::vector<ChunkResult> results(chunks);
+    std::atomic<size_t> next{0};
+    std::mutex statsLock;
+    pg_runtime::parallelRegion([&](int, int) {
+        if (!program->isValid()) {
+            for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+                results[c].newlines = simd::countByte(text.data() + bounds[c], bounds[c + 1] - bounds[c], '\n');
+            }
+            return;
+        }
+        LazyDfa dfa(*program, cacheBudget);
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            scanChunk(text, bounds[c], bounds[c + 1], program->getRequiredLiteral(), dfa, results[c]);
+        }
+        std::lock_guard<std::mutex> guard(statsLock);
+        stats.dfaStates += dfa.statesBuilt;
+        stats.cacheFlushes += dfa.flushes;
+    });
+
+    // Exclusive prefix sum of chunk newline counts gives each chunk's first line.
+    unsigned long long firstLine = 1;
+    size_t lineCount = 0;
+    for (const auto& r : results) lineCount += r.lines.size();
+    matches.reserve(lineCount);
+    for (const auto& r : results) {
+        for (const auto& m : r.lines) {
+            matches.push_back({firstLine + m.lineNumber, m.offset, m.length});
+        }
+        firstLine += r.newlines;
+        stats.linesScanned += r.linesScanned;
+    }
+    totalLines = (firstLine - 1) + (n > 0 && text.back() != '\n' ? 1 : 0);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+void RegexGrep::saveResults(const std::string& filename) const {
+    std::ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Cannot create output file " << filename << std::endl;
+        return;
+    }
+    for (const auto& m : matches) {
+        outFile << m.lineNumber << ':' << line(m) << '\n';
+    }
+    outFile.close();
+    std::cout << "Results saved to: " << filename << std::endl;
+}
@@ -0,0 +1,127 @@
+#ifndef REGEX_GREP_H
+#define REGEX_GREP_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Compiled form of a regex, shared read-only by every scanning thread.
+ *
+ * Supported syntax (POSIX ERE subset, bytes not code points): literals,
+ * `.`, `[...]` / `[^...]` with ranges and POSIX classes (`[[:alpha:]]`),
+ * `\d \w \s \D \W \S` and escaped metacharacters, grouping `( )`,
+ * alternation `|`, `* + ?`, `{m}`, `{m,}`, `{m,n}`, and the line anchors `^`
+ * and `$`. `.` and negated classes never match '\n'.
+ *
+ * The pattern becomes a Thompson NFA over byte classes (bytes no construct
+ * tells apart share a class). Each thread then builds its own lazy DFA over
+ * that NFA (see RegexGrep), so the program needs no locking.
+ */
+class RegexProgram {
+public:
+    struct Node {
+        enum class Kind : std::uint8_t { Set, Split, Bol, Eol, Match } kind;
+        std::uint32_t out = 0;
+        std::uint32_t out1 = 0;  // Split only
+        std::uint32_t set = 0;   // Set only: index into sets
+    };
+
+    /** @brief Compile; check isValid()/getError() afterwards. */
+    explicit RegexProgram(const std::string& pattern);
+
+    bool isValid() const { return error.empty(); }
+    const std::string& getError() const { return error; }
+
+    /**
+     * @brief Longest literal every match must contain (may be empty). Lines
+     *        without it cannot match, so the scan jumps between occurrences.
+     */
+    const std::string& getRequiredLiteral() const { return requiredLiteral; }
+
+    const std::vector<Node>& getNodes() const { return nodes; }
+    std::uint32_t getStart() const { return start; }
+    size_t getClassCount() const { return classCount; }
+    std::uint8_t classOf(unsigned char byte) const { return byteClass[byte]; }
+    std::uint8_t newlineClass() const { return byteClass[static_cast<unsigned char>('\n')]; }
+    /** @brief Whether Set node `node` accepts bytes of class `cls`. */
+    bool accepts(std::uint32_t node, size_t cls) const { return classSets[nodes[node].set][cls]; }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<std::bitset<256>> sets;       // byte sets, by Node::set
+    std::vector<std::bitset<256>> classSets;  // the same sets, indexed by class
+    std::uint8_t byteClass[256] = {};
+    size_t classCount = 1;
+    std::uint32_t start = 0;
+    std::string requiredLiteral;
+    std::string error;
+};
+
+/**
+ * @brief Parallel regex search, grep -n -E style: reports matching lines.
+ *
+ * Chunks end on line boundaries (as in LiteralGrep), so `^` and `$` see real
+ * line starts and ends in every chunk. Each thread keeps a private lazy DFA
+ * cache: states are NFA-node sets created on first use and flushed when the
+ * cache outgrows its budget, so rare patterns never pay for a full subset
+ * construction. When the pattern has a required literal, the SIMD literal
+ * search picks candidate lines and the DFA only runs on those.
+ */
+class RegexGrep {
+public:
+    struct MatchLine {
+        unsigned long long lineNumber;  // 1-based
+        size_t offset;                  // line start in the searched text
+        size_t length;                  // without the trailing '\n'
+    };
+
+    struct Stats {
+        size_t dfaStates = 0;      // states built, summed over threads
+        size_t cacheFlushes = 0;   // times a thread's cache hit its budget
+        size_t linesScanned = 0;   // lines the DFA actually ran on
+    };
+
+    explicit RegexGrep(const std::string& pattern);
+    ~RegexGrep();
+
+    bool isValid() const { return program->isValid(); }
+    const std::string& getError() const { return program->getError(); }
+    const std::string& getRequiredLiteral() const { return program->getRequiredLiteral(); }
+
+    /** @return false if the pattern is invalid or the file cannot be read */
+    bool searchFile(const std::string& filename);
+    /** @brief Search text; it must outlive calls to line(). */
+    void searchText(std::string_view text);
+
+    const std::vector<MatchLine>& getMatches() const { return matches; }
+    std::string_view line(const MatchLine& match) const { return text.substr(match.offset, match.length); }
+
+    /** @brief Write "lineNumber:line" for every matching line. */
+    void saveResults(const std::string& filename) const;
+
+    unsigned long long getTotalLines() const { return totalLines; }
+    size_t getChunkCount() const { return chunkCount; }
+    const Stats& getStats() const { return stats; }
+    double getExecutionTime() const { return executionTime; }
+
+    /** @brief Bytes of transition table each thread may cache before flushing. */
+    void setCacheBudget(size_t bytes) { cacheBudget = bytes; }
+
+private:
+    std::unique_ptr<RegexProgram> program;
+    std::string contents;  // owned input for searchFile
+    std::string_view text;
+    std::vector<MatchLine> matches;
+    unsigned long long totalLines = 0;
+    size_t chunkCount = 0;
+    size_t cacheBudget = 2 * 1024 * 1024;
+    Stats stats;
+    double executionTime = 0.0;
+};
+
+#endif // REGEX_GREP_H
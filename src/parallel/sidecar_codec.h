@@ -0,0 +1,49 @@
+#ifndef SIDECAR_CODEC_H
+#define SIDECAR_CODEC_H
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+/**
+ * @brief Helpers shared by the sidecar files (positional index, block
+ *        summary, line index) and the word tables that build them.
+ */
+
+/** @brief Append v as a LEB128 varint (7 bits per byte, high bit = more). */
+inline void putVarint(std::string& out, unsigned long long v) {
+    while (v >= 0x80) {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+/** @brief Decode a varint at p, advancing it; false if truncated or longer than 64 bits. */
+inline bool getVarint(const char*& p, const char* end, unsigned long long& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(*p++);
+        v |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+/** @brief Transparent string hash: maps keyed by std::string can be probed with a string_view. */
+struct TermHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+/** @brief Last write time of a file in filesystem clock ticks, 0 if unknown. */
+inline long long modifiedTime(const std::string& filename) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(filename, ec);
+    return ec ? 0 : static_cast<long long>(time.time_since_epoch().count());
+}
+
+#endif // SIDECAR_CODEC_H
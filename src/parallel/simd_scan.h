@@ -0,0 +1,146 @@
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Byte-scanning kernels for the grep modes.
+ *
+ * Each kernel has an AVX2 path (the default -march=native build on x86), an
+ * SSE2 path and a scalar fallback; the path is picked at compile time, so a
+ * build without -march=native still gets SSE2 on x86-64.
+ */
+namespace simd {
+
+#if defined(__AVX2__)
+constexpr size_t kWidth = 32;
+#elif defined(__SSE2__)
+constexpr size_t kWidth = 16;
+#else
+constexpr size_t kWidth = 0;
+#endif
+
+inline const char* kernelName() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+#if defined(__AVX2__)
+using Vec = __m256i;
+inline Vec load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+inline Vec splat(char c) { return _mm256_set1_epi8(c); }
+inline unsigned eqMask(Vec a, Vec b) { return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))); }
+#elif defined(__SSE2__)
+using Vec = __m128i;
+inline Vec load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline Vec splat(char c) { return _mm_set1_epi8(c); }
+inline unsigned eqMask(Vec a, Vec b) { return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))); }
+#endif
+
+/**
+ * @brief Number of bytes equal to c in [data, data + n).
+ */
+inline size_t countByte(const char* data, size_t n, char c) {
+    size_t count = 0;
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    const Vec needle = splat(c);
+    for (; i + kWidth <= n; i += kWidth) {
+        count += static_cast<size_t>(std::popcount(eqMask(load(data + i), needle)));
+    }
+#endif
+    for (; i < n; ++i) {
+        count += data[i] == c;
+    }
+    return count;
+}
+
+/**
+ * @brief Offset of the k-th (1-based) byte equal to c in [data, data + n),
+ *        or n if there are fewer than k. Whole vectors are skipped by
+ *        popcount, so stepping over many lines costs about one countByte.
+ */
+inline size_t findNthByte(const char* data, size_t n, char c, size_t k) {
+    if (k == 0) {
+        return n;
+    }
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    const Vec needle = splat(c);
+    for (; i + kWidth <= n; i += kWidth) {
+        unsigned mask = eqMask(load(data + i), needle);
+        size_t count = static_cast<size_t>(std::popcount(mask));
+        if (count >= k) {
+            while (--k > 0) mask &= mask - 1;
+            return i + static_cast<size_t>(std::countr_zero(mask));
+        }
+        k -= count;
+    }
+#endif
+    for (; i < n; ++i) {
+        if (data[i] == c && --k == 0) {
+            return i;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Offset of the first occurrence of needle in [data, data + n), or n.
+ *
+ * Candidate filter: compare the needle's first and last bytes against two
+ * overlapping loads kWidth positions at a time, and memcmp only the
+ * positions where both agree (Mula's "generic SIMD" substring search).
+ */
+inline size_t findLiteral(const char* data, size_t n, std::string_view needle) {
+    const size_t m = needle.size();
+    if (m == 0) {
+        return 0;
+    }
+    if (m > n) {
+        return n;
+    }
+    if (m == 1) {
+        const void* hit = std::memchr(data, needle[0], n);
+        return hit != nullptr ? static_cast<size_t>(static_cast<const char*>(hit) - data) : n;
+    }
+    const size_t last = n - m;  // last valid start
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    const Vec first = splat(needle.front());
+    const Vec lastByte = splat(needle.back());
+    for (; i + kWidth - 1 <= last; i += kWidth) {
+        unsigned mask = eqMask(load(data + i), first) & eqMask(load(data + i + m - 1), lastByte);
+        while (mask != 0) {
+            size_t pos = i + static_cast<size_t>(std::countr_zero(mask));
+            if (std::memcmp(data + pos + 1, needle.data() + 1, m - 2) == 0) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i <= last; ++i) {
+        if (data[i] == needle.front() && data[i + m - 1] == needle.back() &&
+            std::memcmp(data + i + 1, needle.data() + 1, m - 2) == 0) {
+            return i;
+        }
+    }
+    return n;
+}
+
+} // namespace simd
+
+#endif // SIMD_SCAN_H
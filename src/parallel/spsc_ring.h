@@ -0,0 +1,79 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free single-producer / single-consumer queue.
+ *
+ * Exactly one thread may push and exactly one other thread may pop. Head and
+ * tail live on separate cache lines, and each side caches the other side's
+ * index so it only touches the shared line when the ring looks full/empty.
+ * A full ring makes tryPush fail, which is the producer's backpressure signal.
+ */
+template <typename T>
+class SpscRing {
+public:
+    /** @param capacity Rounded up to a power of two (minimum 2) */
+    explicit SpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /** @brief Producer only. Moves from value on success; false if full. */
+    bool tryPush(T& value) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) return false;
+        }
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Consumer only. False if empty. */
+    bool tryPop(T& out) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        out = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Producer only: no more pushes will follow. */
+    void close() { closed.store(true, std::memory_order_release); }
+
+    /**
+     * @brief Consumer only: true once the producer closed the ring and every
+     *        item has been popped. Check it after a failed tryPop.
+     */
+    bool finished() {
+        if (!closed.load(std::memory_order_acquire)) return false;
+        // Pushes happen-before close(), so the tail is final now.
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> slots;
+    size_t mask = 0;
+
+    alignas(64) std::atomic<size_t> head{0};  // written by the consumer
+    size_t cachedTail = 0;                    // consumer's view of tail
+    alignas(64) std::atomic<size_t> tail{0};  // written by the producer
+    size_t cachedHead = 0;                    // producer's view of head
+    alignas(64) std::atomic<bool> closed{false};
+};
+
+#endif // SPSC_RING_H
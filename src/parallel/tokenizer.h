@@ -0,0 +1,79 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cctype>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Buffer tokenizer shared by the modes that scan raw text.
+ *
+ * Splits on the same whitespace set as `std::istream >> word` and normalizes
+ * exactly like WordCounterParallel::normalizeWord (keep letters, lowercase),
+ * so every mode agrees with the classic counter on what a word is.
+ */
+namespace tokenizer {
+
+inline bool isSpace(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+/**
+ * @brief Normalize one raw token into `out` (cleared first).
+ */
+inline void normalize(std::string_view token, std::string& out) {
+    out.clear();
+    for (char c : token) {
+        if (std::isalpha(static_cast<unsigned char>(c))) {
+            out += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+}
+
+/**
+ * @brief Call fn(std::string_view rawToken, size_t offset) for each
+ *        whitespace-delimited token in text.
+ */
+template <typename Fn>
+void forEachToken(std::string_view text, Fn&& fn) {
+    size_t i = 0;
+    const size_t n = text.size();
+    while (i < n) {
+        while (i < n && isSpace(text[i])) ++i;
+        size_t start = i;
+        while (i < n && !isSpace(text[i])) ++i;
+        if (i > start) {
+            fn(text.substr(start, i - start), start);
+        }
+    }
+}
+
+/**
+ * @brief Call fn(std::string_view word) for each non-empty normalized word.
+ * @param scratch Reused buffer; the view passed to fn points into it.
+ */
+template <typename Fn>
+void forEachWord(std::string_view text, std::string& scratch, Fn&& fn) {
+    forEachToken(text, [&](std::string_view token, size_t) {
+        normalize(token, scratch);
+        if (!scratch.empty()) {
+            fn(std::string_view(scratch));
+        }
+    });
+}
+
+/**
+ * @brief Move pos forward to the first byte after the token straddling it,
+ *        so a chunk starting there never begins mid-word.
+ */
+inline size_t alignToTokenStart(std::string_view text, size_t pos) {
+    if (pos >= text.size()) {
+        return text.size();
+    }
+    while (pos > 0 && pos < text.size() && !isSpace(text[pos - 1])) ++pos;
+    return pos;
+}
+
+} // namespace tokenizer
+
+#endif // TOKENIZER_H
@@ -0,0 +1,281 @@
+#include "topology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace topology {
+
+namespace {
+
+bool readLine(const std::string& path, std::string& line) {
+    std::ifstream in(path);
+    return in.is_open() && static_cast<bool>(std::getline(in, line));
+}
+
+std::vector<int> allCpus() {
+    std::vector<int> cpus;
+    int count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int c = 0; c < count; ++c) cpus.push_back(c);
+    return cpus;
+}
+
+} // namespace
+
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part.empty()) continue;
+        size_t dash = part.find('-');
+        try {
+            int first = std::stoi(part.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(part.substr(dash + 1));
+            for (int c = first; c <= last; ++c) cpus.push_back(c);
+        } catch (const std::exception&) {
+            // Malformed entry: ignore it rather than fail detection.
+        }
+    }
+    return cpus;
+}
+
+std::vector<NumaNode> detectNumaNodes() {
+    std::vector<NumaNode> nodes;
+#if defined(__linux__)
+    std::string online;
+    if (readLine("/sys/devices/system/node/online", online)) {
+        for (int id : parseCpuList(online)) {
+            std::string cpuList;
+            if (!readLine("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist", cpuList)) {
+                continue;
+            }
+            NumaNode node{id, parseCpuList(cpuList)};
+            if (!node.cpus.empty()) nodes.push_back(std::move(node));
+        }
+    }
+#endif
+    if (nodes.empty()) {
+        nodes.push_back({0, allCpus()});
+    }
+    return nodes;
+}
+
+std::vector<CpuInfo> detectCpus() {
+    std::vector<CpuInfo> cpus;
+    std::map<int, int> nodeOfCpu;
+    for (const auto& node : detectNumaNodes()) {
+        for (int c : node.cpus) nodeOfCpu[c] = node.id;
+    }
+
+#if defined(__linux__)
+    // Only CPUs this process may run on (containers and taskset narrow the set).
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    std::string online;
+    if (readLine("/sys/devices/system/cpu/online", online)) {
+        for (int c : parseCpuList(online)) {
+            if (haveMask && c < CPU_SETSIZE && !CPU_ISSET(c, &allowed)) continue;
+            std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(c) + "/topology/";
+            std::string core, package;
+            CpuInfo info{c, c, 0, nodeOfCpu.count(c) ? nodeOfCpu[c] : 0};
+            try {
+                if (readLine(base + "core_id", core)) info.core = std::stoi(core);
+                if (readLine(base + "physical_package_id", package)) info.package = std::stoi(package);
+            } catch (const std::exception&) {
+                // Keep the per-CPU defaults: every CPU its own core.
+            }
+            cpus.push_back(info);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        for (int c : allCpus()) cpus.push_back({c, c, 0, 0});
+    }
+    return cpus;
+}
+
+bool parsePlacement(const std::string& spec, Placement& placement, std::vector<int>& explicitCpus) {
+    explicitCpus.clear();
+    if (spec == "auto") placement = Placement::Auto;
+    else if (spec == "none") placement = Placement::None;
+    else if (spec == "compact") placement = Placement::Compact;
+    else if (spec == "scatter") placement = Placement::Scatter;
+    else if (spec == "cores") placement = Placement::PhysicalCores;
+    else {
+        explicitCpus = parseCpuList(spec);
+        placement = Placement::Explicit;
+        return !explicitCpus.empty();
+    }
+    return true;
+}
+
+std::vector<int> planPlacement(Placement placement, int numThreads, const std::vector<int>& explicitCpus) {
+    if (placement == Placement::None) return {};
+    if (placement == Placement::Explicit) return explicitCpus;
+
+    auto cpus = detectCpus();
+    // Group SMT siblings: one entry per (package, core), siblings in CPU order.
+    std::map<std::pair<int, int>, std::vector<int>> cores;
+    for (const auto& info : cpus) cores[{info.package, info.core}].push_back(info.cpu);
+
+    std::vector<int> plan;
+    if (placement == Placement::Compact) {
+        for (const auto& [key, siblings] : cores) plan.insert(plan.end(), siblings.begin(), siblings.end());
+    } else if (placement == Placement::PhysicalCores) {
+        for (const auto& [key, siblings] : cores) plan.push_back(siblings.front());
+    } else {
+        // Auto and Scatter: sibling level 0 of every core, then level 1, ...
+        size_t maxSiblings = 0;
+        std::map<int, std::vector<const std::vector<int>*>> byPackage;
+        for (const auto& [key, siblings] : cores) {
+            byPackage[key.first].push_back(&siblings);
+            maxSiblings = std::max(maxSiblings, siblings.size());
+        }
+        for (size_t level = 0; level < maxSiblings; ++level) {
+            if (placement == Placement::Auto) {
+                for (const auto& [pkg, list] : byPackage) {
+                    for (const auto* siblings : list) {
+                        if (level < siblings->size()) plan.push_back((*siblings)[level]);
+                    }
+                }
+            } else {
+                size_t maxCores = 0;
+                for (const auto& [pkg, list] : byPackage) maxCores = std::max(maxCores, list.size());
+                for (size_t i = 0; i < maxCores; ++i) {
+                    for (const auto& [pkg, list] : byPackage) {
+                        if (i < list.size() && level < list[i]->size()) plan.push_back((*list[i])[level]);
+                    }
+                }
+            }
+        }
+    }
+
+    if (numThreads > 0 && plan.size() > static_cast<size_t>(numThreads)) {
+        plan.resize(static_cast<size_t>(numThreads));
+    }
+    return plan;
+}
+
+const char* placementName(Placement placement) {
+    switch (placement) {
+        case Placement::None: return "none";
+        case Placement::Auto: return "auto";
+        case Placement::Compact: return "compact";
+        case Placement::Scatter: return "scatter";
+        case Placement::PhysicalCores: return "cores";
+        case Placement::Explicit: return "explicit";
+    }
+    return "unknown";
+}
+
+std::string describePlan(const std::vector<int>& plan) {
+    if (plan.empty()) return "OS-managed";
+    std::map<int, CpuInfo> info;
+    for (const auto& c : detectCpus()) info[c.cpu] = c;
+
+    std::ostringstream out;
+    for (size_t i = 0; i < plan.size(); ++i) {
+        if (i > 0) out << ' ';
+        out << plan[i];
+        auto it = info.find(plan[i]);
+        if (it != info.end()) out << "(c" << it->second.core << "/p" << it->second.package << ")";
+    }
+    return out.str();
+}
+
+bool pinCurrentThread(int cpu) {
+    if (cpu < 0) return false;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    return false;
+#endif
+}
+
+ScopedPin::ScopedPin(int cpu) {
+    if (cpu < 0) return;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (CPU_ISSET(c, &set)) previous.push_back(c);
+    }
+    if (!pinCurrentThread(cpu)) previous.clear();
+#elif defined(_WIN32)
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return;
+    DWORD_PTR old = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+    for (int c = 0; c < static_cast<int>(sizeof(DWORD_PTR) * 8); ++c) {
+        if (old & (DWORD_PTR(1) << c)) previous.push_back(c);
+    }
+#endif
+}
+
+ScopedPin::~ScopedPin() {
+    if (previous.empty()) return;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : previous) CPU_SET(c, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int c : previous) mask |= DWORD_PTR(1) << c;
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+#endif
+}
+
+int currentCpu() {
+#if defined(__linux__)
+    return sched_getcpu();
+#elif defined(_WIN32)
+    return static_cast<int>(GetCurrentProcessorNumber());
+#else
+    return -1;
+#endif
+}
+
+size_t pageSize() {
+#if defined(__linux__)
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : 4096;
+#else
+    return 4096;
+#endif
+}
+
+bool queryPageNodes(const std::vector<void*>& pages, std::vector<int>& nodes) {
+    nodes.assign(pages.size(), -1);
+#if defined(__linux__) && defined(SYS_move_pages)
+    if (pages.empty()) return true;
+    // move_pages with a null target list only reports where each page lives.
+    long rc = syscall(SYS_move_pages, 0, static_cast<unsigned long>(pages.size()),
+                      const_cast<void**>(pages.data()), nullptr, nodes.data(), 0);
+    return rc == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace topology
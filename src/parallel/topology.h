@@ -0,0 +1,107 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Host topology queries and thread pinning.
+ *
+ * Linux reads sysfs and uses raw syscalls (no libnuma dependency). Other
+ * platforms report a single node holding every CPU, and page-placement
+ * queries report "unavailable".
+ */
+namespace topology {
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+};
+
+struct CpuInfo {
+    int cpu;
+    int core;     // core_id within the package
+    int package;  // physical socket
+    int node;     // NUMA node
+};
+
+/**
+ * @brief Thread placement policies.
+ *
+ * Auto         physical cores first (package by package), SMT siblings only
+ *              once every core has a thread
+ * Compact      fill each core's SMT siblings before moving to the next core
+ * Scatter      round-robin across packages, one thread per core, then siblings
+ * PhysicalCores one thread per physical core; extra threads wrap around
+ * Explicit     the given CPU list, in order
+ * None         leave placement to the OS
+ */
+enum class Placement { None, Auto, Compact, Scatter, PhysicalCores, Explicit };
+
+/** @brief Parse a sysfs CPU list such as "0-3,8-11". */
+std::vector<int> parseCpuList(const std::string& list);
+
+/** @brief NUMA nodes with their online CPUs; never empty. */
+std::vector<NumaNode> detectNumaNodes();
+
+/**
+ * @brief Online CPUs the calling thread may run on, with core/package/node
+ *        ids, sorted by CPU number; never empty. Call before pinning.
+ */
+std::vector<CpuInfo> detectCpus();
+
+/**
+ * @brief Parse "auto", "none", "compact", "scatter", "cores" or an explicit
+ *        CPU list ("0,2,4-7").
+ * @return false on an unknown policy or empty list
+ */
+bool parsePlacement(const std::string& spec, Placement& placement, std::vector<int>& explicitCpus);
+
+/**
+ * @brief CPUs to use, one entry per thread slot; thread t runs on
+ *        plan[t % plan.size()]. Empty for Placement::None.
+ */
+std::vector<int> planPlacement(Placement placement, int numThreads, const std::vector<int>& explicitCpus = {});
+
+const char* placementName(Placement placement);
+
+/** @brief Human-readable plan, e.g. "0(c0/p0) 2(c1/p0)". */
+std::string describePlan(const std::vector<int>& plan);
+
+/** @brief Pin the calling thread to one CPU. @return false if unsupported or refused */
+bool pinCurrentThread(int cpu);
+
+/**
+ * @brief Pins the calling thread to one CPU (none if cpu < 0) and restores
+ *        its previous CPU mask when destroyed, so a thread that goes on to
+ *        create others (the caller of a parallel region, a pooled OpenMP
+ *        thread) does not hand the pin down to them.
+ */
+class ScopedPin {
+public:
+    explicit ScopedPin(int cpu);
+    ~ScopedPin();
+    ScopedPin(const ScopedPin&) = delete;
+    ScopedPin& operator=(const ScopedPin&) = delete;
+
+private:
+    std::vector<int> previous;  // CPUs of the saved mask; empty = nothing to restore
+};
+
+/** @brief CPU the calling thread is running on, or -1. */
+int currentCpu();
+
+/** @brief Size of a virtual memory page in bytes. */
+size_t pageSize();
+
+/**
+ * @brief Look up the NUMA node backing each page address.
+ * @param nodes Filled with one node per page (negative = not resident / error)
+ * @return false if the platform cannot answer
+ */
+bool queryPageNodes(const std::vector<void*>& pages, std::vector<int>& nodes);
+
+} // namespace topology
+
+#endif // TOPOLOGY_H
@@ -0,0 +1,192 @@
+#include "windowed_counter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+WindowedWordCounter::WindowedWordCounter(long long windowSeconds, size_t bucketCount,
+                                         WordCounterParallel::SyncMethod mode)
+    : windowSeconds(std::max(1LL, windowSeconds)),
+      bucketSeconds(std::max(1LL, windowSeconds / static_cast<long long>(std::max<size_t>(1, bucketCount)))),
+      bucketCount(std::max<size_t>(1, bucketCount)),
+      counter(mode) {}
+
+bool WindowedWordCounter::addLine(long long timestamp, const std::string& line) {
+    bool changed = advanceTo(timestamp);
+    if (!hasOpen) {
+        openStart = timestamp - (timestamp % bucketSeconds);
+        hasOpen = true;
+    }
+    // Late lines (timestamp before the open bucket) are folded into it.
+    openText.append(line);
+    openText.push_back('\n');
+    return changed;
+}
+
+bool WindowedWordCounter::advanceTo(long long timestamp) {
+    if (!hasOpen || timestamp < openStart + bucketSeconds) {
+        return false;
+    }
+    auto startTime = std::chrono::high_resolution_clock::now();
+    lastChangedKeys = 0;
+
+    closeOpenBucket();
+    // Skip over empty buckets so a quiet period still expires old counts.
+    long long currentStart = timestamp - (timestamp % bucketSeconds);
+    windowEnd = currentStart;
+    expireBefore(windowEnd - windowSeconds);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    lastUpdateTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return true;
+}
+
+bool WindowedWordCounter::flush() {
+    if (!hasOpen) {
+        return false;
+    }
+    auto startTime = std::chrono::high_resolution_clock::now();
+    lastChangedKeys = 0;
+
+    long long end = openStart + bucketSeconds;
+    closeOpenBucket();
+    windowEnd = end;
+    expireBefore(windowEnd - windowSeconds);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    lastUpdateTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return true;
+}
+
+void WindowedWordCounter::closeOpenBucket() {
+    Bucket bucket;
+    bucket.start = openStart;
+    bucket.counts = counter.countWords(openText);
+    bucket.total = counter.getTotalWords();
+
+    for (const auto& [word, freq] : bucket.counts) {
+        applyDelta(word, freq, true);
+    }
+    windowTotal += bucket.total;
+    ring.push_back(std::move(bucket));
+
+    openText.clear();
+    hasOpen = false;
+}
+
+void WindowedWordCounter::expireBefore(long long cutoff) {
+    // A window holds at most bucketCount buckets even if bucket width rounds down.
+    while (!ring.empty() && (ring.front().start < cutoff || ring.size() > bucketCount)) {
+        const Bucket& oldest = ring.front();
+        for (const auto& [word, freq] : oldest.counts) {
+            applyDelta(word, freq, false);
+        }
+        windowTotal -= oldest.total;
+        ring.pop_front();
+    }
+}
+
+void WindowedWordCounter::applyDelta(const std::string& word, unsigned long long amount, bool add) {
+    ++lastChangedKeys;
+    auto it = windowCounts.find(word);
+    if (it == windowCounts.end()) {
+        if (!add) {
+            return;
+        }
+        it = windowCounts.emplace(word, amount).first;
+        ranking.emplace(amount, &it->first);
+        return;
+    }
+
+    ranking.erase({it->second, &it->first});
+    if (add) {
+        it->second += amount;
+    } else {
+        it->second -= std::min(amount, it->second);
+    }
+
+    if (it->second == 0) {
+        windowCounts.erase(it);
+    } else {
+        ranking.emplace(it->second, &it->first);
+    }
+}
+
+WindowedWordCounter::WordList WindowedWordCounter::getTopWords(size_t k) const {
+    WordList top;
+    top.reserve(std::min(k, ranking.size()));
+    for (auto it = ranking.begin(); it != ranking.end() && top.size() < k; ++it) {
+        top.emplace_back(*it->second, it->first);
+    }
+    return top;
+}
+
+namespace {
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm).
+long long daysFromCivil(long long y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const long long era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+constexpr size_t kMinEpochDigits = 9;
+constexpr size_t kMaxEpochDigits = 10;
+
+bool readDigits(const std::string& s, size_t& pos, size_t count, long long& value) {
+    value = 0;
+    for (size_t i = 0; i < count; ++i, ++pos) {
+        if (pos >= s.size() || !std::isdigit(static_cast<unsigned char>(s[pos]))) {
+            return false;
+        }
+        value = value * 10 + (s[pos] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+bool WindowedWordCounter::parseTimestamp(const std::string& line, long long& timestamp, std::string& rest) {
+    size_t pos = 0;
+    long long year, month, day, hour, minute, second;
+
+    // ISO-8601: YYYY-MM-DD[T ]HH:MM:SS[.fff][Z]
+    if (readDigits(line, pos, 4, year) && pos < line.size() && line[pos++] == '-' &&
+        readDigits(line, pos, 2, month) && pos < line.size() && line[pos++] == '-' &&
+        readDigits(line, pos, 2, day) && pos < line.size() && (line[pos] == 'T' || line[pos] == ' ') &&
+        readDigits(line, ++pos, 2, hour) && pos < line.size() && line[pos++] == ':' &&
+        readDigits(line, pos, 2, minute) && pos < line.size() && line[pos++] == ':' &&
+        readDigits(line, pos, 2, second)) {
+        if (pos < line.size() && line[pos] == '.') {
+            ++pos;
+            while (pos < line.size() && std::isdigit(static_cast<unsigned char>(line[pos]))) ++pos;
+        }
+        if (pos < line.size() && line[pos] == 'Z') ++pos;
+        timestamp = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86400 +
+                    hour * 3600 + minute * 60 + second;
+        rest = line.substr(pos);
+        return true;
+    }
+
+    // Epoch seconds, optionally fractional. Only 9 or 10 digits (1973-2286)
+    // count: a line such as "404 not found" merely starts with a number.
+    pos = 0;
+    long long value = 0;
+    while (pos < line.size() && std::isdigit(static_cast<unsigned char>(line[pos])) && pos <= kMaxEpochDigits) {
+        value = value * 10 + (line[pos++] - '0');
+    }
+    if (pos < kMinEpochDigits || pos > kMaxEpochDigits ||
+        (pos < line.size() && line[pos] != '.' && !std::isspace(static_cast<unsigned char>(line[pos])))) {
+        return false;
+    }
+    if (pos < line.size() && line[pos] == '.') {
+        ++pos;
+        while (pos < line.size() && std::isdigit(static_cast<unsigned char>(line[pos]))) ++pos;
+    }
+    timestamp = value;
+    rest = line.substr(pos);
+    return true;
+}
@@ -0,0 +1,113 @@
+#ifndef WINDOWED_COUNTER_H
+#define WINDOWED_COUNTER_H
+
+#include "word_counter_parallel.h"
+
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Time-bucketed sliding-window word counts for log streams.
+ *
+ * The window is a ring of fixed-width buckets. Lines are buffered into the
+ * open bucket; when time moves past it the bucket is counted with
+ * WordCounterParallel, added to the window totals, and the oldest bucket is
+ * subtracted once it falls out of the window (O(bucket vocabulary)).
+ *
+ * The window ranking is kept in an ordered index updated only for the keys a
+ * bucket touches, so getTopWords() costs O(K) instead of a full sort.
+ */
+class WindowedWordCounter {
+public:
+    using WordMap = WordCounterParallel::WordMap;
+    using WordList = std::vector<std::pair<std::string, unsigned long long>>;
+
+    /**
+     * @param windowSeconds Window length (e.g. 300 for "last 5 minutes")
+     * @param bucketCount Buckets per window; bucket width = windowSeconds / bucketCount
+     */
+    WindowedWordCounter(long long windowSeconds, size_t bucketCount,
+                        WordCounterParallel::SyncMethod mode = WordCounterParallel::SyncMethod::Reduction);
+
+    /**
+     * @brief Add one line stamped at `timestamp` (epoch seconds).
+     * @return true if one or more buckets were closed (the window changed)
+     */
+    bool addLine(long long timestamp, const std::string& line);
+
+    /**
+     * @brief Close every bucket that ends at or before `timestamp`.
+     * @return true if the window changed
+     */
+    bool advanceTo(long long timestamp);
+
+    /** @brief Close the open bucket regardless of time (end of stream). */
+    bool flush();
+
+    /** @brief Current window top-K, descending frequency then word. O(K). */
+    WordList getTopWords(size_t k) const;
+
+    const WordMap& getWindowCounts() const { return windowCounts; }
+    unsigned long long getWindowTotal() const { return windowTotal; }
+    long long getWindowStart() const { return windowEnd - windowSeconds; }
+    long long getWindowEnd() const { return windowEnd; }
+    long long getBucketSeconds() const { return bucketSeconds; }
+
+    /** @brief Keys whose window count changed in the last advance. */
+    size_t getLastChangedKeys() const { return lastChangedKeys; }
+    /** @brief Milliseconds spent counting and applying the last closed bucket(s). */
+    double getLastUpdateTime() const { return lastUpdateTime; }
+
+    /**
+     * @brief Split a leading timestamp off a log line.
+     *
+     * Accepts epoch seconds of 9-10 digits ("1700000000 ...", "1700000000.25 ...")
+     * or ISO-8601 UTC ("2024-05-01T12:00:00 ...", "2024-05-01 12:00:00Z ...").
+     * Any other leading number ("404 not found") is not a timestamp.
+     * @return true and set timestamp/rest if a timestamp was found
+     */
+    static bool parseTimestamp(const std::string& line, long long& timestamp, std::string& rest);
+
+private:
+    struct Bucket {
+        long long start;
+        WordMap counts;
+        unsigned long long total;
+    };
+
+    struct RankLess {
+        bool operator()(const std::pair<unsigned long long, const std::string*>& a,
+                        const std::pair<unsigned long long, const std::string*>& b) const {
+            if (a.first != b.first) return a.first > b.first;
+            return *a.second < *b.second;
+        }
+    };
+
+    long long windowSeconds;
+    long long bucketSeconds;
+    size_t bucketCount;
+    WordCounterParallel counter;
+
+    std::deque<Bucket> ring;          // closed buckets, oldest first
+    long long openStart = 0;          // start of the bucket being filled
+    bool hasOpen = false;
+    std::string openText;
+
+    WordMap windowCounts;
+    unsigned long long windowTotal = 0;
+    long long windowEnd = 0;
+    // Keys point at windowCounts nodes, which stay put across rehashing.
+    std::set<std::pair<unsigned long long, const std::string*>, RankLess> ranking;
+
+    size_t lastChangedKeys = 0;
+    double lastUpdateTime = 0.0;
+
+    void closeOpenBucket();
+    void applyDelta(const std::string& word, unsigned long long amount, bool add);
+    void expireBefore(long long cutoff);
+};
+
+#endif // WINDOWED_COUNTER_H
@@ -0,0 +1,239 @@
+#include "word_counter_c_api.h"
+#include "parallel_runtime.h"
+#include "topology.h"
+#include "word_counter_parallel.h"
+
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct pg_counter {
+    WordCounterParallel engine;
+    int numThreads;
+    std::mutex lock;  // WordCounterParallel is not thread-safe
+
+    pg_counter(WordCounterParallel::SyncMethod mode, int threads)
+        : engine(mode), numThreads(threads) {}
+};
+
+namespace {
+
+// Owns the arrays a pg_result points into; callers only ever see the base.
+struct PgResultStorage : pg_result {
+    std::string wordBytes;
+    std::vector<size_t> offsetStore;
+    std::vector<unsigned long long> countStore;
+};
+
+thread_local std::string lastError;
+
+template <typename Range>
+pg_result* packResult(const Range& entries, size_t size, unsigned long long totalWords, double executionTime) {
+    auto* storage = new PgResultStorage();
+    storage->offsetStore.reserve(size + 1);
+    storage->countStore.reserve(size);
+
+    for (const auto& [word, freq] : entries) {
+        storage->offsetStore.push_back(storage->wordBytes.size());
+        storage->wordBytes.append(word);
+        storage->wordBytes.push_back('\0');
+        storage->countStore.push_back(freq);
+    }
+    storage->offsetStore.push_back(storage->wordBytes.size());
+
+    storage->unique_words = storage->countStore.size();
+    storage->total_words = totalWords;
+    storage->execution_time_ms = executionTime;
+    storage->words = storage->wordBytes.c_str();
+    storage->word_offsets = storage->offsetStore.data();
+    storage->counts = storage->countStore.data();
+    return storage;
+}
+
+pg_result* finishCount(pg_counter* counter, const WordCounterParallel::WordMap& wordFreq, int topN,
+                       unsigned long long totalWords, double executionTime) {
+    if (topN > 0) {
+        auto top = counter->engine.getTopWords(wordFreq, topN);
+        return packResult(top, top.size(), totalWords, executionTime);
+    }
+    return packResult(wordFreq, wordFreq.size(), totalWords, executionTime);
+}
+
+pg_result* finishCount(pg_counter* counter, const WordCounterParallel::WordMap& wordFreq, int topN) {
+    return finishCount(counter, wordFreq, topN, counter->engine.getTotalWords(), counter->engine.getExecutionTime());
+}
+
+} // namespace
+
+extern "C" {
+
+pg_counter* pg_counter_create(int sync_method, int num_threads) {
+    WordCounterParallel::SyncMethod mode;
+    switch (sync_method) {
+        case PG_SYNC_CRITICAL: mode = WordCounterParallel::SyncMethod::Critical; break;
+        case PG_SYNC_ATOMIC: mode = WordCounterParallel::SyncMethod::Atomic; break;
+        case PG_SYNC_REDUCTION: mode = WordCounterParallel::SyncMethod::Reduction; break;
+        default:
+            lastError = "unknown sync method";
+            return nullptr;
+    }
+    lastError.clear();
+    return new (std::nothrow) pg_counter(mode, num_threads);
+}
+
+void pg_counter_destroy(pg_counter* counter) {
+    delete counter;
+}
+
+int pg_counter_set_placement(pg_counter* counter, const char* policy) {
+    topology::Placement placement;
+    std::vector<int> explicitCpus;
+    if (counter == nullptr || policy == nullptr || !topology::parsePlacement(policy, placement, explicitCpus)) {
+        lastError = "null counter or unknown placement policy";
+        return -1;
+    }
+    std::lock_guard<std::mutex> guard(counter->lock);
+    int threads = counter->numThreads > 0 ? counter->numThreads : omp_get_max_threads();
+    counter->engine.setThreadPlacement(topology::planPlacement(placement, threads, explicitCpus));
+    lastError.clear();
+    return 0;
+}
+
+int pg_counter_set_small_threshold(pg_counter* counter, size_t bytes) {
+    if (counter == nullptr) {
+        lastError = "null counter";
+        return -1;
+    }
+    std::lock_guard<std::mutex> guard(counter->lock);
+    counter->engine.setSmallInputThreshold(bytes);
+    lastError.clear();
+    return 0;
+}
+
+int pg_counter_calibrate(pg_counter* counter, size_t* threshold) {
+    if (counter == nullptr) {
+        lastError = "null counter";
+        return -1;
+    }
+    std::lock_guard<std::mutex> guard(counter->lock);
+    if (counter->numThreads > 0) {
+        omp_set_num_threads(counter->numThreads);
+    }
+
+    try {
+        size_t chosen = counter->engine.calibrateSmallInputThreshold();
+        if (threshold != nullptr) *threshold = chosen;
+        lastError.clear();
+        return 0;
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return -1;
+    }
+}
+
+pg_result* pg_count_text(pg_counter* counter, const char* text, size_t length, int top_n) {
+    if (counter == nullptr || (text == nullptr && length > 0)) {
+        lastError = "null counter or text";
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> guard(counter->lock);
+    // omp_set_num_threads is per calling thread, so apply it on every call.
+    if (counter->numThreads > 0) {
+        omp_set_num_threads(counter->numThreads);
+    }
+
+    try {
+        auto wordFreq = counter->engine.countWords(std::string(text, length));
+        lastError.clear();
+        return finishCount(counter, wordFreq, top_n);
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return nullptr;
+    }
+}
+
+pg_result* pg_count_file(pg_counter* counter, const char* path, int top_n) {
+    if (counter == nullptr || path == nullptr) {
+        lastError = "null counter or path";
+        return nullptr;
+    }
+    // countWordsFromFile reports open failures only on stderr; check up front.
+    if (!std::ifstream(path).is_open()) {
+        lastError = std::string("cannot open file ") + path;
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> guard(counter->lock);
+    if (counter->numThreads > 0) {
+        omp_set_num_threads(counter->numThreads);
+    }
+
+    try {
+        auto wordFreq = counter->engine.countWordsFromFile(path);
+        lastError.clear();
+        return finishCount(counter, wordFreq, top_n);
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return nullptr;
+    }
+}
+
+int pg_count_batch(pg_counter* counter, const char* const* texts, const size_t* lengths, size_t count,
+                   int top_n, int per_document, pg_result** results) {
+    if (counter == nullptr || (texts == nullptr && count > 0) ||
+        (results == nullptr && (count > 0 || !per_document))) {
+        lastError = "null counter, texts or results";
+        return -1;
+    }
+    std::vector<std::string_view> docs(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t length = lengths != nullptr ? lengths[i] : (texts[i] != nullptr ? std::strlen(texts[i]) : 0);
+        if (texts[i] == nullptr && length > 0) {
+            lastError = "null text in batch";
+            return -1;
+        }
+        docs[i] = std::string_view(texts[i] != nullptr ? texts[i] : "", length);
+    }
+    std::lock_guard<std::mutex> guard(counter->lock);
+    if (counter->numThreads > 0) {
+        omp_set_num_threads(counter->numThreads);
+    }
+
+    size_t filled = 0;
+    try {
+        auto mode = per_document ? WordCounterParallel::BatchMode::PerDocument
+                                 : WordCounterParallel::BatchMode::Aggregate;
+        auto batch = counter->engine.countWordsBatch(docs, mode);
+        double elapsed = counter->engine.getExecutionTime();
+        if (per_document) {
+            for (; filled < count; ++filled) {
+                results[filled] = finishCount(counter, batch.documents[filled], top_n,
+                                              batch.documentTotals[filled], elapsed);
+            }
+        } else {
+            results[0] = finishCount(counter, batch.aggregate, top_n, counter->engine.getTotalWords(), elapsed);
+        }
+        lastError.clear();
+        return 0;
+    } catch (const std::exception& e) {
+        for (size_t i = 0; i < filled; ++i) {
+            pg_result_free(results[i]);
+            results[i] = nullptr;
+        }
+        lastError = e.what();
+        return -1;
+    }
+}
+
+void pg_result_free(pg_result* result) {
+    delete static_cast<PgResultStorage*>(result);
+}
+
+const char* pg_last_error(void) {
+    return lastError.c_str();
+}
+
+} // extern "C"
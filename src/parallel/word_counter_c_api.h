@@ -0,0 +1,112 @@
+#ifndef WORD_COUNTER_C_API_H
+#define WORD_COUNTER_C_API_H
+
+#include <stddef.h>
+
+/**
+ * @brief C ABI over WordCounterParallel for in-process callers.
+ *
+ * Results are returned as flat arrays owned by the library so that bindings
+ * (see src/python/) can expose them without copying. Every pg_result must be
+ * released with pg_result_free.
+ *
+ * Calls on one pg_counter from several threads are serialized by a lock in
+ * the counter; give each thread its own counter to count concurrently.
+ */
+
+#if defined(_WIN32)
+#  if defined(PG_BUILD_SHARED)
+#    define PG_API __declspec(dllexport)
+#  else
+#    define PG_API
+#  endif
+#else
+#  define PG_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pg_counter pg_counter;
+
+/* Mirrors WordCounterParallel::SyncMethod. */
+enum pg_sync_method {
+    PG_SYNC_CRITICAL = 0,
+    PG_SYNC_ATOMIC = 1,
+    PG_SYNC_REDUCTION = 2
+};
+
+typedef struct pg_result {
+    size_t unique_words;
+    unsigned long long total_words;
+    double execution_time_ms;        /* counting only, excludes packing and sorting */
+    const char* words;               /* unique words, NUL-terminated, back to back */
+    const size_t* word_offsets;      /* unique_words + 1 offsets into words */
+    const unsigned long long* counts; /* unique_words frequencies, parallel to word_offsets */
+} pg_result;
+
+/**
+ * @brief Create a counter. num_threads <= 0 keeps the OpenMP default.
+ * @return NULL on invalid arguments (see pg_last_error)
+ */
+PG_API pg_counter* pg_counter_create(int sync_method, int num_threads);
+PG_API void pg_counter_destroy(pg_counter* counter);
+
+/**
+ * @brief Pin counting threads: "auto", "compact", "scatter", "cores", "none"
+ *        or a CPU list such as "0,2,4-7". Counters start with "none".
+ * @return 0 on success, -1 on an unknown policy (see pg_last_error)
+ */
+PG_API int pg_counter_set_placement(pg_counter* counter, const char* policy);
+
+/**
+ * @brief Texts shorter than `bytes` are counted inline on the calling thread,
+ *        without the thread team (default 4096, at most 16384; 0 disables).
+ * @return 0 on success, -1 on a NULL counter
+ */
+PG_API int pg_counter_set_small_threshold(pg_counter* counter, size_t bytes);
+
+/**
+ * @brief Measure where inline counting stops beating this counter's thread
+ *        team on this host and use that as the small-text threshold. Takes a
+ *        few ms; call it once, after pg_counter_set_placement.
+ * @param threshold receives the chosen threshold in bytes (may be NULL)
+ * @return 0 on success, -1 on a NULL counter or failure (see pg_last_error)
+ */
+PG_API int pg_counter_calibrate(pg_counter* counter, size_t* threshold);
+
+/**
+ * @brief Count words in a text buffer.
+ * @param top_n 0 returns the whole vocabulary unsorted; > 0 returns the top N
+ *              words sorted by descending frequency
+ * @return NULL on failure (see pg_last_error)
+ */
+PG_API pg_result* pg_count_text(pg_counter* counter, const char* text, size_t length, int top_n);
+
+/** @brief Count words in a file; same top_n semantics as pg_count_text. */
+PG_API pg_result* pg_count_file(pg_counter* counter, const char* path, int top_n);
+
+/**
+ * @brief Count many small texts in one call, parallel across texts.
+ * @param lengths NULL means every text is NUL-terminated
+ * @param per_document non-zero fills results[0..count) with one result per
+ *        text; zero fills only results[0] with the aggregate over all texts
+ * @param results caller array of count (or 1) pointers, each released with
+ *        pg_result_free. execution_time_ms is for the whole batch.
+ * @return 0 on success, -1 on failure (see pg_last_error); nothing is
+ *         allocated on failure
+ */
+PG_API int pg_count_batch(pg_counter* counter, const char* const* texts, const size_t* lengths, size_t count,
+                          int top_n, int per_document, pg_result** results);
+
+PG_API void pg_result_free(pg_result* result);
+
+/** @brief Message for the last failure on the calling thread ("" if none). */
+PG_API const char* pg_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WORD_COUNTER_C_API_H
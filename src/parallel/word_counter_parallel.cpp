@@ -1,16 +1,261 @@
 #include "word_counter_parallel.h"
+#include "arena.h"
+#include "file_reader.h"
+#include "parallel_runtime.h"
+#include "tokenizer.h"
+#include "topology.h"
+#include "word_filter.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
+#ifdef PG_HAVE_PSTL
+#include <execution>
+#endif
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
-#include <omp.h>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
+
+namespace {
+
+constexpr size_t kSmallTableSlots = 4096;  // power of two
+
+struct SmallSlot {
+    std::uint32_t hash;
+    std::uint32_t offset;
+    std::uint32_t length;  // 0 = empty slot
+    std::uint32_t count;
+};
+
+// Word bytes and table for countSmallInput, allocated once per calling thread.
+struct SmallScratch {
+    std::unique_ptr<char[]> bytes{new char[WordCounterParallel::kMaxSmallInputBytes]};
+    std::unique_ptr<SmallSlot[]> slots{new SmallSlot[kSmallTableSlots]};
+};
+
+/**
+ * @brief Count a short input on the calling thread without a thread team:
+ *        normalized words are packed into one buffer and indexed by a small
+ *        open-addressing table, both reused per thread. Same tokenization as
+ *        the parallel paths.
+ * @param filter Optional word filter; rejected words are only tallied in `filtered`
+ * @return false if the input has more distinct words than the table holds
+ */
+bool countSmallInput(std::string_view text, WordCounterParallel::WordMap& wordFreq, unsigned long long& total,
+                     const WordFilter* filter, unsigned long long& filtered) {
+    thread_local SmallScratch scratch;
+    char* const bytes = scratch.bytes.get();
+    SmallSlot* const slots = scratch.slots.get();
+
+    // Size the table to the input so tiny messages only clear a few slots.
+    size_t capacity = 64;
+    while (capacity < text.size() / 2 && capacity < kSmallTableSlots) capacity <<= 1;
+    std::memset(static_cast<void*>(slots), 0, sizeof(SmallSlot) * capacity);
+    const size_t mask = capacity - 1;
+
+    size_t used = 0;
+    size_t bytesUsed = 0;
+    bool overflow = false;
+    total = 0;
+    filtered = 0;
+    tokenizer::forEachToken(text, [&](std::string_view token, size_t) {
+        if (overflow) return;
+        char* word = bytes + bytesUsed;
+        std::uint32_t length = 0;
+        std::uint32_t hash = 2166136261u;  // FNV-1a
+        for (char c : token) {
+            if (std::isalpha(static_cast<unsigned char>(c))) {
+                char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                word[length++] = lower;
+                hash = (hash ^ static_cast<unsigned char>(lower)) * 16777619u;
+            }
+        }
+        if (length == 0) return;
+        if (filter != nullptr && !filter->keeps(std::string_view(word, length))) {
+            ++filtered;
+            return;
+        }
+        ++total;
+
+        size_t i = hash & mask;
+        while (slots[i].length != 0) {
+            if (slots[i].hash == hash && slots[i].length == length &&
+                std::memcmp(bytes + slots[i].offset, word, length) == 0) {
+                ++slots[i].count;
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        slots[i] = {hash, static_cast<std::uint32_t>(bytesUsed), length, 1};
+        bytesUsed += length;
+        overflow = ++used * 10 > capacity * 7;
+    });
+    if (overflow) {
+        return false;
+    }
+
+    wordFreq.reserve(used);
+    for (size_t i = 0; i < capacity; ++i) {
+        if (slots[i].length != 0) {
+            wordFreq.emplace(std::string(bytes + slots[i].offset, slots[i].length), slots[i].count);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Times a parallel region in which every thread counts, then merges
+ *        into shared state: the count phase lasts as long as the slowest
+ *        thread's counting (its ThreadScope samples), the rest of the region
+ *        is the merge tail.
+ */
+class CountMergeRegion {
+public:
+    explicit CountMergeRegion(PhaseTimer& timer)
+        : timer(timer), start(std::chrono::steady_clock::now()), cpuStart(PhaseTimer::processCpuMs()) {}
+    ~CountMergeRegion() { stop(); }
+
+    void stop() {
+        if (stopped) return;
+        stopped = true;
+        double wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        double cpu = PhaseTimer::processCpuMs() - cpuStart;
+        double countWall = 0.0;
+        double countCpu = 0.0;
+        for (const auto& sample : timer.getThreads(PhaseTimer::Count)) {
+            countWall = std::max(countWall, sample.wallMs);
+            countCpu += sample.cpuMs;
+        }
+        countWall = std::min(countWall, wall);
+        countCpu = std::min(countCpu, cpu);
+        timer.add(PhaseTimer::Count, countWall, countCpu);
+        timer.add(PhaseTimer::Merge, wall - countWall, cpu - countCpu);
+    }
+
+private:
+    PhaseTimer& timer;
+    std::chrono::steady_clock::time_point start;
+    double cpuStart;
+    bool stopped = false;
+};
+
+} // namespace
+
+/**
+ * @brief Open-addressing word -> count table with O(1) clear: a slot is live
+ *        only if it carries the current generation, so reset() bumps the
+ *        generation and rewinds the arena holding the word bytes. Live slot
+ *        indices are kept in insertion order, so forEach() visits only the
+ *        document's words even after an outlier has grown the table.
+ */
+class WordCounterParallel::BatchTable {
+public:
+    BatchTable() : slots(1024) {}
+
+    void reset() {
+        arena.reset();
+        live.clear();
+        if (++generation == 0) {
+            // Wrapped after 2^32 resets: stale slots could look live again.
+            for (auto& slot : slots) slot.generation = 0;
+            generation = 1;
+        }
+    }
+
+    void add(std::string_view word) {
+        std::uint64_t hash = std::hash<std::string_view>{}(word);
+        size_t mask = slots.size() - 1;
+        size_t i = static_cast<size_t>(hash) & mask;
+        while (slots[i].generation == generation) {
+            Slot& s = slots[i];
+            if (s.hash == hash && s.length == word.size() && std::memcmp(s.data, word.data(), word.size()) == 0) {
+                ++s.count;
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        slots[i] = {hash, arena.copy(word).data(), static_cast<std::uint32_t>(word.size()), generation, 1};
+        live.push_back(i);
+        if (live.size() * 10 > slots.size() * 7) {
+            grow();
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t i : live) {
+            const Slot& s = slots[i];
+            fn(std::string_view(s.data, s.length), s.count);
+        }
+    }
+
+    size_t size() const { return live.size(); }
+
+private:
+    struct Slot {
+        std::uint64_t hash = 0;
+        const char* data = nullptr;
+        std::uint32_t length = 0;
+        std::uint32_t generation = 0;  // live iff == BatchTable::generation
+        unsigned long long count = 0;
+    };
+
+    std::vector<Slot> slots;
+    std::uint32_t generation = 1;
+    std::vector<size_t> live;  // indices of this generation's slots
+    Arena arena;
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for (size_t& index : live) {
+            const Slot& s = old[index];
+            size_t i = static_cast<size_t>(s.hash) & mask;
+            while (slots[i].generation == generation) i = (i + 1) & mask;
+            slots[i] = s;
+            index = i;
+        }
+    }
+};
 
 WordCounterParallel::WordCounterParallel(SyncMethod mode)
     : executionTime(0.0), totalWords(0), uniqueWords(0), syncMethod(mode) {}
 
+WordCounterParallel::~WordCounterParallel() = default;
+
+const char* WordCounterParallel::runtimeName() {
+#ifdef PG_NO_OPENMP
+    return "std::thread";
+#else
+    return "OpenMP";
+#endif
+}
+
+topology::ScopedPin WordCounterParallel::pinToPlan(int threadId) const {
+    return topology::ScopedPin(pg_runtime::plannedCpu(threadId, cpuPlan));
+}
+
+void WordCounterParallel::setExecutor(Executor executor, int numThreads, size_t grainBytes) {
+    this->executor = executor;
+    executorThreads = numThreads;
+    executorGrain = grainBytes;
+}
+
+void WordCounterParallel::setPipelineStages(int readers, int tokenizers, int counters) {
+    pipelineStages[0] = readers;
+    pipelineStages[1] = tokenizers;
+    pipelineStages[2] = counters;
+}
+
 std::string WordCounterParallel::normalizeWord(const std::string& word) {
     std::string normalized;
     normalized.reserve(word.length());
@@ -29,10 +274,85 @@ bool WordCounterParallel::isValidChar(char c) {
     return std::isalpha(static_cast<unsigned char>(c));
 }
 
+size_t WordCounterParallel::calibrateSmallInputThreshold() {
+    using Clock = std::chrono::high_resolution_clock;
+    const std::string phrase = "The quick brown fox jumps over the lazy dog, again and again. ";
+
+    // Largest size at which the inline path still beats this engine's
+    // executor; sizes double, so the first loss ends the search.
+    smallInputThreshold = 0;
+    size_t threshold = 0;
+    for (size_t size = 256; size <= kMaxSmallInputBytes; size *= 2) {
+        std::string sample;
+        while (sample.size() + phrase.size() < size) sample += phrase;
+
+        WordMap scratch;
+        unsigned long long total = 0;
+        unsigned long long filtered = 0;
+        auto inlineStart = Clock::now();
+        for (int r = 0; r < 20; ++r) {
+            scratch.clear();
+            countSmallInput(sample, scratch, total, nullptr, filtered);
+        }
+        double inlineTime = std::chrono::duration<double>(Clock::now() - inlineStart).count() / 20;
+
+        countWords(sample);  // warm up the thread team
+        auto parallelStart = Clock::now();
+        for (int r = 0; r < 5; ++r) {
+            countWords(sample);
+        }
+        double parallelTime = std::chrono::duration<double>(Clock::now() - parallelStart).count() / 5;
+
+        if (inlineTime > parallelTime) break;
+        threshold = size;
+    }
+    smallInputThreshold = threshold;
+    return threshold;
+}
+
+void WordCounterParallel::setSmallInputThreshold(size_t bytes) {
+    smallInputThreshold = std::min(bytes, kMaxSmallInputBytes);
+}
+
 WordCounterParallel::WordMap WordCounterParallel::countWords(const std::string& text) {
     auto startTime = std::chrono::high_resolution_clock::now();
 
     WordMap wordFreq;
+    filteredWords = 0;
+    // The inline path is for per-message calls: no phase timing or table
+    // notes, only executionTime.
+    if (text.size() < smallInputThreshold) {
+        unsigned long long total = 0;
+        unsigned long long filtered = 0;
+        if (countSmallInput(text, wordFreq, total, wordFilter.get(), filtered)) {
+            totalWords = total;
+            filteredWords = filtered;
+            uniqueWords = wordFreq.size();
+
+            auto endTime = std::chrono::high_resolution_clock::now();
+            executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+            return wordFreq;
+        }
+        wordFreq.clear();  // too many distinct words for the scratch table
+    }
+    phaseTimer.clear(static_cast<size_t>(omp_get_max_threads()));
+    memoryReport.clear();
+
+    if (executor != Executor::OpenMP) {
+        if (executor == Executor::Numa) {
+            wordFreq = countNuma(nullptr, text);
+        } else if (executor == Executor::Pipeline) {
+            wordFreq = countPipeline(nullptr, text);
+        } else {
+            wordFreq = countBufferWorkStealing(text);
+        }
+        uniqueWords = wordFreq.size();
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        return wordFreq;
+    }
+
     std::istringstream stream(text);
     std::string word;
 
@@ -40,8 +360,14 @@ WordCounterParallel::WordMap WordCounterParallel::countWords(const std::string&
     rawWords.reserve(text.size() / 5 + 1);
 
     // Cannot parallelize: std::istringstream provides no thread-safe random access.
-    while (stream >> word) {
-        rawWords.push_back(word);
+    {
+        PhaseTimer::Scope tokenizePhase(phaseTimer, PhaseTimer::Tokenize);
+        while (stream >> word) {
+            rawWords.push_back(word);
+        }
+    }
+    if (memoryReport.isEnabled()) {
+        memoryReport.addTable(PhaseTimer::Tokenize, "rawWords", rawWords.size(), MemoryReport::bytesOf(rawWords));
     }
 
     wordFreq = buildWordMapFromList(rawWords);
@@ -55,6 +381,46 @@ WordCounterParallel::WordMap WordCounterParallel::countWords(const std::string&
 
 WordCounterParallel::WordMap WordCounterParallel::countWordsFromFile(const std::string& filename) {
     auto startTime = std::chrono::high_resolution_clock::now();
+    filteredWords = 0;
+    phaseTimer.clear(static_cast<size_t>(omp_get_max_threads()));
+    memoryReport.clear();
+
+    if (executor == Executor::Numa) {
+        WordMap wordFreq = countNuma(&filename, std::string_view());
+        uniqueWords = wordFreq.size();
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        return wordFreq;
+    }
+
+    if (executor == Executor::Pipeline) {
+        WordMap wordFreq = countPipeline(&filename, std::string_view());
+        uniqueWords = wordFreq.size();
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        return wordFreq;
+    }
+
+    if (executor == Executor::WorkStealing) {
+        // Byte-range tasks need the raw buffer, so read it in one go.
+        std::string contents;
+        {
+            PhaseTimer::Scope readPhase(phaseTimer, PhaseTimer::Read);
+            if (!readWholeFile(filename, contents)) {
+                std::cerr << "Error: Cannot open file " << filename << std::endl;
+                executionTime = 0.0;
+                return WordMap();
+            }
+        }
+        WordMap wordFreq = countBufferWorkStealing(contents);
+        uniqueWords = wordFreq.size();
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        return wordFreq;
+    }
 
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -68,8 +434,15 @@ WordCounterParallel::WordMap WordCounterParallel::countWordsFromFile(const std::
     std::vector<std::string> rawWords;
 
     // Cannot parallelize input extraction: std::ifstream >> word is inherently sequential.
-    while (file >> word) {
-        rawWords.push_back(word);
+    // Reading and splitting happen together here, so both count as the read phase.
+    {
+        PhaseTimer::Scope readPhase(phaseTimer, PhaseTimer::Read);
+        while (file >> word) {
+            rawWords.push_back(word);
+        }
+    }
+    if (memoryReport.isEnabled()) {
+        memoryReport.addTable(PhaseTimer::Read, "rawWords", rawWords.size(), MemoryReport::bytesOf(rawWords));
     }
 
     file.close();
@@ -85,13 +458,103 @@ WordCounterParallel::WordMap WordCounterParallel::countWordsFromFile(const std::
     return wordFreq;
 }
 
+WordCounterParallel::BatchResult
+WordCounterParallel::countWordsBatch(std::span<const std::string_view> docs, BatchMode mode) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const size_t n = docs.size();
+    BatchResult result;
+    result.documentTotals.assign(n, 0);
+    if (mode == BatchMode::PerDocument) {
+        result.documents.resize(n);
+    }
+
+    const size_t maxThreads = static_cast<size_t>(omp_get_max_threads());
+    while (batchTables.size() < maxThreads) {
+        batchTables.push_back(std::make_unique<BatchTable>());
+    }
+
+    // Documents are tiny and uneven: threads grab small runs from a shared cursor.
+    constexpr size_t kDocsPerGrab = 16;
+    std::atomic<size_t> next{0};
+    std::mutex mergeLock;
+    unsigned long long batchTotal = 0;
+    unsigned long long batchFiltered = 0;
+    size_t vocabularySum = 0;
+    const WordFilter* filter = wordFilter.get();
+    phaseTimer.clear(maxThreads);
+    CountMergeRegion timedRegion(phaseTimer);
+
+    pg_runtime::parallelRegion([&](int t, int) {
+        BatchTable& table = *batchTables[static_cast<size_t>(t)];
+        table.reset();
+        std::string scratch;
+        unsigned long long threadTotal = 0;
+        unsigned long long threadFiltered = 0;
+        size_t threadVocabulary = 0;
+
+        PhaseTimer::ThreadScope countPhase(phaseTimer, PhaseTimer::Count, static_cast<size_t>(t));
+        for (;;) {
+            size_t begin = next.fetch_add(kDocsPerGrab, std::memory_order_relaxed);
+            if (begin >= n) break;
+            size_t end = std::min(n, begin + kDocsPerGrab);
+            for (size_t d = begin; d < end; ++d) {
+                if (mode == BatchMode::PerDocument) {
+                    table.reset();
+                }
+                unsigned long long docTotal = 0;
+                tokenizer::forEachWord(docs[d], scratch, [&](std::string_view w) {
+                    if (filter != nullptr && !filter->keeps(w)) {
+                        ++threadFiltered;
+                        return;
+                    }
+                    table.add(w);
+                    ++docTotal;
+                });
+                result.documentTotals[d] = docTotal;
+                threadTotal += docTotal;
+                if (mode == BatchMode::PerDocument) {
+                    WordMap& docMap = result.documents[d];
+                    docMap.reserve(table.size());
+                    table.forEach([&](std::string_view w, unsigned long long c) { docMap.emplace(std::string(w), c); });
+                    threadVocabulary += table.size();
+                }
+            }
+        }
+        countPhase.stop();
+
+        PhaseTimer::ThreadScope mergePhase(phaseTimer, PhaseTimer::Merge, static_cast<size_t>(t));
+        std::lock_guard<std::mutex> guard(mergeLock);
+        if (mode == BatchMode::Aggregate) {
+            table.forEach([&](std::string_view w, unsigned long long c) { result.aggregate[std::string(w)] += c; });
+        }
+        batchTotal += threadTotal;
+        batchFiltered += threadFiltered;
+        vocabularySum += threadVocabulary;
+    }, cpuPlan);
+    timedRegion.stop();
+
+    totalWords = batchTotal;
+    filteredWords = batchFiltered;
+    uniqueWords = mode == BatchMode::Aggregate ? result.aggregate.size() : vocabularySum;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return result;
+}
+
 std::vector<std::pair<std::string, unsigned long long>>
 WordCounterParallel::getTopWords(const WordMap& wordMap, int n) {
     std::vector<std::pair<std::string, unsigned long long>> wordVec(wordMap.begin(), wordMap.end());
+    auto byCount = [](const auto& a, const auto& b) { return a.second > b.second; };
 
+#ifdef PG_HAVE_PSTL
+    // Stable, so ties keep the same order as the sequential sort would.
+    std::stable_sort(std::execution::par, wordVec.begin(), wordVec.end(), byCount);
+#else
     // std::sort must remain sequential here to preserve deterministic ordering.
-    std::sort(wordVec.begin(), wordVec.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    std::sort(wordVec.begin(), wordVec.end(), byCount);
+#endif
 
     if (n > 0 && n < static_cast<int>(wordVec.size())) {
         wordVec.resize(n);
@@ -109,14 +572,21 @@ void WordCounterParallel::saveResults(const WordMap& wordMap, const std::string&
 
     outFile << "Word Frequency Analysis Results\n";
     outFile << "================================\n";
-    outFile << "Total Words: " << totalWords << "\n";
+    outFile << "Total Words: " << totalWords + filteredWords << "\n";
+    if (wordFilter != nullptr) {
+        outFile << "Filtered Words: " << filteredWords << "\n";
+        outFile << "Kept Words: " << totalWords << "\n";
+    }
     outFile << "Unique Words: " << uniqueWords << "\n";
     outFile << "Execution Time: " << std::fixed << std::setprecision(2)
             << executionTime << " ms\n";
     outFile << "================================\n\n";
 
+    PhaseTimer::Scope topKPhase(phaseTimer, PhaseTimer::TopK);
     auto sortedWords = getTopWords(wordMap, topN);
+    topKPhase.stop();
 
+    PhaseTimer::Scope outputPhase(phaseTimer, PhaseTimer::Output);
     outFile << std::left << std::setw(30) << "Word"
             << std::right << std::setw(15) << "Frequency" << "\n";
     outFile << std::string(45, '-') << "\n";
@@ -130,6 +600,12 @@ void WordCounterParallel::saveResults(const WordMap& wordMap, const std::string&
     std::cout << "Results saved to: " << filename << std::endl;
 }
 
+void WordCounterParallel::noteTable(PhaseTimer::Phase phase, const char* name, const WordMap& map) {
+    if (memoryReport.isEnabled()) {
+        memoryReport.addTable(phase, name, map.size(), MemoryReport::bytesOf(map));
+    }
+}
+
 WordCounterParallel::WordMap
 WordCounterParallel::buildWordMapFromList(const std::vector<std::string>& rawWords) {
     WordMap wordFreq;
@@ -140,22 +616,39 @@ WordCounterParallel::buildWordMapFromList(const std::vector<std::string>& rawWor
     }
 
     unsigned long long totalWordCount = 0;
+    unsigned long long filteredCount = 0;
+    const WordFilter* filter = wordFilter.get();
+    phaseTimer.reserveThreads(static_cast<size_t>(omp_get_max_threads()));
+    CountMergeRegion timedRegion(phaseTimer);
 
+#ifndef PG_NO_OPENMP
     if (syncMethod == SyncMethod::Reduction) {
-#pragma omp parallel reduction(+ : totalWordCount)
+#pragma omp parallel reduction(+ : totalWordCount, filteredCount)
     {
+        const int t = omp_get_thread_num();
+        const auto pin = pinToPlan(t);
         WordMap localMap;
 
-#pragma omp for schedule(static)
+        // nowait: a thread merges as soon as its own share is counted, so
+        // per-thread count times show the imbalance instead of barrier waits.
+        PhaseTimer::ThreadScope countPhase(phaseTimer, PhaseTimer::Count, static_cast<size_t>(t));
+#pragma omp for schedule(static) nowait
         for (int i = 0; i < static_cast<int>(rawWords.size()); ++i) {
             std::string normalized = normalizeWord(rawWords[static_cast<size_t>(i)]);
             if (!normalized.empty()) {
+                if (filter != nullptr && !filter->keeps(normalized)) {
+                    filteredCount++;
+                    continue;
+                }
                 localMap[normalized]++;
                 // Update per-method: reduction aggregates this increment, atomic uses atomic, critical uses critical section
                 totalWordCount++;
             }
         }
+        countPhase.stop();
+        noteTable(PhaseTimer::Count, "localMap", localMap);
 
+        PhaseTimer::ThreadScope mergePhase(phaseTimer, PhaseTimer::Merge, static_cast<size_t>(t));
 #pragma omp critical
         {
             for (const auto& entry : localMap) {
@@ -166,14 +659,21 @@ WordCounterParallel::buildWordMapFromList(const std::vector<std::string>& rawWor
     }
     }
     else {
-#pragma omp parallel
+#pragma omp parallel reduction(+ : filteredCount)
     {
+        const int t = omp_get_thread_num();
+        const auto pin = pinToPlan(t);
         WordMap localMap;
 
-#pragma omp for schedule(static)
+        PhaseTimer::ThreadScope countPhase(phaseTimer, PhaseTimer::Count, static_cast<size_t>(t));
+#pragma omp for schedule(static) nowait
         for (int i = 0; i < static_cast<int>(rawWords.size()); ++i) {
             std::string normalized = normalizeWord(rawWords[static_cast<size_t>(i)]);
             if (!normalized.empty()) {
+                if (filter != nullptr && !filter->keeps(normalized)) {
+                    filteredCount++;
+                    continue;
+                }
                 localMap[normalized]++;
                 if (syncMethod == SyncMethod::Atomic) {
 #pragma omp atomic
@@ -184,7 +684,10 @@ WordCounterParallel::buildWordMapFromList(const std::vector<std::string>& rawWor
                 }
             }
         }
+        countPhase.stop();
+        noteTable(PhaseTimer::Count, "localMap", localMap);
 
+        PhaseTimer::ThreadScope mergePhase(phaseTimer, PhaseTimer::Merge, static_cast<size_t>(t));
 #pragma omp critical
         {
             for (const auto& entry : localMap) {
@@ -194,8 +697,347 @@ WordCounterParallel::buildWordMapFromList(const std::vector<std::string>& rawWor
     }
     }
 
+#else
+    // OpenMP-free build: same static split, per-method cost model and locked
+    // merge as the OpenMP regions above, on std::threads.
+    const size_t n = std::min(rawWords.size(), static_cast<size_t>(omp_get_max_threads()));
+    std::atomic<unsigned long long> atomicTotal{0};
+    std::mutex totalLock;
+    unsigned long long lockedTotal = 0;
+    std::mutex mergeLock;
+    unsigned long long reducedTotal = 0;
+
+    auto worker = [&](size_t t) {
+        const auto pin = pinToPlan(static_cast<int>(t));
+        WordMap localMap;
+        unsigned long long localTotal = 0;
+        unsigned long long localFiltered = 0;
+        const size_t begin = rawWords.size() * t / n;
+        const size_t end = rawWords.size() * (t + 1) / n;
+        PhaseTimer::ThreadScope countPhase(phaseTimer, PhaseTimer::Count, t);
+        for (size_t i = begin; i < end; ++i) {
+            std::string normalized = normalizeWord(rawWords[i]);
+            if (!normalized.empty()) {
+                if (filter != nullptr && !filter->keeps(normalized)) {
+                    ++localFiltered;
+                    continue;
+                }
+                localMap[normalized]++;
+                if (syncMethod == SyncMethod::Atomic) {
+                    atomicTotal.fetch_add(1, std::memory_order_relaxed);
+                } else if (syncMethod == SyncMethod::Critical) {
+                    std::lock_guard<std::mutex> guard(totalLock);
+                    ++lockedTotal;
+                } else {
+                    ++localTotal;
+                }
+            }
+        }
+        countPhase.stop();
+        noteTable(PhaseTimer::Count, "localMap", localMap);
+
+        PhaseTimer::ThreadScope mergePhase(phaseTimer, PhaseTimer::Merge, t);
+        std::lock_guard<std::mutex> guard(mergeLock);
+        for (const auto& entry : localMap) {
+            wordFreq[entry.first] += entry.second;
+        }
+        reducedTotal += localTotal;
+        filteredCount += localFiltered;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(n - 1);
+    for (size_t t = 1; t < n; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    totalWordCount = atomicTotal.load() + lockedTotal + reducedTotal;
+#endif
+    timedRegion.stop();
+    noteTable(PhaseTimer::Merge, "wordFreq", wordFreq);
+
     // Aggregation happens serially because std::unordered_map is not thread-safe.
     totalWords = totalWordCount;
+    filteredWords = filteredCount;
+
+    return wordFreq;
+}
+
+WordCounterParallel::WordMap WordCounterParallel::countBufferWorkStealing(std::string_view text) {
+    WorkStealingExecutor pool(executorThreads, executorGrain);
+    pool.setPlacement(cpuPlan);
+    const size_t n = static_cast<size_t>(pool.getNumThreads());
+
+    std::vector<WordMap> localMaps(n);
+    std::vector<unsigned long long> localTotals(n, 0);
+    std::vector<unsigned long long> localFiltered(n, 0);
+    std::atomic<unsigned long long> atomicTotal{0};
+    std::mutex totalLock;
+    unsigned long long lockedTotal = 0;
+    const WordFilter* filter = wordFilter.get();
+    phaseTimer.reserveThreads(n);
+
+    PhaseTimer::Scope countPhase(phaseTimer, PhaseTimer::Count);
+    pool.run(
+        text.size(),
+        [&](size_t pos) { return tokenizer::alignToTokenStart(text, pos); },
+        [&](int t, WorkStealingExecutor::Task task) {
+            PhaseTimer::ThreadScope taskPhase(phaseTimer, PhaseTimer::Count, static_cast<size_t>(t));
+            WordMap& localMap = localMaps[static_cast<size_t>(t)];
+            std::string scratch;
+            unsigned long long taskTotal = 0;
+            unsigned long long taskFiltered = 0;
+            tokenizer::forEachWord(text.substr(task.begin, task.end - task.begin), scratch,
+                                   [&](std::string_view w) {
+                if (filter != nullptr && !filter->keeps(w)) {
+                    ++taskFiltered;
+                    return;
+                }
+                localMap[std::string(w)]++;
+                // Same per-method cost model as buildWordMapFromList.
+                if (syncMethod == SyncMethod::Atomic) {
+                    atomicTotal.fetch_add(1, std::memory_order_relaxed);
+                } else if (syncMethod == SyncMethod::Critical) {
+                    std::lock_guard<std::mutex> guard(totalLock);
+                    ++lockedTotal;
+                } else {
+                    ++taskTotal;
+                }
+            });
+            localTotals[static_cast<size_t>(t)] += taskTotal;
+            localFiltered[static_cast<size_t>(t)] += taskFiltered;
+        });
+    countPhase.stop();
+    for (const auto& localMap : localMaps) noteTable(PhaseTimer::Count, "localMap", localMap);
+
+    PhaseTimer::Scope mergePhase(phaseTimer, PhaseTimer::Merge);
+    WordMap wordFreq;
+    unsigned long long totalWordCount = atomicTotal.load() + lockedTotal;
+    filteredWords = 0;
+    for (size_t t = 0; t < n; ++t) {
+        totalWordCount += localTotals[t];
+        filteredWords += localFiltered[t];
+        for (const auto& entry : localMaps[t]) {
+            wordFreq[entry.first] += entry.second;
+        }
+    }
+    totalWords = totalWordCount;
+    executorStats = pool.getStats();
+    noteTable(PhaseTimer::Merge, "wordFreq", wordFreq);
 
     return wordFreq;
-}
\ No newline at end of file
+}
+
+WordCounterParallel::WordMap WordCounterParallel::countPipeline(const std::string* filename, std::string_view text) {
+    int threads = executorThreads > 0 ? executorThreads
+                                      : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    PipelineCounter::Config config = PipelineCounter::configFor(threads);
+    if (pipelineStages[0] > 0) config.readers = pipelineStages[0];
+    if (pipelineStages[1] > 0) config.tokenizers = pipelineStages[1];
+    if (pipelineStages[2] > 0) config.counters = pipelineStages[2];
+    config.blockBytes = executorGrain;
+
+    PipelineCounter pipeline(config);
+    pipeline.setPlacement(cpuPlan);
+    pipeline.setWordFilter(wordFilter.get());
+    pipeline.setPhaseTimer(&phaseTimer);
+    pipelineConfig = pipeline.getConfig();
+
+    WordMap wordFreq;
+    unsigned long long total = 0;
+    if (filename != nullptr) {
+        if (!pipeline.countFile(*filename, wordFreq, total)) {
+            std::cerr << "Error: Cannot open file " << *filename << std::endl;
+            totalWords = 0;
+            return WordMap();
+        }
+    } else {
+        pipeline.countText(text, wordFreq, total);
+    }
+    totalWords = total;
+    noteTable(PhaseTimer::Merge, "wordFreq", wordFreq);
+    pipelineStats = pipeline.getStats();
+    filteredWords = pipelineStats.filteredWords;
+    return wordFreq;
+}
+
+WordCounterParallel::WordMap WordCounterParallel::countNuma(const std::string* filename, std::string_view text) {
+    const auto nodes = topology::detectNumaNodes();
+    const size_t n = static_cast<size_t>(
+        executorThreads > 0 ? executorThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+    const size_t nodeCount = nodes.size();
+
+    numaStats = NumaStats();
+    for (const auto& node : nodes) numaStats.nodeIds.push_back(node.id);
+    numaStats.threadNode.assign(n, 0);
+    numaStats.threadCpu.assign(n, -1);
+    numaStats.localPages.assign(n, 0);
+    numaStats.remotePages.assign(n, 0);
+    phaseTimer.reserveThreads(n);
+
+    // Contiguous blocks of threads per node, so neighbouring byte ranges share a node.
+    std::vector<size_t> nodeOfThread(n);
+    std::vector<int> cpuOfThread(n);
+    for (size_t t = 0; t < n; ++t) {
+        size_t node = t * nodeCount / n;
+        size_t firstOnNode = (node * n + nodeCount - 1) / nodeCount;
+        const auto& cpus = nodes[node].cpus;
+        nodeOfThread[t] = node;
+        cpuOfThread[t] = cpus[(t - firstOnNode) % cpus.size()];
+        numaStats.threadNode[t] = nodes[node].id;
+        numaStats.threadCpu[t] = cpuOfThread[t];
+    }
+
+    // The buffer is left untouched here: pages land on the node of whichever
+    // thread reads into them first.
+    std::unique_ptr<char[]> owned;
+    if (filename != nullptr) {
+        std::error_code ec;
+        auto fileSize = std::filesystem::file_size(*filename, ec);
+        if (ec || !std::ifstream(*filename).is_open()) {
+            std::cerr << "Error: Cannot open file " << *filename << std::endl;
+            totalWords = 0;
+            return WordMap();
+        }
+        owned.reset(new char[fileSize > 0 ? fileSize : 1]);
+        text = std::string_view(owned.get(), static_cast<size_t>(fileSize));
+    }
+
+    std::vector<size_t> bounds(n + 1);
+    for (size_t t = 0; t <= n; ++t) bounds[t] = text.size() * t / n;
+
+    auto runPinned = [&](const std::function<void(size_t)>& fn) {
+        std::vector<std::thread> threads;
+        threads.reserve(n);
+        for (size_t t = 0; t < n; ++t) {
+            threads.emplace_back([&, t]() {
+                topology::pinCurrentThread(cpuOfThread[t]);
+                fn(t);
+            });
+        }
+        for (auto& th : threads) th.join();
+    };
+
+    if (filename != nullptr) {
+        PhaseTimer::Scope readPhase(phaseTimer, PhaseTimer::Read);
+        std::atomic<bool> readFailed{false};
+        runPinned([&](size_t t) {
+            PhaseTimer::ThreadScope threadRead(phaseTimer, PhaseTimer::Read, t);
+            std::ifstream in(*filename, std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(bounds[t]));
+            size_t length = bounds[t + 1] - bounds[t];
+            if (length > 0 && !in.read(owned.get() + bounds[t], static_cast<std::streamsize>(length))) {
+                readFailed = true;
+            }
+        });
+        if (readFailed) {
+            std::cerr << "Error: Cannot read file " << *filename << std::endl;
+            totalWords = 0;
+            return WordMap();
+        }
+    }
+
+    std::vector<WordMap> nodeMaps(nodeCount);
+    std::vector<std::mutex> nodeLocks(nodeCount);
+    std::vector<unsigned long long> localTotals(n, 0);
+    std::vector<unsigned long long> localFiltered(n, 0);
+    std::atomic<unsigned long long> atomicTotal{0};
+    std::mutex totalLock;
+    unsigned long long lockedTotal = 0;
+    std::atomic<bool> queryFailed{false};
+    const WordFilter* filter = wordFilter.get();
+    const size_t pageBytes = topology::pageSize();
+
+    CountMergeRegion timedRegion(phaseTimer);
+    runPinned([&](size_t t) {
+        PhaseTimer::ThreadScope countPhase(phaseTimer, PhaseTimer::Count, t);
+        size_t begin = tokenizer::alignToTokenStart(text, bounds[t]);
+        size_t end = tokenizer::alignToTokenStart(text, bounds[t + 1]);
+
+        WordMap localMap;
+        std::string scratch;
+        unsigned long long count = 0;
+        unsigned long long filtered = 0;
+        if (begin < end) {
+            tokenizer::forEachWord(text.substr(begin, end - begin), scratch, [&](std::string_view w) {
+                if (filter != nullptr && !filter->keeps(w)) {
+                    ++filtered;
+                    return;
+                }
+                localMap[std::string(w)]++;
+                if (syncMethod == SyncMethod::Atomic) {
+                    atomicTotal.fetch_add(1, std::memory_order_relaxed);
+                } else if (syncMethod == SyncMethod::Critical) {
+                    std::lock_guard<std::mutex> guard(totalLock);
+                    ++lockedTotal;
+                } else {
+                    ++count;
+                }
+            });
+        }
+        localTotals[t] = count;
+        localFiltered[t] = filtered;
+
+        // Sample up to 256 pages of this range and ask the kernel where they live.
+        if (begin < end) {
+            std::vector<void*> pages;
+            size_t step = std::max(pageBytes, (end - begin) / 256);
+            for (size_t off = begin; off < end; off += step) {
+                uintptr_t addr = reinterpret_cast<uintptr_t>(text.data() + off);
+                pages.push_back(reinterpret_cast<void*>(addr & ~(static_cast<uintptr_t>(pageBytes) - 1)));
+            }
+            std::vector<int> pageNodes;
+            if (topology::queryPageNodes(pages, pageNodes)) {
+                for (int node : pageNodes) {
+                    if (node < 0) continue;
+                    (node == nodes[nodeOfThread[t]].id ? numaStats.localPages[t] : numaStats.remotePages[t])++;
+                }
+            } else {
+                queryFailed = true;
+            }
+        }
+
+        // Per-node aggregation: only threads of the same node contend here.
+        countPhase.stop();
+        noteTable(PhaseTimer::Count, "localMap", localMap);
+        PhaseTimer::ThreadScope mergePhase(phaseTimer, PhaseTimer::Merge, t);
+        std::lock_guard<std::mutex> guard(nodeLocks[nodeOfThread[t]]);
+        WordMap& nodeMap = nodeMaps[nodeOfThread[t]];
+        for (const auto& entry : localMap) {
+            nodeMap[entry.first] += entry.second;
+        }
+    });
+
+    timedRegion.stop();
+    for (const auto& nodeMap : nodeMaps) noteTable(PhaseTimer::Merge, "nodeMap", nodeMap);
+
+    // Final cross-node merge.
+    PhaseTimer::Scope mergePhase(phaseTimer, PhaseTimer::Merge);
+    WordMap wordFreq = std::move(nodeMaps[0]);
+    for (size_t node = 1; node < nodeCount; ++node) {
+        for (const auto& entry : nodeMaps[node]) {
+            wordFreq[entry.first] += entry.second;
+        }
+    }
+    mergePhase.stop();
+    noteTable(PhaseTimer::Merge, "wordFreq", wordFreq);
+
+    unsigned long long totalWordCount = atomicTotal.load() + lockedTotal;
+    for (unsigned long long c : localTotals) totalWordCount += c;
+    totalWords = totalWordCount;
+    filteredWords = 0;
+    for (unsigned long long f : localFiltered) filteredWords += f;
+
+    size_t local = 0, remote = 0;
+    for (size_t t = 0; t < n; ++t) {
+        local += numaStats.localPages[t];
+        remote += numaStats.remotePages[t];
+    }
+    numaStats.pageQueryAvailable = !queryFailed;
+    numaStats.remoteRatio = (local + remote) > 0 ? static_cast<double>(remote) / static_cast<double>(local + remote) : 0.0;
+
+    return wordFreq;
+}
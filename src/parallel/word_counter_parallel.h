@@ -1,13 +1,29 @@
 #ifndef WORD_COUNTER_PARALLEL_H
 #define WORD_COUNTER_PARALLEL_H
 
+#include "memory_report.h"
+#include "phase_timer.h"
+#include "pipeline_counter.h"
+#include "work_stealing_executor.h"
+
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <chrono>
 
+class WordFilter;
+namespace topology {
+class ScopedPin;
+}
+
 /**
  * @brief OpenMP-based parallel word frequency counter.
+ *
+ * Built with -DPG_NO_OPENMP, the default executor runs the same parallel
+ * region on std::threads instead (see parallel_runtime.h).
  */
 class WordCounterParallel {
 public:
@@ -16,29 +32,150 @@ public:
     // Enum to select synchronization method for shared counters
     enum class SyncMethod { Critical, Atomic, Reduction };
     explicit WordCounterParallel(SyncMethod mode = SyncMethod::Reduction);
+    ~WordCounterParallel();
+
+    // Threading runtime behind Executor::OpenMP in this build: "OpenMP" or "std::thread"
+    static const char* runtimeName();
+
+    // Scheduler behind the counting loop. WorkStealing counts byte ranges of the
+    // raw buffer on std::threads (no OpenMP); Numa pins threads per node, reads
+    // each range on the thread that counts it (first touch) and merges per node;
+    // Pipeline streams read -> tokenize -> count stages over SPSC rings, with
+    // partition-owning counters (the sync method does not apply).
+    // numThreads <= 0 uses hardware concurrency.
+    enum class Executor { OpenMP, WorkStealing, Numa, Pipeline };
+    void setExecutor(Executor executor, int numThreads = 0, size_t grainBytes = 256 * 1024);
+    Executor getExecutor() const { return executor; }
+    // Per-thread busy/idle time of the last WorkStealing run
+    const WorkStealingExecutor::Stats& getExecutorStats() const { return executorStats; }
+
+    // Explicit stage sizes for Executor::Pipeline; values <= 0 fall back to
+    // PipelineCounter::configFor(numThreads). Block size is the executor grain.
+    void setPipelineStages(int readers, int tokenizers, int counters);
+    const PipelineCounter::Config& getPipelineConfig() const { return pipelineConfig; }
+    // Per-stage timing and ring stalls of the last Pipeline run
+    const PipelineCounter::Stats& getPipelineStats() const { return pipelineStats; }
+
+    // CPUs for the counting threads: thread t runs on cpus[t % cpus.size()].
+    // Empty (default) leaves placement to the OS. Not used by Executor::Numa,
+    // which places threads by node.
+    void setThreadPlacement(const std::vector<int>& cpus) { cpuPlan = cpus; }
+    const std::vector<int>& getThreadPlacement() const { return cpuPlan; }
+
+    // Placement report of the last Numa run. Pages are sampled from each
+    // thread's input range; "remote" means backed by another node's memory.
+    struct NumaStats {
+        bool pageQueryAvailable = false;
+        std::vector<int> nodeIds;
+        std::vector<int> threadNode;
+        std::vector<int> threadCpu;
+        std::vector<size_t> localPages;
+        std::vector<size_t> remotePages;
+        double remoteRatio = 0.0;
+    };
+    const NumaStats& getNumaStats() const { return numaStats; }
+
+    // Include/exclude word list checked right after normalization, in every
+    // path, so filtered words never reach a count table. getTotalWords() is
+    // then the kept count and getFilteredWords() the dropped one. Null
+    // (default) counts every word.
+    void setWordFilter(std::shared_ptr<const WordFilter> filter) { wordFilter = std::move(filter); }
+    const WordFilter* getWordFilter() const { return wordFilter.get(); }
 
     WordMap countWordsFromFile(const std::string& filename);
     WordMap countWords(const std::string& text);
 
-    std::vector<std::pair<std::string, unsigned long long>>
+    // countWords inputs shorter than this are counted inline on the calling
+    // thread with a per-thread scratch table: no thread team, no rawWords
+    // vector. Defaults to kDefaultSmallInputThreshold; 0 disables the fast
+    // path. Capped at kMaxSmallInputBytes.
+    static constexpr size_t kMaxSmallInputBytes = 16 * 1024;
+    static constexpr size_t kDefaultSmallInputThreshold = 4 * 1024;
+    void setSmallInputThreshold(size_t bytes);
+    size_t getSmallInputThreshold() const { return smallInputThreshold; }
+    // Sets the threshold to the largest power-of-two size (256 B ..
+    // kMaxSmallInputBytes) at which the inline path beats this engine's
+    // configured executor, 0 if it never does, and returns it. Takes a few
+    // ms and overwrites the last-run statistics: call it once, after
+    // setExecutor/setThreadPlacement and before the runs being timed.
+    size_t calibrateSmallInputThreshold();
+
+    // Many small documents in one call, parallel across documents. Each
+    // thread keeps one table for the engine's lifetime and clears it in O(1)
+    // between documents (generation counter), so no per-document map is
+    // built and torn down. PerDocument fills documents[i] for docs[i];
+    // Aggregate fills only `aggregate`. getTotalWords/getExecutionTime cover
+    // the whole batch; getUniqueWords is the aggregate vocabulary (Aggregate)
+    // or the sum of per-document vocabularies (PerDocument).
+    enum class BatchMode { PerDocument, Aggregate };
+    struct BatchResult {
+        std::vector<WordMap> documents;
+        std::vector<unsigned long long> documentTotals;  // words per document, both modes
+        WordMap aggregate;
+    };
+    BatchResult countWordsBatch(std::span<const std::string_view> docs, BatchMode mode = BatchMode::PerDocument);
+
+    // Sorted by descending count; n <= 0 keeps every entry. Shared by the
+    // modes that report other keyed counts (e.g. multi-pattern grep).
+    static std::vector<std::pair<std::string, unsigned long long>>
         getTopWords(const WordMap& wordMap, int n);
 
     void saveResults(const WordMap& wordMap, const std::string& filename, int topN = 0);
 
     double getExecutionTime() const { return executionTime; }
     unsigned long long getTotalWords() const { return totalWords; }
+    unsigned long long getFilteredWords() const { return filteredWords; }
     size_t getUniqueWords() const { return uniqueWords; }
 
+    // Wall/CPU time per phase of the last count (cleared by each count that
+    // uses the thread team; inputs counted inline leave it untouched),
+    // plus the top-K and output phases of later saveResults calls. Per-thread
+    // samples cover the count and merge of every executor and the pipeline's
+    // read/tokenize/count stages. Loops that tokenize and count word by word
+    // report under count; pipeline stages overlap, so their phase totals
+    // (the busiest thread of each stage) can add up to more than the run.
+    PhaseTimer& getPhaseTimer() { return phaseTimer; }
+    const PhaseTimer& getPhaseTimer() const { return phaseTimer; }
+
+    // Table footprints of the last team count once enabled: rawWords (default
+    // executor), each thread's localMap, NUMA nodeMaps and the merged wordFreq.
+    MemoryReport& getMemoryReport() { return memoryReport; }
+    const MemoryReport& getMemoryReport() const { return memoryReport; }
+
 private:
     double executionTime;
     unsigned long long totalWords;
+    unsigned long long filteredWords = 0;
     size_t uniqueWords;
     SyncMethod syncMethod = SyncMethod::Reduction;
+    Executor executor = Executor::OpenMP;
+    int executorThreads = 0;
+    size_t executorGrain = 256 * 1024;
+    std::vector<int> cpuPlan;
+    std::shared_ptr<const WordFilter> wordFilter;
+    size_t smallInputThreshold = kDefaultSmallInputThreshold;
+    class BatchTable;
+    std::vector<std::unique_ptr<BatchTable>> batchTables;  // one per thread, reused across batches
+    WorkStealingExecutor::Stats executorStats;
+    int pipelineStages[3] = {0, 0, 0};
+    PipelineCounter::Config pipelineConfig;
+    PipelineCounter::Stats pipelineStats;
+    NumaStats numaStats;
+    PhaseTimer phaseTimer;
+    MemoryReport memoryReport;
 
     std::string normalizeWord(const std::string& word);
     bool isValidChar(char c);
 
     WordMap buildWordMapFromList(const std::vector<std::string>& rawWords);
+    void noteTable(PhaseTimer::Phase phase, const char* name, const WordMap& map);
+    // Pins the calling team member until the returned guard goes out of scope.
+    topology::ScopedPin pinToPlan(int threadId) const;
+    WordMap countBufferWorkStealing(std::string_view text);
+    // filename == nullptr counts `text`; otherwise the file is streamed.
+    WordMap countPipeline(const std::string* filename, std::string_view text);
+    // filename == nullptr counts `text` in place; otherwise threads read the file themselves.
+    WordMap countNuma(const std::string* filename, std::string_view text);
 };
 
 #endif // WORD_COUNTER_PARALLEL_H
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "word_filter.h"
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// Smallest power of two keeping the load factor at or below one half.
+size_t tableSize(size_t entries) {
+    size_t size = 16;
+    while (size < entries * 2) size <<= 1;
+    return size;
+}
+
+} // namespace
+
+WordFilter::WordFilter(const std::vector<std::string>& words, Mode mode) : mode(mode) {
+    // Normalize like the tokenizer, so "The," in a list matches "the" in text.
+    std::vector<std::string> normalized;
+    normalized.reserve(words.size());
+    std::string scratch;
+    for (const auto& w : words) {
+        tokenizer::normalize(w, scratch);
+        if (!scratch.empty()) normalized.push_back(scratch);
+    }
+    std::sort(normalized.begin(), normalized.end());
+    normalized.erase(std::unique(normalized.begin(), normalized.end()), normalized.end());
+    wordCount = normalized.size();
+
+    size_t shortCount = 0;
+    for (const auto& w : normalized) shortCount += w.size() <= 8 ? 1 : 0;
+    const size_t longCount = normalized.size() - shortCount;
+
+    if (shortCount > 0) {
+        shortKeys.assign(tableSize(shortCount), 0);
+        shortMask = shortKeys.size() - 1;
+    }
+    if (longCount > 0) {
+        longSlots.assign(tableSize(longCount), LongSlot{0, 0, 0});
+        longMask = longSlots.size() - 1;
+    }
+
+    for (const auto& w : normalized) {
+        if (w.size() <= 8) {
+            std::uint64_t key = pack(w);
+            size_t i = mix(key) & shortMask;
+            while (shortKeys[i] != 0) i = (i + 1) & shortMask;
+            shortKeys[i] = key;
+        } else {
+            std::uint64_t h = hashBytes(w);
+            size_t i = h & longMask;
+            while (longSlots[i].length != 0) i = (i + 1) & longMask;
+            longSlots[i] = {h, static_cast<std::uint32_t>(pool.size()), static_cast<std::uint32_t>(w.size())};
+            pool += w;
+        }
+    }
+}
+
+bool WordFilter::loadWords(const std::string& filename, std::vector<std::string>& words) {
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        std::istringstream fields(line);
+        std::string word;
+        while (fields >> word) words.push_back(word);
+    }
+    return true;
+}
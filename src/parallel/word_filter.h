@@ -0,0 +1,90 @@
+#ifndef WORD_FILTER_H
+#define WORD_FILTER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Include or exclude word list, checked in the tokenizer before a word
+ *        reaches any count table.
+ *
+ * The list is normalized like every counted word (letters only, lowercase)
+ * and compiled once into a read-only open-addressing set, so counting threads
+ * share it without locking. Words of up to 8 bytes are packed into one
+ * 64-bit key (zero padded; normalized words contain no zero bytes, so the
+ * packing is unique) and matched with a single compare. Longer words live in
+ * a second table of (hash, offset, length) entries over one byte pool.
+ */
+class WordFilter {
+public:
+    // Include keeps only listed words; Exclude drops them (stopwords).
+    enum class Mode { Include, Exclude };
+
+    WordFilter(const std::vector<std::string>& words, Mode mode);
+
+    /** @brief Whitespace-separated words; blank lines and '#' comment lines skipped. */
+    static bool loadWords(const std::string& filename, std::vector<std::string>& words);
+
+    /** @brief Whether a normalized word should be counted. */
+    bool keeps(std::string_view word) const { return contains(word) == (mode == Mode::Include); }
+
+    bool contains(std::string_view word) const {
+        if (word.size() <= 8) {
+            if (shortKeys.empty()) return false;
+            std::uint64_t key = pack(word);
+            for (size_t i = mix(key) & shortMask;; i = (i + 1) & shortMask) {
+                if (shortKeys[i] == key) return true;
+                if (shortKeys[i] == 0) return false;
+            }
+        }
+        if (longSlots.empty()) return false;
+        std::uint64_t h = hashBytes(word);
+        for (size_t i = h & longMask;; i = (i + 1) & longMask) {
+            const LongSlot& slot = longSlots[i];
+            if (slot.length == 0) return false;
+            if (slot.hash == h && slot.length == word.size() &&
+                std::memcmp(pool.data() + slot.offset, word.data(), word.size()) == 0) {
+                return true;
+            }
+        }
+    }
+
+    Mode getMode() const { return mode; }
+    size_t size() const { return wordCount; }
+
+private:
+    struct LongSlot {
+        std::uint64_t hash;
+        std::uint32_t offset;
+        std::uint32_t length;  // 0 = empty slot
+    };
+
+    Mode mode;
+    size_t wordCount = 0;
+    std::vector<std::uint64_t> shortKeys;  // 0 = empty slot
+    size_t shortMask = 0;
+    std::vector<LongSlot> longSlots;
+    size_t longMask = 0;
+    std::string pool;
+
+    static std::uint64_t pack(std::string_view word) {
+        std::uint64_t key = 0;
+        std::memcpy(&key, word.data(), word.size());
+        return key;
+    }
+    static std::uint64_t mix(std::uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        return key ^ (key >> 33);
+    }
+    static std::uint64_t hashBytes(std::string_view word) {
+        std::uint64_t h = 1469598103934665603ULL;  // FNV-1a
+        for (char c : word) h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        return h;
+    }
+};
+
+#endif // WORD_FILTER_H
@@ -0,0 +1,116 @@
+#include "work_stealing_executor.h"
+#include "topology.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+WorkStealingExecutor::WorkStealingExecutor(int numThreads, size_t grainSize)
+    : numThreads(numThreads > 0 ? numThreads
+                                : std::max(1, static_cast<int>(std::thread::hardware_concurrency()))),
+      grainSize(std::max<size_t>(1, grainSize)) {}
+
+void WorkStealingExecutor::run(size_t total, const SplitFn& split, const TaskFn& body) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const size_t n = static_cast<size_t>(numThreads);
+    stats.busyTime.assign(n, 0.0);
+    stats.idleTime.assign(n, 0.0);
+    stats.tasksRun.assign(n, 0);
+    stats.tasksStolen.assign(n, 0);
+
+    std::vector<WorkerQueue> queues(n);
+    std::atomic<size_t> pending{0};
+
+    // Seed each worker with an equal slice, cut where the caller allows.
+    size_t begin = 0;
+    for (size_t t = 0; t < n && begin < total; ++t) {
+        size_t end = (t + 1 == n) ? total : split(std::max(begin + 1, total * (t + 1) / n));
+        end = std::min(std::max(end, begin), total);
+        if (end > begin) {
+            queues[t].tasks.push_back({begin, end});
+            pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        begin = end;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(n - 1);
+    for (int t = 1; t < numThreads; ++t) {
+        workers.emplace_back([&, t]() { workerLoop(t, queues, split, body, pending); });
+    }
+    workerLoop(0, queues, split, body, pending);
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.wallTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+void WorkStealingExecutor::workerLoop(int id, std::vector<WorkerQueue>& queues, const SplitFn& split,
+                                      const TaskFn& body, std::atomic<size_t>& pending) {
+    using Clock = std::chrono::high_resolution_clock;
+    const size_t self = static_cast<size_t>(id);
+    // Scoped: worker 0 is the caller's thread and gets its mask back afterwards.
+    const topology::ScopedPin pin(placement.empty() ? -1 : placement[self % placement.size()]);
+    const size_t n = queues.size();
+    unsigned int rng = 2463534242u ^ static_cast<unsigned int>(id * 7919 + 1);
+
+    auto popOwn = [&](Task& task) {
+        std::lock_guard<std::mutex> guard(queues[self].lock);
+        if (queues[self].tasks.empty()) return false;
+        task = queues[self].tasks.back();
+        queues[self].tasks.pop_back();
+        return true;
+    };
+    auto stealOne = [&](Task& task) {
+        for (size_t attempt = 0; attempt < n; ++attempt) {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            size_t victim = rng % n;
+            if (victim == self) continue;
+            std::lock_guard<std::mutex> guard(queues[victim].lock);
+            if (!queues[victim].tasks.empty()) {
+                task = queues[victim].tasks.front();
+                queues[victim].tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    Task task;
+    for (;;) {
+        bool found = popOwn(task);
+        if (!found) {
+            auto idleStart = Clock::now();
+            while (!(found = stealOne(task))) {
+                if (pending.load(std::memory_order_acquire) == 0) break;
+                std::this_thread::yield();
+            }
+            stats.idleTime[self] += std::chrono::duration<double, std::milli>(Clock::now() - idleStart).count();
+            if (!found) return;
+            ++stats.tasksStolen[self];
+        }
+
+        // Split oversized tasks recursively; the right halves become stealable.
+        while (task.end - task.begin > grainSize) {
+            size_t mid = split(task.begin + (task.end - task.begin) / 2);
+            if (mid <= task.begin || mid >= task.end) break;
+            pending.fetch_add(1, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> guard(queues[self].lock);
+                queues[self].tasks.push_back({mid, task.end});
+            }
+            task.end = mid;
+        }
+
+        auto busyStart = Clock::now();
+        body(id, task);
+        stats.busyTime[self] += std::chrono::duration<double, std::milli>(Clock::now() - busyStart).count();
+        ++stats.tasksRun[self];
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
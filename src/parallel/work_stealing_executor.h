@@ -0,0 +1,75 @@
+#ifndef WORK_STEALING_EXECUTOR_H
+#define WORK_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief std::thread work-stealing scheduler over byte-range tasks.
+ *
+ * Every worker owns a deque seeded with an equal slice of the range. A
+ * worker splits any task larger than the grain size, keeps the left half and
+ * pushes the right half to the bottom of its own deque; it pops from the
+ * bottom (LIFO, cache-warm) and, once empty, steals from the top of a victim's
+ * deque (FIFO, largest remaining pieces). No OpenMP is involved.
+ */
+class WorkStealingExecutor {
+public:
+    struct Task {
+        size_t begin;
+        size_t end;
+    };
+
+    struct Stats {
+        double wallTime = 0.0;             // ms for the whole run
+        std::vector<double> busyTime;      // ms per thread inside task bodies
+        std::vector<double> idleTime;      // ms per thread looking for work
+        std::vector<size_t> tasksRun;
+        std::vector<size_t> tasksStolen;
+    };
+
+    /**
+     * @brief Move a proposed cut position to the nearest legal one at or
+     *        after it (e.g. the next token start).
+     */
+    using SplitFn = std::function<size_t(size_t pos)>;
+    using TaskFn = std::function<void(int threadId, Task task)>;
+
+    /**
+     * @param numThreads Workers to start (<= 0 uses hardware concurrency)
+     * @param grainSize Tasks larger than this many bytes are split
+     */
+    explicit WorkStealingExecutor(int numThreads = 0, size_t grainSize = 256 * 1024);
+
+    /**
+     * @brief Run body over [0, total) and block until every task finished.
+     */
+    void run(size_t total, const SplitFn& split, const TaskFn& body);
+
+    /** @brief Pin worker t to cpus[t % cpus.size()] (empty = OS placement). */
+    void setPlacement(const std::vector<int>& cpus) { placement = cpus; }
+
+    int getNumThreads() const { return numThreads; }
+    size_t getGrainSize() const { return grainSize; }
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    int numThreads;
+    size_t grainSize;
+    std::vector<int> placement;
+    Stats stats;
+
+    void workerLoop(int id, std::vector<WorkerQueue>& queues, const SplitFn& split, const TaskFn& body,
+                    std::atomic<size_t>& pending);
+};
+
+#endif // WORK_STEALING_EXECUTOR_H
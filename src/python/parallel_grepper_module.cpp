@@ -0,0 +1,411 @@
+/**
+ * @brief CPython extension over the C ABI in src/parallel/word_counter_c_api.h
+ *
+ * Counting runs with the GIL released. The engine is not thread-safe, so
+ * the C API serializes calls on one counter with a per-counter lock, taken
+ * after the GIL is dropped: Python threads sharing a Counter wait on it
+ * without blocking the interpreter. Result.counts is a zero-copy
+ * memoryview (format 'Q') over the engine's count array; words are decoded
+ * lazily on first access.
+ *
+ * Build: pip install . (see setup.py)
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "../parallel/word_counter_c_api.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct ResultObject {
+    PyObject_HEAD
+    pg_result* result;
+    PyObject* wordsCache;
+    Py_ssize_t shape;
+};
+
+struct CounterObject {
+    PyObject_HEAD
+    pg_counter* counter;
+};
+
+// ---------------------------------------------------------------- Result
+
+void Result_dealloc(ResultObject* self) {
+    Py_XDECREF(self->wordsCache);
+    pg_result_free(self->result);
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+int Result_getbuffer(ResultObject* self, Py_buffer* view, int flags) {
+    static_assert(sizeof(unsigned long long) == 8, "format 'Q' expects 64-bit counts");
+    const pg_result* r = self->result;
+    // An empty vocabulary may have no count array; Py_buffer still needs a valid pointer.
+    static unsigned long long emptyCounts[1] = {0};
+    void* data = r->unique_words > 0 ? const_cast<unsigned long long*>(r->counts) : emptyCounts;
+    Py_ssize_t bytes = static_cast<Py_ssize_t>(r->unique_words * sizeof(unsigned long long));
+
+    if (PyBuffer_FillInfo(view, reinterpret_cast<PyObject*>(self), data, bytes, 1, flags) < 0) {
+        return -1;
+    }
+    view->itemsize = sizeof(unsigned long long);
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("Q") : nullptr;
+    view->shape = (flags & PyBUF_ND) ? &self->shape : nullptr;
+    self->shape = static_cast<Py_ssize_t>(r->unique_words);
+    return 0;
+}
+
+PyObject* Result_words(ResultObject* self, void*) {
+    if (self->wordsCache == nullptr) {
+        const pg_result* r = self->result;
+        PyObject* list = PyList_New(static_cast<Py_ssize_t>(r->unique_words));
+        if (list == nullptr) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < r->unique_words; ++i) {
+            const char* w = r->words + r->word_offsets[i];
+            Py_ssize_t len = static_cast<Py_ssize_t>(r->word_offsets[i + 1] - r->word_offsets[i] - 1);
+            PyObject* s = PyUnicode_DecodeASCII(w, len, "replace");
+            if (s == nullptr) {
+                Py_DECREF(list);
+                return nullptr;
+            }
+            PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), s);
+        }
+        self->wordsCache = list;
+    }
+    Py_INCREF(self->wordsCache);
+    return self->wordsCache;
+}
+
+PyObject* Result_counts(ResultObject* self, void*) {
+    return PyMemoryView_FromObject(reinterpret_cast<PyObject*>(self));
+}
+
+PyObject* Result_total_words(ResultObject* self, void*) {
+    return PyLong_FromUnsignedLongLong(self->result->total_words);
+}
+
+PyObject* Result_unique_words(ResultObject* self, void*) {
+    return PyLong_FromSize_t(self->result->unique_words);
+}
+
+PyObject* Result_execution_time_ms(ResultObject* self, void*) {
+    return PyFloat_FromDouble(self->result->execution_time_ms);
+}
+
+PyObject* Result_to_dict(ResultObject* self, PyObject*) {
+    PyObject* words = Result_words(self, nullptr);
+    if (words == nullptr) {
+        return nullptr;
+    }
+    PyObject* dict = PyDict_New();
+    for (size_t i = 0; dict != nullptr && i < self->result->unique_words; ++i) {
+        PyObject* count = PyLong_FromUnsignedLongLong(self->result->counts[i]);
+        if (count == nullptr ||
+            PyDict_SetItem(dict, PyList_GET_ITEM(words, static_cast<Py_ssize_t>(i)), count) < 0) {
+            Py_XDECREF(count);
+            Py_CLEAR(dict);
+            break;
+        }
+        Py_DECREF(count);
+    }
+    Py_DECREF(words);
+    return dict;
+}
+
+Py_ssize_t Result_len(ResultObject* self) {
+    return static_cast<Py_ssize_t>(self->result->unique_words);
+}
+
+PyGetSetDef Result_getset[] = {
+    {"words", reinterpret_cast<getter>(Result_words), nullptr,
+     "Unique words, parallel to counts.", nullptr},
+    {"counts", reinterpret_cast<getter>(Result_counts), nullptr,
+     "Zero-copy memoryview of uint64 frequencies.", nullptr},
+    {"total_words", reinterpret_cast<getter>(Result_total_words), nullptr, nullptr, nullptr},
+    {"unique_words", reinterpret_cast<getter>(Result_unique_words), nullptr, nullptr, nullptr},
+    {"execution_time_ms", reinterpret_cast<getter>(Result_execution_time_ms), nullptr,
+     "Engine counting time, excluding Python-side conversion.", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyMethodDef Result_methods[] = {
+    {"to_dict", reinterpret_cast<PyCFunction>(Result_to_dict), METH_NOARGS,
+     "Return a {word: count} dict (copies)."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyBufferProcs Result_as_buffer = {reinterpret_cast<getbufferproc>(Result_getbuffer), nullptr};
+
+PySequenceMethods Result_as_sequence = {reinterpret_cast<lenfunc>(Result_len)};
+
+PyTypeObject ResultType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+// ---------------------------------------------------------------- Counter
+
+int parseSyncMethod(const char* name) {
+    if (name == nullptr || std::strcmp(name, "reduction") == 0) return PG_SYNC_REDUCTION;
+    if (std::strcmp(name, "atomic") == 0) return PG_SYNC_ATOMIC;
+    if (std::strcmp(name, "critical") == 0) return PG_SYNC_CRITICAL;
+    return -1;
+}
+
+PyObject* wrapResult(pg_result* result) {
+    if (result == nullptr) {
+        PyErr_SetString(PyExc_RuntimeError, pg_last_error());
+        return nullptr;
+    }
+    ResultObject* obj = PyObject_New(ResultObject, &ResultType);
+    if (obj == nullptr) {
+        pg_result_free(result);
+        return nullptr;
+    }
+    obj->result = result;
+    obj->wordsCache = nullptr;
+    obj->shape = 0;
+    return reinterpret_cast<PyObject*>(obj);
+}
+
+int Counter_init(CounterObject* self, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"sync", "threads", nullptr};
+    const char* sync = nullptr;
+    int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|si", const_cast<char**>(kwlist), &sync, &threads)) {
+        return -1;
+    }
+    int mode = parseSyncMethod(sync);
+    if (mode < 0) {
+        PyErr_Format(PyExc_ValueError, "unknown sync method '%s'", sync);
+        return -1;
+    }
+    pg_counter_destroy(self->counter);
+    self->counter = pg_counter_create(mode, threads);
+    if (self->counter == nullptr) {
+        PyErr_SetString(PyExc_RuntimeError, pg_last_error());
+        return -1;
+    }
+    return 0;
+}
+
+void Counter_dealloc(CounterObject* self) {
+    pg_counter_destroy(self->counter);
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+PyObject* Counter_count(CounterObject* self, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"text", "top_n", nullptr};
+    PyObject* text = nullptr;
+    int topN = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i", const_cast<char**>(kwlist), &text, &topN)) {
+        return nullptr;
+    }
+
+    pg_result* result = nullptr;
+    if (PyUnicode_Check(text)) {
+        Py_ssize_t len = 0;
+        const char* data = PyUnicode_AsUTF8AndSize(text, &len);
+        if (data == nullptr) {
+            return nullptr;
+        }
+        Py_BEGIN_ALLOW_THREADS
+        result = pg_count_text(self->counter, data, static_cast<size_t>(len), topN);
+        Py_END_ALLOW_THREADS
+    } else {
+        Py_buffer view;
+        if (PyObject_GetBuffer(text, &view, PyBUF_SIMPLE) < 0) {
+            return nullptr;
+        }
+        Py_BEGIN_ALLOW_THREADS
+        result = pg_count_text(self->counter, static_cast<const char*>(view.buf),
+                               static_cast<size_t>(view.len), topN);
+        Py_END_ALLOW_THREADS
+        PyBuffer_Release(&view);
+    }
+    return wrapResult(result);
+}
+
+PyObject* Counter_count_file(CounterObject* self, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"path", "top_n", nullptr};
+    PyObject* pathObj = nullptr;
+    int topN = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&|i", const_cast<char**>(kwlist),
+                                     PyUnicode_FSConverter, &pathObj, &topN)) {
+        return nullptr;
+    }
+    const char* path = PyBytes_AS_STRING(pathObj);
+
+    pg_result* result = nullptr;
+    Py_BEGIN_ALLOW_THREADS
+    result = pg_count_file(self->counter, path, topN);
+    Py_END_ALLOW_THREADS
+    Py_DECREF(pathObj);
+    return wrapResult(result);
+}
+
+PyObject* Counter_count_batch(CounterObject* self, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"texts", "top_n", "per_document", nullptr};
+    PyObject* textsObj = nullptr;
+    int topN = 0;
+    int perDocument = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ip", const_cast<char**>(kwlist),
+                                     &textsObj, &topN, &perDocument)) {
+        return nullptr;
+    }
+    // A tuple snapshot keeps every item alive while the GIL is released.
+    PyObject* texts = PySequence_Tuple(textsObj);
+    if (texts == nullptr) {
+        return nullptr;
+    }
+    Py_ssize_t n = PyTuple_GET_SIZE(texts);
+    std::vector<const char*> data(static_cast<size_t>(n));
+    std::vector<size_t> lengths(static_cast<size_t>(n));
+    std::vector<Py_buffer> views;
+    views.reserve(static_cast<size_t>(n));
+    auto releaseAll = [&]() {
+        for (auto& view : views) PyBuffer_Release(&view);
+        Py_DECREF(texts);
+    };
+
+    for (Py_ssize_t i = 0; i < n; ++i) {
+        PyObject* item = PyTuple_GET_ITEM(texts, i);
+        if (PyUnicode_Check(item)) {
+            Py_ssize_t len = 0;
+            data[i] = PyUnicode_AsUTF8AndSize(item, &len);
+            lengths[i] = static_cast<size_t>(len);
+            if (data[i] == nullptr) {
+                releaseAll();
+                return nullptr;
+            }
+        } else {
+            views.emplace_back();
+            if (PyObject_GetBuffer(item, &views.back(), PyBUF_SIMPLE) < 0) {
+                views.pop_back();
+                releaseAll();
+                return nullptr;
+            }
+            data[i] = static_cast<const char*>(views.back().buf);
+            lengths[i] = static_cast<size_t>(views.back().len);
+        }
+    }
+
+    std::vector<pg_result*> results(perDocument ? static_cast<size_t>(n) : 1, nullptr);
+    int status = 0;
+    Py_BEGIN_ALLOW_THREADS
+    status = pg_count_batch(self->counter, data.data(), lengths.data(), static_cast<size_t>(n),
+                            topN, perDocument, results.data());
+    Py_END_ALLOW_THREADS
+    releaseAll();
+    if (status != 0) {
+        PyErr_SetString(PyExc_RuntimeError, pg_last_error());
+        return nullptr;
+    }
+    if (!perDocument) {
+        return wrapResult(results[0]);
+    }
+
+    PyObject* list = PyList_New(n);
+    for (Py_ssize_t i = 0; i < n; ++i) {
+        PyObject* wrapped = list != nullptr ? wrapResult(results[i]) : nullptr;
+        if (wrapped == nullptr) {
+            // wrapResult freed results[i] on failure; free the rest here.
+            for (Py_ssize_t j = list != nullptr ? i + 1 : i; j < n; ++j) pg_result_free(results[j]);
+            Py_XDECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, i, wrapped);
+    }
+    return list;
+}
+
+PyObject* Counter_set_small_threshold(CounterObject* self, PyObject* args) {
+    Py_ssize_t bytes = 0;
+    if (!PyArg_ParseTuple(args, "n", &bytes)) {
+        return nullptr;
+    }
+    if (bytes < 0) {
+        PyErr_SetString(PyExc_ValueError, "threshold must be >= 0");
+        return nullptr;
+    }
+    if (pg_counter_set_small_threshold(self->counter, static_cast<size_t>(bytes)) != 0) {
+        PyErr_SetString(PyExc_RuntimeError, pg_last_error());
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+PyObject* Counter_calibrate(CounterObject* self, PyObject*) {
+    size_t threshold = 0;
+    int status = 0;
+    Py_BEGIN_ALLOW_THREADS
+    status = pg_counter_calibrate(self->counter, &threshold);
+    Py_END_ALLOW_THREADS
+    if (status != 0) {
+        PyErr_SetString(PyExc_RuntimeError, pg_last_error());
+        return nullptr;
+    }
+    return PyLong_FromSize_t(threshold);
+}
+
+PyMethodDef Counter_methods[] = {
+    {"count", reinterpret_cast<PyCFunction>(Counter_count), METH_VARARGS | METH_KEYWORDS,
+     "count(text, top_n=0) -> Result\n\ntext may be str or any bytes-like object."},
+    {"count_file", reinterpret_cast<PyCFunction>(Counter_count_file), METH_VARARGS | METH_KEYWORDS,
+     "count_file(path, top_n=0) -> Result"},
+    {"count_batch", reinterpret_cast<PyCFunction>(Counter_count_batch), METH_VARARGS | METH_KEYWORDS,
+     "count_batch(texts, top_n=0, per_document=True) -> list[Result] | Result\n\n"
+     "Counts a sequence of str/bytes-like texts in one call, parallel across texts.\n"
+     "per_document=False returns a single Result over all texts."},
+    {"set_small_threshold", reinterpret_cast<PyCFunction>(Counter_set_small_threshold), METH_VARARGS,
+     "set_small_threshold(bytes)\n\nTexts shorter than this are counted inline, without the thread team\n"
+     "(default 4096, capped at 16384; 0 disables)."},
+    {"calibrate", reinterpret_cast<PyCFunction>(Counter_calibrate), METH_NOARGS,
+     "calibrate() -> int\n\nMeasures the small-text threshold for this counter on this host, applies it\n"
+     "and returns it. Call once before the counts being timed."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyTypeObject CounterType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+PyModuleDef moduleDef = {PyModuleDef_HEAD_INIT, "parallel_grepper",
+                         "In-process bindings for the parallel word frequency counter.",
+                         -1, nullptr, nullptr, nullptr, nullptr, nullptr};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_parallel_grepper(void) {
+    ResultType.tp_name = "parallel_grepper.Result";
+    ResultType.tp_basicsize = sizeof(ResultObject);
+    ResultType.tp_flags = Py_TPFLAGS_DEFAULT;
+    ResultType.tp_doc = "Word counts owned by the engine.";
+    ResultType.tp_dealloc = reinterpret_cast<destructor>(Result_dealloc);
+    ResultType.tp_getset = Result_getset;
+    ResultType.tp_methods = Result_methods;
+    ResultType.tp_as_buffer = &Result_as_buffer;
+    ResultType.tp_as_sequence = &Result_as_sequence;
+
+    CounterType.tp_name = "parallel_grepper.Counter";
+    CounterType.tp_basicsize = sizeof(CounterObject);
+    CounterType.tp_flags = Py_TPFLAGS_DEFAULT;
+    CounterType.tp_doc = "Counter(sync='reduction', threads=0)";
+    CounterType.tp_new = PyType_GenericNew;
+    CounterType.tp_init = reinterpret_cast<initproc>(Counter_init);
+    CounterType.tp_dealloc = reinterpret_cast<destructor>(Counter_dealloc);
+    CounterType.tp_methods = Counter_methods;
+
+    if (PyType_Ready(&ResultType) < 0 || PyType_Ready(&CounterType) < 0) {
+        return nullptr;
+    }
+
+    PyObject* module = PyModule_Create(&moduleDef);
+    if (module == nullptr) {
+        return nullptr;
+    }
+    Py_INCREF(&CounterType);
+    if (PyModule_AddObject(module, "Counter", reinterpret_cast<PyObject*>(&CounterType)) < 0) {
+        Py_DECREF(&CounterType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
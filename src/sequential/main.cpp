@@ -1,22 +1,61 @@
 #include "word_counter_sequential.h"
+#include "trace_recorder.h"
+#include <charconv>
+#include <climits>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 /**
  * @brief Main driver program for sequential word counter
  * 
- * Usage: sequential_counter <input_file> [output_file] [top_n]
+ * Usage: sequential_counter <input_file> [output_file] [top_n] [--phases <file>] [--perf] [--trace <file>] [--memory]
+ *
+ * Options:
+ *   --phases <file>      Also write the phase timing as JSON to file
+ *   --perf               Read hardware counters per phase via perf_event_open
+ *   --trace <file>       Write the phases as a Chrome Trace Event JSON timeline
+ *   --memory             Report peak RSS, heap allocations and the word table's footprint
  */
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file> [output_file] [top_n]\n";
+    std::vector<std::string> positional;
+    std::string phasesFile;
+    std::string traceFile;
+    bool perf = false;
+    bool memory = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--phases" && i + 1 < argc) {
+            phasesFile = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (arg == "--perf") {
+            perf = true;
+        } else if (arg == "--memory") {
+            memory = true;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <input_file> [output_file] [top_n] [--phases <file>] [--perf] [--trace <file>] [--memory]\n";
         std::cerr << "Example: " << argv[0] << " data/test_10mb.txt results/output.txt 100\n";
         return 1;
     }
     
-    std::string inputFile = argv[1];
-    std::string outputFile = (argc > 2) ? argv[2] : "results/sequential/output.txt";
-    int topN = (argc > 3) ? std::stoi(argv[3]) : 100;
+    std::string inputFile = positional[0];
+    std::string outputFile = (positional.size() > 1) ? positional[1] : "results/sequential/output.txt";
+    int topN = 100;
+    if (positional.size() > 2) {
+        const std::string& s = positional[2];
+        auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), topN);
+        if (ec != std::errc() || ptr != s.data() + s.size() || topN < 0) {
+            std::cerr << "Error: top_n needs a non-negative integer, got '" << s << "'\n";
+            return 1;
+        }
+    }
     
     std::cout << "===========================================\n";
     std::cout << "  Sequential Word Frequency Counter\n";
@@ -28,6 +67,15 @@ int main(int argc, char* argv[]) {
     
     // Create word counter instance
     WordCounterSequential counter;
+    counter.getPhaseTimer().setCounters(perf);
+    if (memory) {
+        MemoryReport::startCounting();
+        counter.getMemoryReport().setEnabled(true);
+    }
+    if (!traceFile.empty()) {
+        TraceRecorder::start("sequential_counter");
+        TraceRecorder::nameThread("main");
+    }
     
     // Process file
     std::cout << "Processing file...\n";
@@ -64,6 +112,29 @@ int main(int argc, char* argv[]) {
     std::cout << "\nSaving results...\n";
     counter.saveResults(wordFreq, outputFile, topN);
     
+    counter.getPhaseTimer().print(std::cout, counter.getTotalWords());
+    if (!phasesFile.empty()) {
+        std::ofstream phases(phasesFile);
+        if (!phases.is_open()) {
+            std::cerr << "Error: Cannot create phase file " << phasesFile << std::endl;
+            return 1;
+        }
+        counter.getPhaseTimer().writeJson(phases, counter.getTotalWords());
+        std::cout << "Phase timing saved to: " << phasesFile << std::endl;
+    }
+    if (memory) {
+        std::error_code ec;
+        auto inputBytes = std::filesystem::file_size(inputFile, ec);
+        counter.getMemoryReport().print(std::cout, ec ? 0 : static_cast<size_t>(inputBytes), counter.getUniqueWords(),
+                                        "wordFreq");
+    }
+    if (!traceFile.empty()) {
+        if (!TraceRecorder::write(traceFile)) {
+            return 1;
+        }
+        std::cout << "Trace (" << TraceRecorder::spanCount() << " spans) saved to: " << traceFile << std::endl;
+    }
+    
     std::cout << "\nProcessing complete!\n";
     std::cout << "===========================================\n";
     
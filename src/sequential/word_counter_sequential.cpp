@@ -31,22 +31,30 @@ bool WordCounterSequential::isValidChar(char c) {
 WordCounterSequential::WordMap WordCounterSequential::countWords(const std::string& text) {
     auto startTime = std::chrono::high_resolution_clock::now();
     
+    phaseTimer.clear();
+    memoryReport.clear();
     WordMap wordFreq;
     std::istringstream stream(text);
     std::string word;
     totalWords = 0;
     
     // Process each word in the text
-    while (stream >> word) {
-        std::string normalized = normalizeWord(word);
-        
-        if (!normalized.empty()) {
-            wordFreq[normalized]++;
-            totalWords++;
+    {
+        PhaseTimer::Scope countPhase(phaseTimer, PhaseTimer::Count);
+        while (stream >> word) {
+            std::string normalized = normalizeWord(word);
+            
+            if (!normalized.empty()) {
+                wordFreq[normalized]++;
+                totalWords++;
+            }
         }
     }
     
     uniqueWords = wordFreq.size();
+    if (memoryReport.isEnabled()) {
+        memoryReport.addTable(PhaseTimer::Count, "wordFreq", wordFreq.size(), MemoryReport::bytesOf(wordFreq));
+    }
     
     auto endTime = std::chrono::high_resolution_clock::now();
     executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
@@ -64,22 +72,30 @@ WordCounterSequential::WordMap WordCounterSequential::countWordsFromFile(const s
         return WordMap();
     }
     
+    phaseTimer.clear();
+    memoryReport.clear();
     WordMap wordFreq;
     std::string word;
     totalWords = 0;
     
     // Read file word by word for memory efficiency
-    while (file >> word) {
-        std::string normalized = normalizeWord(word);
-        
-        if (!normalized.empty()) {
-            wordFreq[normalized]++;
-            totalWords++;
+    {
+        PhaseTimer::Scope countPhase(phaseTimer, PhaseTimer::Count);
+        while (file >> word) {
+            std::string normalized = normalizeWord(word);
+            
+            if (!normalized.empty()) {
+                wordFreq[normalized]++;
+                totalWords++;
+            }
         }
     }
     
     file.close();
     uniqueWords = wordFreq.size();
+    if (memoryReport.isEnabled()) {
+        memoryReport.addTable(PhaseTimer::Count, "wordFreq", wordFreq.size(), MemoryReport::bytesOf(wordFreq));
+    }
     
     auto endTime = std::chrono::high_resolution_clock::now();
     executionTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
@@ -89,6 +105,8 @@ WordCounterSequential::WordMap WordCounterSequential::countWordsFromFile(const s
 
 std::vector<std::pair<std::string, unsigned long long>> 
 WordCounterSequential::getTopWords(const WordMap& wordMap, int n) {
+    PhaseTimer::Scope topKPhase(phaseTimer, PhaseTimer::TopK);
+    
     // Convert map to vector for sorting
     std::vector<std::pair<std::string, unsigned long long>> wordVec(
         wordMap.begin(), wordMap.end()
@@ -130,6 +148,7 @@ void WordCounterSequential::saveResults(const WordMap& wordMap,
     // Get sorted words
     auto sortedWords = getTopWords(wordMap, topN);
     
+    PhaseTimer::Scope outputPhase(phaseTimer, PhaseTimer::Output);
     outFile << std::left << std::setw(30) << "Word" 
             << std::right << std::setw(15) << "Frequency" << "\n";
     outFile << std::string(45, '-') << "\n";
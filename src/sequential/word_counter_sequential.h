@@ -1,6 +1,9 @@
 #ifndef WORD_COUNTER_SEQUENTIAL_H
 #define WORD_COUNTER_SEQUENTIAL_H
 
+#include "memory_report.h"
+#include "phase_timer.h"
+
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -70,10 +73,28 @@ public:
      */
     size_t getUniqueWords() const { return uniqueWords; }
 
+    /**
+     * @brief Phase timing of the last count, plus the top-K and output
+     *        phases of later getTopWords/saveResults calls
+     *
+     * Reading, tokenizing and counting run word by word in one loop, so
+     * their time is reported under the count phase.
+     */
+    PhaseTimer& getPhaseTimer() { return phaseTimer; }
+    const PhaseTimer& getPhaseTimer() const { return phaseTimer; }
+
+    /**
+     * @brief Table footprint of the last count (its wordFreq) once enabled
+     */
+    MemoryReport& getMemoryReport() { return memoryReport; }
+    const MemoryReport& getMemoryReport() const { return memoryReport; }
+
 private:
     double executionTime;           // Last execution time in milliseconds
     unsigned long long totalWords;  // Total word count
     size_t uniqueWords;             // Unique word count
+    PhaseTimer phaseTimer;          // Per-phase wall/CPU time
+    MemoryReport memoryReport;      // Table footprints
     
     /**
      * @brief Normalize a word (lowercase, remove punctuation)